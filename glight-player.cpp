@@ -1,20 +1,44 @@
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "system/reader.h"
 #include "system/settings.h"
+#include "theatre/chasegroup.h"
 #include "theatre/management.h"
 
 namespace glight {
 
-void RunPlayer(const std::string filename) {
-  const glight::system::Settings settings = glight::system::LoadSettings();
+void RunPlayer(const std::string filename,
+               const std::vector<std::pair<size_t, double>>& power_limits,
+               std::optional<bool> output_dithering) {
+  glight::system::Settings settings = glight::system::LoadSettings();
+  if (output_dithering) settings.output_dithering = *output_dithering;
   glight::theatre::Management management(settings);
   glight::system::Read(filename, management);
+  for (const std::pair<size_t, double>& limit : power_limits) {
+    management.SetPowerLimit(limit.first, limit.second);
+  }
   management.GetUniverses().Open();
   management.Run();
-  std::cout << "Press enter to exit.\n";
-  std::cin.get();
+  std::cout << "Commands: 't' taps the tempo of all chase groups, 'r' "
+               "restarts them.\nPress enter on an empty line to exit.\n";
+  std::string command;
+  while (std::getline(std::cin, command) && !command.empty()) {
+    for (const std::unique_ptr<glight::theatre::ChaseGroup>& group :
+         management.ChaseGroups()) {
+      if (command == "t")
+        management.TapChaseGroup(*group);
+      else if (command == "r")
+        management.RestartChaseGroup(*group);
+    }
+    if (command != "t" && command != "r")
+      std::cout << "Unknown command: " << command << '\n';
+  }
   management.BlackOut(false, 0.0f);
   std::cout << "Stopping...\n";
   // There is some time required for the black out to take effect.
@@ -24,12 +48,47 @@ void RunPlayer(const std::string filename) {
 }  // namespace glight
 
 int main(int argc, char* argv[]) {
-  if (argc <= 1) {
-    std::cout << "Syntax: glight-player <show-file>\n\n"
+  std::vector<std::pair<size_t, double>> power_limits;
+  std::optional<bool> output_dithering;
+  int argi = 1;
+  while (argi < argc && argv[argi][0] == '-') {
+    const std::string option = argv[argi];
+    if (option == "-power-limit" && argi + 1 < argc) {
+      ++argi;
+      const std::string value = argv[argi];
+      const size_t colon = value.find(':');
+      if (colon == std::string::npos) {
+        std::cerr << "Invalid power limit: " << value << '\n';
+        return 1;
+      }
+      power_limits.emplace_back(std::atoi(value.substr(0, colon).c_str()),
+                                std::atof(value.substr(colon + 1).c_str()));
+    } else if (option == "-dither") {
+      output_dithering = true;
+    } else if (option == "-no-dither") {
+      output_dithering = false;
+    } else {
+      std::cerr << "Unknown option: " << option << '\n';
+      return 1;
+    }
+    ++argi;
+  }
+  if (argi >= argc) {
+    std::cout << "Syntax: glight-player [options] <show-file>\n\n"
                  "glight-player can play a previously created gshow file "
-                 "without requiring a graphical desktop.\n";
+                 "without requiring a graphical desktop.\n\n"
+                 "Options:\n"
+                 "-power-limit <phase>:<watts>\n"
+                 "  Dims the fixtures on the given electric phase when their "
+                 "estimated\n"
+                 "  power usage exceeds the given number of watts. Can be "
+                 "repeated.\n"
+                 "-dither, -no-dither\n"
+                 "  Enables or disables temporal dithering of 8-bit output "
+                 "channels,\n"
+                 "  overriding the setting in the configuration file.\n";
     return 0;
   }
 
-  glight::RunPlayer(argv[1]);
+  glight::RunPlayer(argv[argi], power_limits, output_dithering);
 }
@@ -1,15 +1,11 @@
 #include "powermonitor.h"
 
 #include <iomanip>
-#include <map>
 #include <sstream>
 
 #include <glibmm/main.h>
 
-#include "theatre/fixture.h"
-#include "theatre/fixturetype.h"
 #include "theatre/management.h"
-#include "theatre/theatre.h"
 
 #include "gui/eventtransmitter.h"
 #include "gui/instance.h"
@@ -34,17 +30,15 @@ void PowerMonitor::Start() {
 }
 
 void PowerMonitor::Update() {
-  const theatre::Management& management = Instance::Management();
-  snapshot_ = management.PrimarySnapshot();
+  phases_ = Instance::Management().PowerPerPhase();
   UpdateValues();
 }
 
 void PowerMonitor::TimeUpdate() {
-  const theatre::Management& management = Instance::Management();
-  glight::theatre::ValueSnapshot primary_snapshot =
-      management.PrimarySnapshot();
-  if (snapshot_ != primary_snapshot) {
-    snapshot_ = std::move(primary_snapshot);
+  std::vector<theatre::PhasePower> phases =
+      Instance::Management().PowerPerPhase();
+  if (phases_ != phases) {
+    phases_ = std::move(phases);
     UpdateValues();
   }
 }
@@ -63,24 +57,9 @@ void PowerMonitor::SetRow(size_t row_index, double used_power,
   rows_[row_index].label_.set_text(text.str());
 }
 
-std::map<size_t, std::pair<double, double>> GetPowerPerPhase(
-    const theatre::ValueSnapshot& snapshot) {
-  const theatre::Theatre& theatre = Instance::Management().GetTheatre();
-  std::map<size_t, std::pair<double, double>> phases;
-  for (const system::TrackablePtr<theatre::Fixture>& fixture :
-       theatre.Fixtures()) {
-    const double fixture_power = fixture->Mode().GetPower(*fixture, snapshot);
-    std::pair<double, double>& phase_power = phases[fixture->ElectricPhase()];
-    phase_power.first += fixture_power;
-    phase_power.second += fixture->Mode().Type().MaxPower();
-  }
-  if (phases.empty()) phases.emplace(0, std::make_pair(0.0, 0.0));
-  return phases;
-}
-
 void PowerMonitor::UpdateValues() {
-  const std::map<size_t, std::pair<double, double>> phases =
-      GetPowerPerPhase(snapshot_);
+  std::vector<theatre::PhasePower> phases = phases_;
+  if (phases.empty()) phases.emplace_back(theatre::PhasePower{0, 0.0, 0.0});
   const size_t n_rows = phases.size() > 1 ? phases.size() + 1 : 1;
   while (rows_.size() < n_rows) {
     Row& row = rows_.emplace_back();
@@ -98,16 +77,14 @@ void PowerMonitor::UpdateValues() {
 
   double total_usage = 0.0;
   double total_maximum = 0.0;
-  for (const auto& phase : phases) {
-    total_usage += phase.second.first;
-    total_maximum += phase.second.second;
+  for (const theatre::PhasePower& phase : phases) {
+    total_usage += phase.power;
+    total_maximum += phase.max_power;
   }
 
-  auto phase_iter = phases.begin();
   for (size_t phases_index = 0; phases_index != n_rows - 1; ++phases_index) {
-    SetRow(phases_index + 1, phase_iter->second.first,
-           phase_iter->second.second);
-    ++phase_iter;
+    SetRow(phases_index + 1, phases[phases_index].power,
+           phases[phases_index].max_power);
   }
   SetRow(0, total_usage, total_maximum);
 }
@@ -9,7 +9,7 @@
 #include <gtkmm/label.h>
 #include <gtkmm/progressbar.h>
 
-#include "theatre/valuesnapshot.h"
+#include "theatre/powerestimator.h"
 
 namespace glight::gui::components {
 
@@ -30,7 +30,7 @@ class PowerMonitor : public Gtk::Grid {
   sigc::scoped_connection timeout_connection_;
   sigc::scoped_connection update_connection_;
   std::vector<Row> rows_;
-  theatre::ValueSnapshot snapshot_;
+  std::vector<theatre::PhasePower> phases_;
 
  private:
   void UpdateValues();
@@ -56,6 +56,7 @@ MainWindow::MainWindow() : main_menu_(*this) {
   Instance::Settings() = system::LoadSettings();
   _management = std::make_unique<theatre::Management>(Instance::Settings());
   Instance::Get().SetManagement(*_management);
+  _management->SignalChange().connect([&]() { EmitUpdate(); });
   _management->StartBeatFinder();
   _management->GetUniverses().Open();
 
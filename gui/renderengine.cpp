@@ -49,25 +49,20 @@ struct DrawData {
   bool is_moving = false;
 };
 
-void DrawFixtureProjection(const DrawData &data,
-                           const theatre::Fixture &fixture) {
-  const theatre::FixtureMode &mode = fixture.Mode();
-  const theatre::FixtureType &type = mode.Type();
-  const size_t shape_count = type.ShapeCount();
-  for (size_t shape_index = 0; shape_index != shape_count; ++shape_index) {
-    const double tilt = fixture.GetBeamTilt(data.snapshot, shape_index);
-    const double direction =
-        fixture.GetBeamDirection(data.snapshot, shape_index);
-    const double beam_angle =
-        type.CanZoom() ? mode.GetZoom(fixture, data.snapshot, shape_index) * 0.5
-                       : type.MinBeamAngle() * 0.5;
+void DrawFixtureProjection(
+    const DrawData &data, const theatre::Fixture &fixture,
+    std::span<const theatre::ShapeVisualState> shapes) {
+  for (const theatre::ShapeVisualState &shape : shapes) {
+    const double tilt = shape.tilt;
+    const double direction = shape.direction;
+    const double beam_angle = shape.beam_angle * 0.5;
     const double x = fixture.GetPosition().X() + 0.5;
     const double y = fixture.GetPosition().Y() + 0.5;
     const double z = fixture.GetPosition().Z();
     const double sin_direction = std::sin(direction);
     const double cos_direction = std::cos(direction);
     if (beam_angle > 0.0 && beam_angle < M_PI) {
-      const theatre::Color c = fixture.GetColor(data.snapshot, shape_index);
+      const theatre::Color c = shape.color;
       if (c != theatre::Color::Black()) {
         const auto [r, g, b, max_rgb] = c.GetNormalizedRatios();
         data.cairo->set_source_rgba(r, g, b, 0.5 * max_rgb);
@@ -142,23 +137,18 @@ void DrawFixtureProjection(const DrawData &data,
   }
 }
 
-void DrawFixtureBeam(const DrawData &data, const theatre::Fixture &fixture) {
-  const theatre::FixtureMode &mode = fixture.Mode();
-  const theatre::FixtureType &type = mode.Type();
-  const size_t shape_count = type.ShapeCount();
-  for (size_t shape_index = 0; shape_index != shape_count; ++shape_index) {
-    const theatre::Color c = fixture.GetColor(data.snapshot, shape_index);
+void DrawFixtureBeam(const DrawData &data, const theatre::Fixture &fixture,
+                     std::span<const theatre::ShapeVisualState> shapes) {
+  const theatre::FixtureType &type = fixture.Mode().Type();
+  for (const theatre::ShapeVisualState &shape : shapes) {
+    const theatre::Color c = shape.color;
     if (c != theatre::Color::Black() && type.MinBeamAngle() > 0.0) {
-      const double direction =
-          fixture.GetBeamDirection(data.snapshot, shape_index);
+      const double direction = shape.direction;
       const double x = fixture.GetPosition().X() + 0.5;
       const double y = fixture.GetPosition().Y() + 0.5;
       const double z = fixture.GetPosition().Z();
-      const double beam_angle =
-          type.CanZoom()
-              ? mode.GetZoom(fixture, data.snapshot, shape_index) * 0.5
-              : type.MinBeamAngle() * 0.5;
-      const double tilt = fixture.GetBeamTilt(data.snapshot, shape_index);
+      const double beam_angle = shape.beam_angle * 0.5;
+      const double tilt = shape.tilt;
       const double cos_tilt = std::cos(tilt);
       const double sin_tilt = std::sin(tilt);
       const double sin_direction = std::sin(direction);
@@ -217,11 +207,12 @@ void DrawFixtureBeam(const DrawData &data, const theatre::Fixture &fixture) {
 }
 
 void DrawFixture(DrawData &data, const theatre::Fixture &fixture,
+                 std::span<const theatre::ShapeVisualState> shapes,
                  FixtureState &fixture_state) {
-  size_t shapeCount = fixture.Mode().Type().ShapeCount();
+  size_t shapeCount = shapes.size();
   for (size_t i = 0; i != shapeCount; ++i) {
     const size_t shapeIndex = shapeCount - i - 1;
-    const theatre::Color c = fixture.GetColor(data.snapshot, shapeIndex);
+    const theatre::Color c = shapes[shapeIndex].color;
 
     data.cairo->set_source_rgb(static_cast<double>(c.Red()) / 224.0 + 0.125,
                                static_cast<double>(c.Green()) / 224.0 + 0.125,
@@ -243,8 +234,7 @@ void DrawFixture(DrawData &data, const theatre::Fixture &fixture,
     // If a fixture is continuously rotating (e.g. a disco ball light), draw a
     // rotating cross.
 
-    const int rotation_speed =
-        fixture.GetRotationSpeed(data.snapshot, shapeIndex);
+    const int rotation_speed = shapes[shapeIndex].rotation_speed;
     if (rotation_speed != 0) {
       data.is_moving = true;
       const double displayed_rotation =
@@ -302,16 +292,18 @@ void RenderEngine::DrawSnapshot(
   }
 
   DrawData draw_data{cairo, management_, snapshot, style, scale_, false};
+  visual_states_.Decode(fixtures, snapshot);
 
   if (style.draw_projections) {
-    for (const system::TrackablePtr<theatre::Fixture> &fixture : fixtures) {
-      DrawFixtureProjection(draw_data, *fixture);
+    for (size_t i = 0; i != fixtures.size(); ++i) {
+      DrawFixtureProjection(draw_data, *fixtures[i],
+                            visual_states_.Shapes(i));
     }
   }
   if (style.draw_beams) {
-    for (const system::TrackablePtr<theatre::Fixture> &fixture : fixtures) {
-      if (fixture->IsVisible()) {
-        DrawFixtureBeam(draw_data, *fixture);
+    for (size_t i = 0; i != fixtures.size(); ++i) {
+      if (fixtures[i]->IsVisible()) {
+        DrawFixtureBeam(draw_data, *fixtures[i], visual_states_.Shapes(i));
       }
     }
   }
@@ -323,7 +315,8 @@ void RenderEngine::DrawSnapshot(
       const theatre::Fixture &fixture = *fixtures[fixtureIndex];
       if (fixture.IsVisible()) {
         FixtureState &fixture_state = state_[fixtureIndex];
-        DrawFixture(draw_data, fixture, fixture_state);
+        DrawFixture(draw_data, fixture, visual_states_.Shapes(fixtureIndex),
+                    fixture_state);
       }
     }
   }
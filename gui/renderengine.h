@@ -4,6 +4,7 @@
 #include "../theatre/coordinate2d.h"
 #include "../theatre/management.h"
 #include "../theatre/valuesnapshot.h"
+#include "../theatre/visualstate.h"
 
 #include "system/trackableptr.h"
 
@@ -67,6 +68,7 @@ class RenderEngine {
  private:
   const theatre::Management &management_;
   std::vector<FixtureState> state_;
+  theatre::VisualStateDecoder visual_states_;
   double scale_ = 1.0;
   double x_padding_ = 0.0;
   double y_padding_ = 0.0;
@@ -237,10 +237,11 @@ void AddFixtureWindow::onAdd() {
     for (size_t fixIter = 0; fixIter != static_cast<size_t>(count); ++fixIter) {
       const theatre::Coordinate3D position =
           management.GetTheatre().GetFreePosition();
+      const theatre::DmxChannel channel =
+          management.GetTheatre().FirstFreeChannel(
+              management.GetUniverses().FirstOutputUniverse(),
+              mode.ChannelCount());
       theatre::Fixture &fixture = *management.GetTheatre().AddFixture(mode);
-      theatre::DmxChannel channel(
-          fixture.GetFirstChannel().Channel(),
-          management.GetUniverses().FirstOutputUniverse());
       fixture.SetChannel(channel);
       fixture.GetPosition() = position;
 
@@ -4,6 +4,7 @@
 #include "gui/instance.h"
 
 #include "theatre/chase.h"
+#include "theatre/chasegroup.h"
 #include "theatre/folder.h"
 #include "theatre/functiontype.h"
 #include "theatre/management.h"
@@ -29,6 +30,13 @@ ChasePropertiesWindow::ChasePropertiesWindow(theatre::Chase &chase)
       _beatSpeedLabel("Beats per trigger :"),
       _beatSpeed(1.0),
 
+      _groupLabel("Chase group:"),
+      _newGroupButton("New group"),
+      _groupStepDuration("Group step duration:", 1000.0),
+      _tapButton("Tap"),
+      _restartGroupButton("Restart group"),
+      _removeGroupButton("Remove group"),
+
       _toTimeSequenceButton("Convert to time sequence"),
       _closeButton("Close"),
 
@@ -80,6 +88,31 @@ ChasePropertiesWindow::ChasePropertiesWindow(theatre::Chase &chase)
   _beatSpeed.SignalValueChanged().connect(
       sigc::mem_fun(*this, &ChasePropertiesWindow::onBeatSpeedChanged));
 
+  _beatSep.set_orientation(Gtk::Orientation::HORIZONTAL);
+  _grid.attach(_beatSep, 0, 7, 3, 1);
+
+  // A chase group gives chases a shared time base, whose tempo is set by
+  // the group instead of by the delay of the chase.
+  _groupLabel.set_halign(Gtk::Align::END);
+  _grid.attach(_groupLabel, 0, 8, 1, 1);
+  _groupCombo.signal_changed().connect([&]() { onGroupChanged(); });
+  _grid.attach(_groupCombo, 1, 8, 1, 1);
+  _newGroupButton.signal_clicked().connect([&]() { onNewGroupClicked(); });
+  _grid.attach(_newGroupButton, 2, 8, 1, 1);
+  _groupStepDuration.SignalValueChanged().connect(
+      sigc::mem_fun(*this, &ChasePropertiesWindow::onGroupStepDurationChanged));
+  _grid.attach(_groupStepDuration, 1, 9, 2, 1);
+  _tapButton.signal_clicked().connect([&]() { onTapClicked(); });
+  _groupButtonBox.append(_tapButton);
+  _restartGroupButton.signal_clicked().connect(
+      [&]() { onRestartGroupClicked(); });
+  _groupButtonBox.append(_restartGroupButton);
+  _removeGroupButton.signal_clicked().connect(
+      [&]() { onRemoveGroupClicked(); });
+  _groupButtonBox.append(_removeGroupButton);
+  _groupButtonBox.set_homogeneous(true);
+  _grid.attach(_groupButtonBox, 1, 10, 2, 1);
+
   _grid.set_hexpand(true);
   _box.append(_grid);
 
@@ -159,7 +192,68 @@ void ChasePropertiesWindow::onBeatSpeedChanged(double value) {
   _chase->GetTrigger().SetDelayInBeats(value);
 }
 
+theatre::ChaseGroup *ChasePropertiesWindow::getGroup() {
+  std::lock_guard<std::mutex> lock(Instance::Management().Mutex());
+  return _chase->GetGroup();
+}
+
+void ChasePropertiesWindow::onGroupChanged() {
+  if (!_recursionLock.IsFirst()) return;
+  Management &management = Instance::Management();
+  const int row = _groupCombo.get_active_row_number();
+  std::unique_lock<std::mutex> lock(management.Mutex());
+  // Row 0 is "None", the other rows are the groups in order
+  theatre::ChaseGroup *group = nullptr;
+  if (row > 0 && size_t(row) <= management.ChaseGroups().size())
+    group = management.ChaseGroups()[row - 1].get();
+  lock.unlock();
+  management.SetChaseGroup(*_chase, group);
+  loadChaseInfo(*_chase);
+}
+
+void ChasePropertiesWindow::onNewGroupClicked() {
+  Management &management = Instance::Management();
+  std::unique_lock<std::mutex> lock(management.Mutex());
+  theatre::ChaseGroup &group = management.AddChaseGroup();
+  // The group starts with the tempo of this chase
+  group.SetStepDuration(_chase->GetTrigger().DelayInMs() +
+                        _chase->GetTransition().LengthInMs());
+  lock.unlock();
+  management.SetChaseGroup(*_chase, &group);
+  loadChaseInfo(*_chase);
+}
+
+void ChasePropertiesWindow::onGroupStepDurationChanged(double value) {
+  if (!_recursionLock.IsFirst()) return;
+  theatre::ChaseGroup *group = getGroup();
+  if (group)
+    Instance::Management().SetChaseGroupStepDuration(*group, value);
+}
+
+void ChasePropertiesWindow::onTapClicked() {
+  theatre::ChaseGroup *group = getGroup();
+  if (group) {
+    Instance::Management().TapChaseGroup(*group);
+    loadChaseInfo(*_chase);
+  }
+}
+
+void ChasePropertiesWindow::onRestartGroupClicked() {
+  theatre::ChaseGroup *group = getGroup();
+  if (group) Instance::Management().RestartChaseGroup(*group);
+}
+
+void ChasePropertiesWindow::onRemoveGroupClicked() {
+  Management &management = Instance::Management();
+  std::unique_lock<std::mutex> lock(management.Mutex());
+  // All chases of the group continue on their own time base
+  if (_chase->GetGroup()) management.RemoveChaseGroup(*_chase->GetGroup());
+  lock.unlock();
+  loadChaseInfo(*_chase);
+}
+
 void ChasePropertiesWindow::loadChaseInfo(theatre::Chase &chase) {
+  RecursionLock::Token token(_recursionLock);
   std::unique_lock<std::mutex> lock(Instance::Management().Mutex());
   theatre::TriggerType triggerType = chase.GetTrigger().Type();
   theatre::TransitionType transitionType = chase.GetTransition().Type();
@@ -167,7 +261,26 @@ void ChasePropertiesWindow::loadChaseInfo(theatre::Chase &chase) {
   double transitionSpeed = chase.GetTransition().LengthInMs();
   double beatSpeed = chase.GetTrigger().DelayInBeats();
   double syncSpeed = chase.GetTrigger().DelayInSyncs();
+  const std::vector<std::unique_ptr<theatre::ChaseGroup>> &groups =
+      Instance::Management().ChaseGroups();
+  const size_t n_groups = groups.size();
+  size_t group_row = 0;
+  for (size_t i = 0; i != n_groups; ++i) {
+    if (groups[i].get() == chase.GetGroup()) group_row = i + 1;
+  }
+  const double group_step_duration =
+      chase.GetGroup() ? chase.GetGroup()->StepDuration() : 0.0;
   lock.unlock();
+  _groupCombo.remove_all();
+  _groupCombo.append("None");
+  for (size_t i = 0; i != n_groups; ++i)
+    _groupCombo.append("Group " + std::to_string(i + 1));
+  _groupCombo.set_active(group_row);
+  _groupStepDuration.SetValue(group_step_duration);
+  _groupStepDuration.set_sensitive(group_row != 0);
+  _tapButton.set_sensitive(group_row != 0);
+  _restartGroupButton.set_sensitive(group_row != 0);
+  _removeGroupButton.set_sensitive(group_row != 0);
   _triggerDuration.SetValue(triggerSpeed);
   _transitionDuration.SetValue(transitionSpeed);
   _beatSpeed.SetValue(beatSpeed);
@@ -6,6 +6,7 @@
 #include <gtkmm/box.h>
 #include <gtkmm/button.h>
 #include <gtkmm/checkbutton.h>
+#include <gtkmm/comboboxtext.h>
 #include <gtkmm/frame.h>
 #include <gtkmm/grid.h>
 #include <gtkmm/label.h>
@@ -19,6 +20,7 @@
 #include "gui/components/beatinput.h"
 #include "gui/components/durationinput.h"
 #include "gui/components/transitiontypebox.h"
+#include "gui/recursionlock.h"
 
 namespace glight::gui {
 
@@ -38,6 +40,13 @@ class ChasePropertiesWindow : public PropertiesWindow {
   void onTransitionTypeChanged(theatre::TransitionType type);
   void onSyncCountChanged();
   void onBeatSpeedChanged(double value);
+  void onGroupChanged();
+  void onNewGroupClicked();
+  void onGroupStepDurationChanged(double value);
+  void onTapClicked();
+  void onRestartGroupClicked();
+  void onRemoveGroupClicked();
+  theatre::ChaseGroup *getGroup();
 
   void onUpdateControllables();
   void onToTimeSequenceClicked();
@@ -59,6 +68,15 @@ class ChasePropertiesWindow : public PropertiesWindow {
   Gtk::CheckButton _beatTriggerCheckButton;
   Gtk::Label _beatSpeedLabel;
   BeatInput _beatSpeed;
+  Gtk::Separator _beatSep;
+
+  Gtk::Label _groupLabel;
+  Gtk::ComboBoxText _groupCombo;
+  Gtk::Button _newGroupButton;
+  DurationInput _groupStepDuration;
+  Gtk::Box _groupButtonBox;
+  Gtk::Button _tapButton, _restartGroupButton, _removeGroupButton;
+  RecursionLock _recursionLock;
 
   Gtk::Box _buttonBox;
   Gtk::Button _toTimeSequenceButton, _closeButton;
@@ -20,6 +20,7 @@
 #include "theatre/folder.h"
 #include "theatre/folderoperations.h"
 #include "theatre/management.h"
+#include "theatre/managementbatch.h"
 #include "theatre/theatre.h"
 #include "theatre/timesequence.h"
 
@@ -302,7 +303,6 @@ theatre::DesignInfo DesignWizard::GetDesign() const {
 
 void DesignWizard::onNextClicked() {
   theatre::Management &management = Instance::Management();
-  gui::EventTransmitter &events = Instance::Events();
   _mainBox.remove(_buttonBox);
   switch (_currentPage) {
     case Page1_SelFixtures: {
@@ -413,21 +413,19 @@ void DesignWizard::onNextClicked() {
         runType = RunType::OutwardRun;
       else  // if(_randomRunRB.get_active())
         runType = RunType::RandomRun;
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       theatre::Chase &chase = AutoDesign::MakeRunningLight(
           GetDesign(), _colorsWidgetP4.GetSelection(), runType);
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(chase);
       hide();
     } break;
 
     case Page4_2_SingleColor: {
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       theatre::Chase &chase = AutoDesign::MakeColorVariation(
           GetDesign(), _colorsWidgetP4.GetSelection(), _variation.get_value());
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(chase);
       hide();
     } break;
@@ -443,11 +441,10 @@ void DesignWizard::onNextClicked() {
         shiftType = ShiftType::BackAndForthShift;
       else
         shiftType = ShiftType::RandomShift;
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       theatre::Chase &chase = AutoDesign::MakeColorShift(
           GetDesign(), _colorsWidgetP4.GetSelection(), shiftType);
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(chase);
       hide();
     } break;
@@ -463,26 +460,23 @@ void DesignWizard::onNextClicked() {
         direction = VUMeterDirection::VUInward;
       else  // if(_vuOutwardRunRB.get_active())
         direction = VUMeterDirection::VUOutward;
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       glight::theatre::Controllable &vu_meter = AutoDesign::MakeVUMeter(
           GetDesign(), _colorsWidgetP4.GetSelection(), direction);
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(vu_meter);
       hide();
     } break;
 
     case Page4_5_ColorPreset: {
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       if (_eachFixtureSeparatelyCB.get_active()) {
         MakeColorPresetPerFixture(GetDesign(), _colorsWidgetP4.GetSelection());
-        lock.unlock();
-        events.EmitUpdate();
+        batch.Commit();
       } else {
         glight::theatre::PresetCollection &preset =
             MakeColorPreset(GetDesign(), _colorsWidgetP4.GetSelection());
-        lock.unlock();
-        events.EmitUpdate();
+        batch.Commit();
         AssignFader(preset);
       }
       hide();
@@ -499,11 +493,10 @@ void DesignWizard::onNextClicked() {
         incType = IncreasingType::IncForwardReturn;
       else  // if(_incBackwardReturnRB.get_active())
         incType = IncreasingType::IncBackwardReturn;
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       glight::theatre::Chase &chase = AutoDesign::MakeIncreasingChase(
           GetDesign(), _colorsWidgetP4.GetSelection(), incType);
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(chase);
       hide();
     } break;
@@ -517,22 +510,20 @@ void DesignWizard::onNextClicked() {
         type = RotationType::Backward;
       else  // if (_rotForwardReturnRB.get_active())
         type = RotationType::ForwardBackward;
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       glight::theatre::TimeSequence &rotation =
           MakeRotation(GetDesign(), _colorsWidgetP4.GetSelection(), type);
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(rotation);
       hide();
     } break;
 
     case Page4_8_Fire: {
       using theatre::RotationType;
-      std::unique_lock lock(management.Mutex());
+      theatre::ManagementBatch batch(management);
       theatre::Effect &fire =
           AutoDesign::MakeFire(GetDesign(), _colorsWidgetP4.GetSelection());
-      lock.unlock();
-      events.EmitUpdate();
+      batch.Commit();
       AssignFader(fire);
       hide();
     } break;
@@ -146,8 +146,12 @@ void EffectPropertiesWindow::onRemoveConnectionClicked() {
   Glib::RefPtr<Gtk::TreeSelection> selection =
       _connectionsListView.get_selection();
   Gtk::TreeModel::iterator selected = selection->get_selected();
-  if (selected)
+  if (selected) {
+    // The effect resizes its state when a connection is removed, which
+    // must not happen while it is being mixed
+    std::lock_guard<std::mutex> lock(Instance::Management().Mutex());
     _effect->RemoveConnection((*selected)[_connectionsListColumns._index]);
+  }
   fillConnectionsList();
 }
 
@@ -83,6 +83,7 @@ void FixtureProperties::onSetClicked() {
     fixture->SetUpsideDown(upside_down);
     fixture->SetElectricPhase(std::atoi(phase_entry_.get_text().c_str()));
   }
+  Instance::Management().NotifyPowerChange();
   lock.unlock();
   Instance::Events().EmitUpdate();
 }
@@ -125,6 +125,22 @@ FixtureTypeFunctionsFrame::FixtureTypeFunctionsFrame(Gtk::Window& parent_window)
     }
   });
 
+  grid_.attach(pixel_count_label_, 0, 6);
+  grid_.attach(pixel_count_entry_, 1, 6, 2, 1);
+  pixel_count_entry_.signal_changed().connect([&]() {
+    Gtk::TreeModel::iterator selected =
+        functions_view_.get_selection()->get_selected();
+    if (selected) {
+      FixtureModeFunction& function =
+          *(*selected)[functions_columns_.function_];
+      if (function.Type() == FunctionType::PixelBlock) {
+        const unsigned val =
+            std::max(1LL, std::atoll(pixel_count_entry_.get_text().c_str()));
+        function.GetPixelBlockParameters().SetPixelCount(val);
+      }
+    }
+  });
+
   set_child(grid_);
 
   onSelectionChanged();
@@ -215,11 +231,19 @@ void FixtureTypeFunctionsFrame::onSelectionChanged() {
     const int ft_index = static_cast<int>(function.Type());
     function_type_combo_.set_active(ft_index);
     power_entry_.set_text(std::to_string(function.Power()));
+    const bool is_block = function.Type() == FunctionType::PixelBlock;
+    pixel_count_label_.set_sensitive(is_block);
+    pixel_count_entry_.set_sensitive(is_block);
+    pixel_count_entry_.set_text(
+        is_block ? std::to_string(function.PixelCount()) : "-");
   } else {
     dmx_offset_entry_.set_text("");
     fine_channel_entry_.set_text("-");
     function_type_combo_.set_active(-1);
     power_entry_.set_text("-");
+    pixel_count_label_.set_sensitive(false);
+    pixel_count_entry_.set_sensitive(false);
+    pixel_count_entry_.set_text("-");
   }
 }
 
@@ -68,6 +68,8 @@ class FixtureTypeFunctionsFrame : public Gtk::Frame {
 
   Gtk::Label power_label_{"Power:"};
   Gtk::Entry power_entry_;
+  Gtk::Label pixel_count_label_{"Pixels:"};
+  Gtk::Entry pixel_count_entry_;
 
   struct FunctionTypeColumns : public Gtk::TreeModelColumnRecord {
     FunctionTypeColumns() {
@@ -236,6 +236,7 @@ void FixtureTypesWindow::onSaveClicked() {
     const unsigned idle_power =
         std::max(0LL, std::atoll(idle_power_entry_.get_text().c_str()));
     type->SetIdlePower(idle_power);
+    Instance::Management().NotifyPowerChange();
     type->SetFixtureClass(
         theatre::GetFixtureClass(class_combo_.get_active_text().data()));
     Instance::Events().EmitUpdate();
@@ -80,6 +80,13 @@ void SettingsWindow::MakeDmxPage() {
   dmx_output_rb_.set_group(dmx_none_rb_);
   dmx_output_rb_.signal_toggled().connect(save_universe);
   dmx_page_.attach(dmx_output_rb_, 0, 6, 2, 1);
+
+  dmx_dithering_cb_.set_active(Instance::Settings().output_dithering);
+  dmx_dithering_cb_.set_tooltip_text(
+      "Smooths slow fades on 8-bit channels by alternating between the two "
+      "nearest DMX values.");
+  dmx_dithering_cb_.signal_toggled().connect([&]() { SetOutputDithering(); });
+  dmx_page_.attach(dmx_dithering_cb_, 0, 7, 2, 1);
   notebook_.append_page(dmx_page_, "DMX");
 }
 
@@ -326,6 +333,12 @@ void SettingsWindow::ReloadOla() {
   UpdateAfterSelection();
 }
 
+void SettingsWindow::SetOutputDithering() {
+  const bool enabled = dmx_dithering_cb_.get_active();
+  Instance::Settings().output_dithering = enabled;
+  Instance::Management().SetOutputDithering(enabled);
+}
+
 void SettingsWindow::SetInputAudio() {
   const std::string& selected_device =
       input_devices_[input_devices_combo_.get_active_row_number()];
@@ -30,6 +30,7 @@ class SettingsWindow : public ChildWindow {
   void SaveSelectedOlaUniverse();
   void ReloadOla();
 
+  void SetOutputDithering();
   void SetInputAudio();
   void SetOutputAudio();
 
@@ -65,6 +66,7 @@ class SettingsWindow : public ChildWindow {
   Gtk::Box dmx_input_function_box_{Gtk::Orientation::VERTICAL};
 
   Gtk::CheckButton dmx_output_rb_{"Output"};
+  Gtk::CheckButton dmx_dithering_cb_{"Dither 8-bit output"};
 
   Gtk::Box midi_page_{Gtk::Orientation::VERTICAL};
 
@@ -0,0 +1,102 @@
+#include "colormap.h"
+
+#include <climits>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <utility>
+
+namespace glight::system {
+
+ColorMap::ColorMap(const std::vector<theatre::Color>& palette, int divisor)
+    : divisor_(divisor) {
+  assert(divisor > 1);
+  const int limit = 1 + 256 / divisor;
+  map_.assign(limit * limit * limit, 0);
+  if (palette.empty()) return;
+
+  std::vector<size_t> by_blue(palette.size());
+  std::iota(by_blue.begin(), by_blue.end(), 0);
+  std::stable_sort(by_blue.begin(), by_blue.end(), [&](size_t a, size_t b) {
+    return palette[a].Blue() < palette[b].Blue();
+  });
+  // Distance of the red and green components to the current row
+  std::vector<int> partial(palette.size());
+  // Best candidates for every blue value from the forward sweep
+  std::vector<std::pair<int, size_t>> forward(limit);
+  for (int red = 0; red != limit; ++red) {
+    for (int green = 0; green != limit; ++green) {
+      for (size_t i = 0; i != palette.size(); ++i) {
+        partial[i] = std::abs(int(palette[i].Red()) - red * divisor) +
+                     std::abs(int(palette[i].Green()) - green * divisor);
+      }
+      unsigned short* row = &map_[(red * limit + green) * limit];
+
+      // Palette colours with a blue value <= x are at distance
+      // partial - blue + x.
+      int best = INT_MAX;
+      size_t best_index = 0;
+      auto entry = by_blue.begin();
+      for (int blue = 0; blue != limit; ++blue) {
+        const int x = blue * divisor;
+        for (; entry != by_blue.end() && palette[*entry].Blue() <= x;
+             ++entry) {
+          const int key = partial[*entry] - palette[*entry].Blue();
+          if (key < best || (key == best && *entry > best_index)) {
+            best = key;
+            best_index = *entry;
+          }
+        }
+        forward[blue] = {best == INT_MAX ? INT_MAX : best + x, best_index};
+      }
+
+      // Palette colours with a blue value >= x are at distance
+      // partial + blue - x.
+      best = INT_MAX;
+      best_index = 0;
+      auto reverse_entry = by_blue.rbegin();
+      for (int blue = limit - 1; blue >= 0; --blue) {
+        const int x = blue * divisor;
+        for (; reverse_entry != by_blue.rend() &&
+               palette[*reverse_entry].Blue() >= x;
+             ++reverse_entry) {
+          const size_t index = *reverse_entry;
+          const int key = partial[index] + palette[index].Blue();
+          if (key < best || (key == best && index > best_index)) {
+            best = key;
+            best_index = index;
+          }
+        }
+        const int distance = best == INT_MAX ? INT_MAX : best - x;
+        if (distance < forward[blue].first ||
+            (distance == forward[blue].first &&
+             best_index > forward[blue].second))
+          row[blue] = best_index;
+        else
+          row[blue] = forward[blue].second;
+      }
+    }
+  }
+}
+
+std::shared_ptr<const ColorMap> ColorMap::GetShared(
+    const std::vector<theatre::Color>& palette, int divisor) {
+  using Key = std::pair<int, std::vector<theatre::Color>>;
+  static std::mutex mutex;
+  static std::map<Key, std::weak_ptr<const ColorMap>> cache;
+
+  std::lock_guard lock(mutex);
+  std::weak_ptr<const ColorMap>& entry = cache[Key(divisor, palette)];
+  std::shared_ptr<const ColorMap> map = entry.lock();
+  if (!map) {
+    map = std::make_shared<const ColorMap>(palette, divisor);
+    entry = map;
+    // Remove maps that are no longer used
+    std::erase_if(cache,
+                  [](const auto& item) { return item.second.expired(); });
+  }
+  return map;
+}
+
+}  // namespace glight::system
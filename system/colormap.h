@@ -1,11 +1,11 @@
 #ifndef GLIGHT_SYSTEM_COLOR_MAP_H_
 #define GLIGHT_SYSTEM_COLOR_MAP_H_
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <vector>
 
-#include <iostream>
-
 #include "theatre/color.h"
 
 namespace glight::system {
@@ -13,43 +13,48 @@ namespace glight::system {
 class ColorMap {
  public:
   ColorMap() = default;
-  ColorMap(const std::vector<theatre::Color>& palette, int divisor)
-      : divisor_(divisor) {
-    assert(divisor > 1);
-    const int limit = 1 + 256 / divisor;
-    for (int red = 0; red != limit; ++red) {
-      for (int green = 0; green != limit; ++green) {
-        for (int blue = 0; blue != limit; ++blue) {
-          // find closest color
-          size_t closest = 0;
-          unsigned closest_distance = 1024;
-          for (size_t i = 0; i != palette.size(); ++i) {
-            const unsigned d =
-                std::abs(int(palette[i].Red()) - red * divisor) +
-                std::abs(int(palette[i].Green()) - green * divisor) +
-                std::abs(int(palette[i].Blue()) - blue * divisor);
-            if (d <= closest_distance) {
-              closest = i;
-              closest_distance = d;
-            }
-          }
-          map_.emplace_back(closest);
-        }
-      }
-    }
-  }
+
+  /**
+   * Maps every quantized colour to the closest colour in the palette, using
+   * the Manhattan distance. When several palette colours are equally close,
+   * the one that comes last in the palette is used. The map is built one
+   * row of blue values at a time: because the distance is a sum of
+   * per-component distances, the closest palette colour for all blue values
+   * of a row is found with two sweeps over the palette sorted by blue,
+   * instead of comparing every cell with the whole palette.
+   */
+  ColorMap(const std::vector<theatre::Color>& palette, int divisor);
+
+  /**
+   * Returns a map for the palette that is shared with all other users of
+   * the same palette and divisor. Maps are kept as long as they are in use.
+   * This function is thread safe.
+   */
+  static std::shared_ptr<const ColorMap> GetShared(
+      const std::vector<theatre::Color>& palette, int divisor);
 
   unsigned short GetIndex(const theatre::Color& color) const {
+    return map_[GetPosition(color.Red(), color.Green(), color.Blue())];
+  }
+
+  /**
+   * Position of the quantized colour in the map. Tables of size
+   * @ref Size() that are indexed by this position can be used to map a
+   * colour directly to a value derived from its palette index.
+   */
+  size_t GetPosition(unsigned char red, unsigned char green,
+                     unsigned char blue) const {
     const int limit = 1 + 256 / divisor_;
     const int start = divisor_ / 2 - 1;
-    const size_t unbounded_index =
-        ((color.Red() + start) / divisor_) * limit * limit +
-        ((color.Green() + start) / divisor_) * limit +
-        (color.Blue() + start) / divisor_;
-    const size_t index = std::min<size_t>(unbounded_index, map_.size());
-    return map_[index];
+    const size_t unbounded_index = ((red + start) / divisor_) * limit * limit +
+                                   ((green + start) / divisor_) * limit +
+                                   (blue + start) / divisor_;
+    return std::min<size_t>(unbounded_index, map_.size() - 1);
   }
 
+  size_t Size() const { return map_.size(); }
+  unsigned short GetIndexAt(size_t position) const { return map_[position]; }
+
  private:
   int divisor_ = 0;
   // Maps a color to the palette index.
@@ -4,6 +4,7 @@
 #include "timepattern.h"
 
 #include "theatre/chase.h"
+#include "theatre/chasegroup.h"
 #include "theatre/controllable.h"
 #include "theatre/effect.h"
 #include "theatre/fixture.h"
@@ -14,6 +15,7 @@
 #include "theatre/fixturetype.h"
 #include "theatre/folder.h"
 #include "theatre/management.h"
+#include "theatre/managementbatch.h"
 #include "theatre/presetvalue.h"
 #include "theatre/theatre.h"
 #include "theatre/timesequence.h"
@@ -117,6 +119,32 @@ void ParseRotationParameters(const json::Object &node,
   }
 }
 
+void ParsePixelBlockParameters(const json::Object &node,
+                               PixelBlockParameters &parameters) {
+  parameters.SetPixelCount(ToNum(node["pixel-count"]).AsUInt());
+}
+
+ResponseCurve ParseResponseCurve(const json::Object &node) {
+  switch (GetCurveType(ToStr(node["type"]))) {
+    case CurveType::Gamma:
+      return ResponseCurve::Gamma(ToNum(node["gamma"]).AsDouble());
+    case CurveType::SCurve:
+      return ResponseCurve::SCurve();
+    case CurveType::Custom: {
+      std::vector<std::pair<double, double>> points;
+      for (const json::Node &item : ToArr(node["points"])) {
+        const json::Object &point = ToObj(item);
+        points.emplace_back(ToNum(point["input"]).AsDouble(),
+                            ToNum(point["output"]).AsDouble());
+      }
+      return ResponseCurve::Custom(std::move(points));
+    }
+    case CurveType::Linear:
+      break;
+  }
+  return ResponseCurve();
+}
+
 void ParseFixtureModeFunctions(const json::Array &node,
                                FixtureMode &fixture_mode) {
   std::vector<FixtureModeFunction> functions;
@@ -132,6 +160,8 @@ void ParseFixtureModeFunctions(const json::Array &node,
     FixtureModeFunction &new_function =
         functions.emplace_back(ft, dmx_offset, fine_channel, shape);
     new_function.SetPower(OptionalUInt(obj, "power", 0));
+    if (obj.contains("curve"))
+      new_function.SetCurve(ParseResponseCurve(ToObj(obj["curve"])));
     switch (ft) {
       case FunctionType::ColorMacro:
       case FunctionType::ColorWheel:
@@ -142,6 +172,10 @@ void ParseFixtureModeFunctions(const json::Array &node,
         ParseRotationParameters(ToObj(obj["parameters"]),
                                 new_function.GetRotationParameters());
         break;
+      case FunctionType::PixelBlock:
+        ParsePixelBlockParameters(ToObj(obj["parameters"]),
+                                  new_function.GetPixelBlockParameters());
+        break;
       default:
         break;
     }
@@ -249,6 +283,11 @@ void ParseFixtures(const json::Array &node, Theatre &theatre) {
           std::to_string(fixture.Mode().Functions().size()) +
           " functions according to its type");
     }
+    for (size_t i = 0; i != fixture.Functions().size(); ++i) {
+      fixture.Functions()[i]->SetPixelCount(
+          fixture.Mode().Functions()[i].PixelCount());
+    }
+    theatre.NotifyDmxChange(fixture);
   }
 }
 
@@ -268,6 +307,14 @@ void ParseFixtureGroups(const json::Array &node, Management &management) {
   }
 }
 
+void ParseChaseGroups(const json::Array &node, Management &management) {
+  for (const Node &child : node) {
+    const Object &group_node = ToObj(child);
+    ChaseGroup &group = management.AddChaseGroup();
+    group.SetStepDuration(ToNum(group_node["step-duration"]).AsDouble());
+  }
+}
+
 void ParseTheatre(const Object &node, Management &management) {
   Theatre &theatre = management.GetTheatre();
   theatre.SetWidth(OptionalDouble(node, "width", 10.0));
@@ -354,6 +401,10 @@ void ParseChase(const Object &node, Management &management) {
   ParseTrigger(ToObj(node["trigger"]), chase.GetTrigger());
   chase.GetTransition() = ParseTransition(ToObj(node["transition"]));
   ParseSequence(ToObj(node["sequence"]), chase.GetSequence(), management);
+  if (node.contains("group")) {
+    const size_t group = ToNum(node["group"]).AsSize();
+    chase.SetGroup(management.ChaseGroups().at(group).get());
+  }
 }
 
 void ParseTimeSequence(const Object &node, Management &management) {
@@ -630,9 +681,14 @@ void ParseGui(const Object &node, uistate::UIState &uiState,
 
 void parseGlightShow(const Object &node, Management &management,
                      uistate::UIState *uiState) {
+  // The caller is responsible for locking and for notifying about the change
+  ManagementBatch batch(management, std::defer_lock);
   ParseFolders(ToArr(node["folders"]), management);
   ParseTheatre(ToObj(node["theatre"]), management);
   ParseFixtureGroups(ToArr(node["fixture-groups"]), management);
+  // Chase groups were added later, so they are optional
+  if (node.contains("chase-groups"))
+    ParseChaseGroups(ToArr(node["chase-groups"]), management);
   ParseControls(ToArr(node["controls"]), management);
   ParseSourceValues(ToArr(node["source-values"]), management);
   if (uiState != nullptr) {
@@ -14,6 +14,7 @@ namespace glight::system {
 using json::AssignOptionalString;
 using json::Node;
 using json::Object;
+using json::OptionalBool;
 using json::ToObj;
 
 namespace {
@@ -58,6 +59,9 @@ void Save(const Settings& settings) {
   writer.String("input", settings.audio_input);
   writer.String("output", settings.audio_output);
   writer.EndObject();  // audio
+  writer.StartObject("dmx");
+  writer.Boolean("dithering", settings.output_dithering);
+  writer.EndObject();  // dmx
   writer.EndObject();  // system
   writer.EndObject();  // main
 }
@@ -67,10 +71,18 @@ void ParseAudio(Settings& settings, const Object& audio) {
   AssignOptionalString(settings.audio_output, audio, "output");
 }
 
+void ParseDmx(Settings& settings, const Object& dmx) {
+  settings.output_dithering =
+      OptionalBool(dmx, "dithering", settings.output_dithering);
+}
+
 void ParseSystem(Settings& settings, const Object& system) {
   if (system.contains("audio")) {
     ParseAudio(settings, ToObj(system["audio"]));
   }
+  if (system.contains("dmx")) {
+    ParseDmx(settings, ToObj(system["dmx"]));
+  }
 }
 
 Settings LoadSettings() {
@@ -9,6 +9,8 @@ namespace glight::system {
 struct Settings {
   std::string audio_input = "default";
   std::string audio_output = "default";
+  /** Temporal dithering of 8-bit DMX output, see theatre::OutputDither. */
+  bool output_dithering = false;
 };
 
 Settings LoadSettings();
@@ -5,6 +5,7 @@
 #include "writer.h"
 
 #include "theatre/chase.h"
+#include "theatre/chasegroup.h"
 #include "theatre/controllable.h"
 #include "theatre/effect.h"
 #include "theatre/fixture.h"
@@ -41,6 +42,7 @@ struct WriteState {
   json::JsonWriter writer;
   std::set<const Controllable *> controllablesWritten;
   std::map<const Folder *, size_t> folderIds;
+  std::map<const ChaseGroup *, size_t> chaseGroupIds;
   Management &management;
   uistate::UIState *uiState = nullptr;
 };
@@ -191,6 +193,37 @@ void writeRotationParameters(WriteState &state,
   state.writer.EndObject();  // parameters
 }
 
+void writePixelBlockParameters(WriteState &state,
+                               const PixelBlockParameters &pars) {
+  state.writer.StartObject("parameters");
+  state.writer.Number("pixel-count", pars.PixelCount());
+  state.writer.EndObject();  // parameters
+}
+
+void writeResponseCurve(WriteState &state, const ResponseCurve &curve) {
+  state.writer.StartObject("curve");
+  state.writer.String("type", ToString(curve.Type()));
+  switch (curve.Type()) {
+    case CurveType::Gamma:
+      state.writer.Number("gamma", curve.GammaValue());
+      break;
+    case CurveType::Custom:
+      state.writer.StartArray("points");
+      for (const std::pair<double, double> &point : curve.Points()) {
+        state.writer.StartObject();
+        state.writer.Number("input", point.first);
+        state.writer.Number("output", point.second);
+        state.writer.EndObject();
+      }
+      state.writer.EndArray();
+      break;
+    case CurveType::Linear:
+    case CurveType::SCurve:
+      break;
+  }
+  state.writer.EndObject();  // curve
+}
+
 void writeFixtureTypeFunction(WriteState &state,
                               const FixtureModeFunction &function) {
   state.writer.StartObject();
@@ -200,6 +233,7 @@ void writeFixtureTypeFunction(WriteState &state,
     state.writer.Number("fine-channel-offset", *function.FineChannelOffset());
   state.writer.Number("shape", function.Shape());
   if (function.Power() != 0.0) state.writer.Number("power", function.Power());
+  if (!function.Curve().IsLinear()) writeResponseCurve(state, function.Curve());
   switch (function.Type()) {
     case FunctionType::ColorMacro:
     case FunctionType::ColorWheel:
@@ -208,6 +242,9 @@ void writeFixtureTypeFunction(WriteState &state,
     case FunctionType::RotationSpeed:
       writeRotationParameters(state, function.GetRotationSpeedParameters());
       break;
+    case FunctionType::PixelBlock:
+      writePixelBlockParameters(state, function.GetPixelBlockParameters());
+      break;
     default:
       break;
   }
@@ -366,6 +403,8 @@ void writeChase(WriteState &state, const Chase &chase) {
   writeTrigger(state, chase.GetTrigger());
   writeTransition(state, chase.GetTransition());
   writeSequence(state, chase.GetSequence());
+  if (chase.GetGroup())
+    state.writer.Number("group", state.chaseGroupIds[chase.GetGroup()]);
   state.writer.EndObject();
 }
 
@@ -665,6 +704,17 @@ void writeGlightShow(WriteState &state) {
     writeFixtureGroup(state, *f);
   state.writer.EndArray();  // fixture-groups
 
+  state.writer.StartArray("chase-groups");
+  const std::vector<std::unique_ptr<ChaseGroup>> &chase_groups =
+      state.management.ChaseGroups();
+  for (const std::unique_ptr<ChaseGroup> &group : chase_groups) {
+    state.chaseGroupIds.emplace(group.get(), state.chaseGroupIds.size());
+    state.writer.StartObject();
+    state.writer.Number("step-duration", group->StepDuration());
+    state.writer.EndObject();
+  }
+  state.writer.EndArray();  // chase-groups
+
   state.writer.StartArray("controls");
 
   const std::vector<TrackablePtr<Controllable>> &controllables =
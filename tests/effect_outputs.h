@@ -0,0 +1,55 @@
+#ifndef THEATRE_EFFECT_OUTPUTS_H_
+#define THEATRE_EFFECT_OUTPUTS_H_
+
+#include <memory>
+#include <vector>
+
+#include "theatre/controlvalue.h"
+#include "theatre/effect.h"
+#include "theatre/timing.h"
+
+#include "theatre/effects/variableeffect.h"
+
+namespace glight::theatre {
+
+/**
+ * A number of variables that are connected to the outputs of an effect, so
+ * that the values that the effect writes can be inspected.
+ */
+struct EffectOutputs {
+  EffectOutputs() = default;
+  EffectOutputs(Effect& effect, size_t n) { Add(effect, n); }
+
+  /** Connects @p n new variables to the effect. */
+  void Add(Effect& effect, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+      variables.emplace_back(std::make_unique<VariableEffect>());
+      effect.AddConnection(*variables.back(), 0);
+    }
+  }
+
+  /** Returns the output values and resets them for the next mix. */
+  std::vector<unsigned> Take() {
+    std::vector<unsigned> values;
+    for (std::unique_ptr<VariableEffect>& variable : variables) {
+      values.emplace_back(variable->InputValue(0).UInt());
+      variable->InputValue(0) = ControlValue::Zero();
+    }
+    return values;
+  }
+
+  std::vector<std::unique_ptr<VariableEffect>> variables;
+};
+
+/**
+ * Timing of a frame. Unlike @ref Timing::MakeForDebug(), this sets the
+ * timestep number, which effects use to recognize a new frame.
+ */
+inline Timing MakeTiming(unsigned timestep, double time,
+                         unsigned random_value = 0) {
+  return Timing(time, timestep, 0.0, 0, random_value);
+}
+
+}  // namespace glight::theatre
+
+#endif
@@ -1,6 +1,8 @@
 #include <boost/test/unit_test.hpp>
 
+#include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include "system/colormap.h"
 
@@ -58,4 +60,72 @@ BOOST_AUTO_TEST_CASE(vision180_colors) {
   }
 }
 
+namespace {
+// The original construction, which compares every cell with the palette
+std::vector<unsigned short> BruteForceMap(const std::vector<Color>& palette,
+                                          int divisor) {
+  std::vector<unsigned short> map;
+  const int limit = 1 + 256 / divisor;
+  for (int red = 0; red != limit; ++red) {
+    for (int green = 0; green != limit; ++green) {
+      for (int blue = 0; blue != limit; ++blue) {
+        size_t closest = 0;
+        unsigned closest_distance = 1024;
+        for (size_t i = 0; i != palette.size(); ++i) {
+          const unsigned d =
+              std::abs(int(palette[i].Red()) - red * divisor) +
+              std::abs(int(palette[i].Green()) - green * divisor) +
+              std::abs(int(palette[i].Blue()) - blue * divisor);
+          if (d <= closest_distance) {
+            closest = i;
+            closest_distance = d;
+          }
+        }
+        map.emplace_back(closest);
+      }
+    }
+  }
+  return map;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(same_as_brute_force) {
+  unsigned seed = 7;
+  const auto random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) & 0xFF;
+  };
+  for (size_t palette_size : {1, 2, 5, 13, 40}) {
+    std::vector<Color> palette;
+    for (size_t i = 0; i != palette_size; ++i) {
+      palette.emplace_back(random(), random(), random());
+      // Duplicates and equal distances test the order of preference
+      if (i % 4 == 3) palette.emplace_back(palette[i - 2]);
+      if (i % 5 == 4) palette.emplace_back(palette.back().Red(), 128, 64);
+    }
+    for (int divisor : {4, 8, 128}) {
+      const ColorMap cm(palette, divisor);
+      const std::vector<unsigned short> expected =
+          BruteForceMap(palette, divisor);
+      BOOST_REQUIRE_EQUAL(cm.Size(), expected.size());
+      for (size_t i = 0; i != expected.size(); ++i) {
+        BOOST_CHECK_EQUAL(cm.GetIndexAt(i), expected[i]);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(shared) {
+  const std::vector<Color> palette{Color{255, 0, 0}, Color{0, 0, 255}};
+  const std::shared_ptr<const ColorMap> a = ColorMap::GetShared(palette, 8);
+  const std::shared_ptr<const ColorMap> b = ColorMap::GetShared(palette, 8);
+  BOOST_CHECK(a == b);
+  const std::shared_ptr<const ColorMap> c = ColorMap::GetShared(palette, 16);
+  BOOST_CHECK(a != c);
+  const std::shared_ptr<const ColorMap> d =
+      ColorMap::GetShared({Color{255, 0, 0}, Color{0, 255, 0}}, 8);
+  BOOST_CHECK(a != d);
+  BOOST_CHECK_EQUAL(d->GetIndex(Color{0, 200, 0}), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
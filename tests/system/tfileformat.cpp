@@ -1,4 +1,5 @@
 #include "theatre/chase.h"
+#include "theatre/chasegroup.h"
 #include "theatre/fixture.h"
 #include "theatre/fixturecontrol.h"
 #include "theatre/fixturegroup.h"
@@ -50,6 +51,13 @@ void FillManagement(Management &management) {
   ObservingPtr<FixtureType> ft =
       management.GetTheatre().AddFixtureTypePtr(StockFixture::Rgbw);
   root.Add(ft);
+  // Test storing response curves
+  std::vector<FixtureModeFunction> functions = ft->Modes().front().Functions();
+  functions[0].SetCurve(ResponseCurve::Gamma(2.2));
+  functions[1].SetCurve(ResponseCurve::SCurve());
+  functions[2].SetCurve(
+      ResponseCurve::Custom({{0.0, 0.0}, {0.25, 0.5}, {1.0, 0.75}}));
+  ft->Modes().front().SetFunctions(std::move(functions));
   Fixture &f = *management.GetTheatre().AddFixture(ft->Modes().front());
   FixtureControl &fc = *management.AddFixtureControlPtr(f, subFolder);
   fc.SetName("Control for RGBW fixture");
@@ -65,6 +73,12 @@ void FillManagement(Management &management) {
       "The root folder/A subfolder/Control for RGBW fixture");
   BOOST_CHECK(found_fc.Get() == &path_fc);
 
+  // Test storing the pixel count of a pixel block
+  ObservingPtr<FixtureType> bar =
+      management.GetTheatre().AddFixtureTypePtr(StockFixture::RgbPixelBar);
+  root.Add(bar);
+  management.GetTheatre().AddFixture(bar->Modes().front());
+
   ObservingPtr<PresetCollection> a = management.AddPresetCollectionPtr();
   a->SetName("A preset collection");
   subFolder.Add(a);
@@ -85,6 +99,10 @@ void FillManagement(Management &management) {
   chase->GetSequence().Add(*a, 0);
   chase->GetSequence().Add(*b, 0);
   management.AddSourceValue(*chase, 0);
+  management.AddChaseGroup();
+  ChaseGroup &chase_group = management.AddChaseGroup();
+  chase_group.SetStepDuration(750.0);
+  chase->SetGroup(&chase_group);
 
   ObservingPtr<TimeSequence> timeSequence = management.AddTimeSequencePtr();
   timeSequence->SetName("A time sequence");
@@ -122,6 +140,9 @@ void CheckEqual(const FixtureModeFunction &a, const FixtureModeFunction &b) {
   BOOST_CHECK_EQUAL(a.DmxOffset(), b.DmxOffset());
   BOOST_CHECK(a.FineChannelOffset() == b.FineChannelOffset());
   BOOST_CHECK_EQUAL(a.Shape(), b.Shape());
+  BOOST_CHECK(a.Curve().Type() == b.Curve().Type());
+  BOOST_CHECK_EQUAL(a.Curve().GammaValue(), b.Curve().GammaValue());
+  BOOST_CHECK(a.Curve().Points() == b.Curve().Points());
 
   switch (a.Type()) {
     case FunctionType::ColorMacro: {
@@ -149,6 +170,10 @@ void CheckEqual(const FixtureModeFunction &a, const FixtureModeFunction &b) {
         BOOST_CHECK_EQUAL(a_range.speed_max, b_range.speed_max);
       }
     } break;
+    case FunctionType::PixelBlock:
+      BOOST_CHECK_EQUAL(a.GetPixelBlockParameters().PixelCount(),
+                        b.GetPixelBlockParameters().PixelCount());
+      break;
     default:
       break;
   }
@@ -179,6 +204,15 @@ void CheckEqual(const Management &a, const Management &b) {
 
   BOOST_REQUIRE_EQUAL(a.GetTheatre().Fixtures().size(),
                       b.GetTheatre().Fixtures().size());
+  for (size_t i = 0; i != a.GetTheatre().Fixtures().size(); ++i) {
+    const Fixture &a_f = *a.GetTheatre().Fixtures()[i];
+    const Fixture &b_f = *b.GetTheatre().Fixtures()[i];
+    BOOST_REQUIRE_EQUAL(a_f.Functions().size(), b_f.Functions().size());
+    for (size_t j = 0; j != a_f.Functions().size(); ++j) {
+      BOOST_CHECK_EQUAL(a_f.Functions()[j]->PixelCount(),
+                        b_f.Functions()[j]->PixelCount());
+    }
+  }
 
   const Fixture &a_fixture = *a.GetTheatre().Fixtures()[0];
   ObservingPtr<FixtureControl> a_fixture_control =
@@ -243,6 +277,9 @@ void CheckEqual(const Management &a, const Management &b) {
   BOOST_CHECK_EQUAL(readChase.GetSequence().List()[0].GetControllable(),
                     &readCollection);
   BOOST_CHECK_EQUAL(readChase.GetSequence().List()[0].InputIndex(), 0);
+  BOOST_REQUIRE_EQUAL(a.ChaseGroups().size(), 2);
+  BOOST_CHECK_EQUAL(readChase.GetGroup(), a.ChaseGroups()[1].get());
+  BOOST_CHECK_EQUAL(a.ChaseGroups()[1]->StepDuration(), 750.0);
 
   const AudioLevelEffect *readEffect = dynamic_cast<const AudioLevelEffect *>(
       &a.GetObjectFromPath("The root folder/Effect folder/An audio effect"));
@@ -0,0 +1,155 @@
+#include "theatre/effects/delayeffect.h"
+
+#include "theatre/properties/propertyset.h"
+
+#include "theatre/timing.h"
+
+#include "tests/effect_outputs.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace glight::theatre;
+
+BOOST_AUTO_TEST_SUITE(delay_effect)
+
+BOOST_AUTO_TEST_CASE(single_tap) {
+  DelayEffect effect;
+  effect.SetDelayInMS(100.0);
+  EffectOutputs outputs(effect, 2);
+  // The input is set to the time at which it was given, in 25 ms frames
+  for (unsigned step = 1; step != 40; ++step) {
+    const double time = step * 25.0;
+    effect.InputValue(0) = ControlValue(step * 1000);
+    effect.Mix(MakeTiming(step, time), true);
+    const std::vector<unsigned> values = outputs.Take();
+    const unsigned expected = time < 125.0 ? 0 : (step - 4) * 1000;
+    BOOST_CHECK_EQUAL(values[0], expected);
+    BOOST_CHECK_EQUAL(values[1], expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(irregular_frames) {
+  DelayEffect effect;
+  effect.SetDelayInMS(200.0);
+  EffectOutputs outputs(effect, 1);
+  effect.InputValue(0) = ControlValue(1000);
+  effect.Mix(MakeTiming(1, 0.0), true);
+  BOOST_CHECK_EQUAL(outputs.Take()[0], 0);
+  effect.InputValue(0) = ControlValue(2000);
+  effect.Mix(MakeTiming(2, 150.0), true);
+  BOOST_CHECK_EQUAL(outputs.Take()[0], 0);
+  // A long gap between frames: the first value is held until the second
+  effect.InputValue(0) = ControlValue(3000);
+  effect.Mix(MakeTiming(3, 300.0), true);
+  BOOST_CHECK_EQUAL(outputs.Take()[0], 1000);
+  effect.Mix(MakeTiming(4, 360.0), true);
+  BOOST_CHECK_EQUAL(outputs.Take()[0], 2000);
+  // A gap longer than the delay
+  effect.Mix(MakeTiming(5, 5000.0), true);
+  BOOST_CHECK_EQUAL(outputs.Take()[0], 3000);
+}
+
+BOOST_AUTO_TEST_CASE(same_timestep) {
+  DelayEffect effect;
+  effect.SetDelayInMS(50.0);
+  EffectOutputs outputs(effect, 1);
+  effect.InputValue(0) = ControlValue(1000);
+  effect.Mix(MakeTiming(1, 0.0), true);
+  effect.InputValue(0) = ControlValue(2000);
+  effect.Mix(MakeTiming(1, 0.0), true);
+  outputs.Take();
+  effect.InputValue(0) = ControlValue::Zero();
+  effect.Mix(MakeTiming(2, 50.0), true);
+  BOOST_CHECK_EQUAL(outputs.Take()[0], 3000);
+}
+
+BOOST_AUTO_TEST_CASE(change_while_running) {
+  DelayEffect effect;
+  effect.SetDelayInMS(100.0);
+  EffectOutputs outputs(effect, 2);
+  effect.InputValue(0) = ControlValue(1000);
+  const auto mix = [&](unsigned step) {
+    effect.Mix(MakeTiming(step, step * 25.0), true);
+    return outputs.Take();
+  };
+  for (unsigned step = 1; step != 9; ++step) mix(step);
+  BOOST_CHECK(mix(9) == std::vector<unsigned>({1000, 1000}));
+  // The new settings take effect at the next mix, with an empty history
+  effect.SetDelayInMS(50.0);
+  effect.SetTaps(2);
+  BOOST_CHECK(mix(10) == std::vector<unsigned>({0, 0}));
+  BOOST_CHECK(mix(11) == std::vector<unsigned>({0, 0}));
+  BOOST_CHECK(mix(12) == std::vector<unsigned>({1000, 0}));
+  BOOST_CHECK(mix(13) == std::vector<unsigned>({1000, 0}));
+  BOOST_CHECK(mix(14) == std::vector<unsigned>({1000, 1000}));
+}
+
+BOOST_AUTO_TEST_CASE(multiple_taps) {
+  DelayEffect effect;
+  effect.SetDelayInMS(100.0);
+  effect.SetTaps(3);
+  EffectOutputs outputs(effect, 6);
+  effect.InputValue(0) = ControlValue::Max();
+  effect.Mix(MakeTiming(1, 0.0), true);
+  effect.InputValue(0) = ControlValue::Zero();
+  std::vector<double> on_time(6, -1.0);
+  for (unsigned step = 1; step != 20; ++step) {
+    effect.Mix(MakeTiming(step + 1, step * 25.0), true);
+    const std::vector<unsigned> values = outputs.Take();
+    for (size_t i = 0; i != values.size(); ++i) {
+      if (values[i]) {
+        BOOST_CHECK_EQUAL(on_time[i], -1.0);
+        on_time[i] = step * 25.0;
+      }
+    }
+  }
+  // The flash of the first frame echoes on each tap, and connection i
+  // receives tap i modulo 3
+  BOOST_CHECK_EQUAL(on_time[0], 100.0);
+  BOOST_CHECK_EQUAL(on_time[1], 200.0);
+  BOOST_CHECK_EQUAL(on_time[2], 300.0);
+  BOOST_CHECK_EQUAL(on_time[3], 100.0);
+  BOOST_CHECK_EQUAL(on_time[4], 200.0);
+  BOOST_CHECK_EQUAL(on_time[5], 300.0);
+}
+
+BOOST_AUTO_TEST_CASE(bounded_memory) {
+  DelayEffect effect;
+  effect.SetDelayInMS(1000.0);
+  const size_t capacity = effect.Capacity();
+  BOOST_CHECK_LE(capacity, 250);
+  EffectOutputs outputs(effect, 1);
+  for (unsigned step = 1; step != 10000; ++step) {
+    effect.InputValue(0) = ControlValue(step);
+    effect.Mix(MakeTiming(step, step * 5.0), true);
+    const unsigned expected = step > 200 ? step - 200 : 0;
+    BOOST_CHECK_EQUAL(outputs.Take()[0], expected);
+  }
+  BOOST_CHECK_EQUAL(effect.Capacity(), capacity);
+
+  effect.SetTaps(4);
+  BOOST_CHECK_GT(effect.Capacity(), capacity);
+  // Very long delays do not use unbounded memory
+  effect.SetDelayInMS(24.0 * 60.0 * 60.0 * 1000.0);
+  BOOST_CHECK_LE(effect.Capacity(), 16384);
+}
+
+BOOST_AUTO_TEST_CASE(properties) {
+  DelayEffect effect;
+  std::unique_ptr<PropertySet> properties = PropertySet::Make(effect);
+  Property &taps = properties->GetProperty("taps");
+  BOOST_CHECK_EQUAL(properties->GetInteger(taps), 1);
+  properties->SetInteger(taps, 4);
+  BOOST_CHECK_EQUAL(effect.GetTaps(), 4);
+  properties->SetInteger(taps, -2);
+  BOOST_CHECK_EQUAL(effect.GetTaps(), 1);
+  Property &delay = properties->GetProperty("delay");
+  properties->SetDuration(delay, 250.0);
+  BOOST_CHECK_EQUAL(effect.DelayInMS(), 250.0);
+  BOOST_CHECK_EQUAL(properties->GetDuration(delay), 250.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
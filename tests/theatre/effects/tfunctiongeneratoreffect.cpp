@@ -0,0 +1,156 @@
+#include "theatre/effects/functiongeneratoreffect.h"
+
+#include "theatre/properties/propertyset.h"
+
+#include "theatre/timing.h"
+
+#include "tests/effect_outputs.h"
+#include "tests/tolerance_check.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace glight::theatre;
+
+namespace {
+
+using Function = FunctionGeneratorEffect::Function;
+using Spread = FunctionGeneratorEffect::Spread;
+
+/** Value of a single, non-spread generator at the given time. */
+unsigned SingleValue(Function function, double time) {
+  FunctionGeneratorEffect effect;
+  effect.SetFunction(function);
+  effect.SetPeriod(1000.0);
+  effect.InputValue(0) = ControlValue::Max();
+  EffectOutputs outputs(effect, 1);
+  effect.Mix(Timing::MakeForDebug(time), true);
+  return outputs.Take()[0];
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(function_generator_effect)
+
+BOOST_AUTO_TEST_CASE(no_spread) {
+  FunctionGeneratorEffect effect;
+  effect.SetPeriod(1000.0);
+  effect.InputValue(0) = ControlValue::Max();
+  BOOST_CHECK(effect.GetSpread() == Spread::None);
+  EffectOutputs outputs(effect, 5);
+  effect.Mix(Timing::MakeForDebug(100.0), true);
+  const std::vector<unsigned> values = outputs.Take();
+  for (unsigned value : values) {
+    BOOST_CHECK_EQUAL(value, SingleValue(Function::Sine, 100.0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(linear_spread) {
+  for (Function function :
+       {Function::Sine, Function::Cosine, Function::Square,
+        Function::Sawtooth, Function::Triangle, Function::Staircase}) {
+    FunctionGeneratorEffect effect;
+    effect.SetFunction(function);
+    effect.SetPeriod(1000.0);
+    effect.SetSpread(Spread::Linear);
+    effect.InputValue(0) = ControlValue::Max();
+    EffectOutputs outputs(effect, 8);
+    for (double time : {0.0, 140.0, 530.0, 999.0}) {
+      effect.Mix(Timing::MakeForDebug(time), true);
+      const std::vector<unsigned> values = outputs.Take();
+      for (size_t i = 0; i != values.size(); ++i) {
+        // Output i lags by i/8 of a period
+        const double lagged_time = time - i * 125.0 + 1000.0;
+        ToleranceCheck(ControlValue(values[i]),
+                       SingleValue(function, lagged_time), 16);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(center_out_spread) {
+  FunctionGeneratorEffect effect;
+  effect.SetPeriod(1000.0);
+  effect.SetSpread(Spread::CenterOut);
+  effect.InputValue(0) = ControlValue::Max();
+  EffectOutputs outputs(effect, 5);
+  effect.Mix(Timing::MakeForDebug(300.0), true);
+  const std::vector<unsigned> values = outputs.Take();
+  ToleranceCheck(ControlValue(values[2]), SingleValue(Function::Sine, 300.0),
+                 16);
+  // Ends lag by 2/5 of a period
+  ToleranceCheck(ControlValue(values[0]), SingleValue(Function::Sine, 900.0),
+                 16);
+  BOOST_CHECK_EQUAL(values[0], values[4]);
+  BOOST_CHECK_EQUAL(values[1], values[3]);
+}
+
+BOOST_AUTO_TEST_CASE(random_spread) {
+  FunctionGeneratorEffect effect_a;
+  effect_a.SetSpread(Spread::Random);
+  effect_a.InputValue(0) = ControlValue::Max();
+  EffectOutputs outputs_a(effect_a, 10);
+  FunctionGeneratorEffect effect_b;
+  effect_b.SetSpread(Spread::Random);
+  effect_b.InputValue(0) = ControlValue::Max();
+  EffectOutputs outputs_b(effect_b, 4);
+  const Timing timing = Timing::MakeForDebug(200.0);
+  effect_a.Mix(timing, true);
+  effect_b.Mix(timing, true);
+  const std::vector<unsigned> values_a = outputs_a.Take();
+  const std::vector<unsigned> values_b = outputs_b.Take();
+  // The offset of an output only depends on its index
+  for (size_t i = 0; i != values_b.size(); ++i) {
+    BOOST_CHECK_EQUAL(values_a[i], values_b[i]);
+  }
+  BOOST_CHECK_NE(values_a[0], values_a[1]);
+}
+
+BOOST_AUTO_TEST_CASE(strobe_spread) {
+  FunctionGeneratorEffect effect;
+  effect.SetFunction(Function::Strobe);
+  effect.SetPeriod(1000.0);
+  effect.SetSpread(Spread::Linear);
+  effect.InputValue(0) = ControlValue::Max();
+  EffectOutputs outputs(effect, 4);
+  // The first frame flashes all outputs
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  for (unsigned value : outputs.Take()) BOOST_CHECK_GT(value, 0);
+
+  std::vector<size_t> flash_count(4, 0);
+  std::vector<double> flash_time(4, 0.0);
+  for (double time = 10.0; time < 1000.0; time += 10.0) {
+    effect.Mix(Timing::MakeForDebug(time), true);
+    const std::vector<unsigned> values = outputs.Take();
+    for (size_t i = 0; i != values.size(); ++i) {
+      if (values[i] > 0) {
+        ++flash_count[i];
+        flash_time[i] = time;
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(flash_count[0], 0);
+  for (size_t i = 1; i != 4; ++i) {
+    BOOST_CHECK_EQUAL(flash_count[i], 1);
+    // Output i lags by i/4 of a period, so flashes i/4 period later
+    BOOST_CHECK_CLOSE(flash_time[i], i * 250.0, 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(spread_property) {
+  FunctionGeneratorEffect effect;
+  std::unique_ptr<PropertySet> properties = PropertySet::Make(effect);
+  Property &spread = properties->GetProperty("spread");
+  BOOST_CHECK_EQUAL(properties->GetChoice(spread), "none");
+  properties->SetChoice(spread, "center_out");
+  BOOST_CHECK(effect.GetSpread() == Spread::CenterOut);
+  BOOST_CHECK_EQUAL(properties->GetChoice(spread), "center_out");
+  properties->SetChoice(spread, "random");
+  BOOST_CHECK(effect.GetSpread() == Spread::Random);
+  properties->SetChoice(spread, "linear");
+  BOOST_CHECK(effect.GetSpread() == Spread::Linear);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
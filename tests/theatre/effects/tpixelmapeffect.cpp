@@ -0,0 +1,226 @@
+#include "theatre/effects/pixelmapeffect.h"
+#include "theatre/effects/variableeffect.h"
+
+#include "system/settings.h"
+
+#include "theatre/fixture.h"
+#include "theatre/fixturecontrol.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/properties/propertyset.h"
+#include "theatre/theatre.h"
+#include "theatre/timing.h"
+
+#include "tests/tolerance_check.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <span>
+
+namespace glight::theatre {
+
+namespace {
+
+/**
+ * Adds RGB fixtures at the given x positions and connects their red, green
+ * and blue inputs to the effect.
+ */
+std::vector<FixtureControl *> AddFixtures(Management &management,
+                                          PixelMapEffect &effect,
+                                          const std::vector<double> &xs) {
+  const FixtureType &type =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::Rgb);
+  std::vector<FixtureControl *> controls;
+  for (double x : xs) {
+    Fixture &fixture =
+        *management.GetTheatre().AddFixture(type.Modes().front());
+    fixture.GetPosition().X() = x;
+    FixtureControl &control = static_cast<FixtureControl &>(
+        *management.AddFixtureControl(fixture).Get());
+    for (size_t input = 0; input != 3; ++input)
+      effect.AddConnection(control, input);
+    controls.emplace_back(&control);
+  }
+  return controls;
+}
+
+void CheckRgb(FixtureControl &control, unsigned r, unsigned g, unsigned b) {
+  ToleranceCheck(control.InputValue(0), r, 2);
+  ToleranceCheck(control.InputValue(1), g, 2);
+  ToleranceCheck(control.InputValue(2), b, 2);
+}
+
+void Reset(const std::vector<FixtureControl *> &controls) {
+  for (FixtureControl *control : controls) {
+    for (size_t input = 0; input != 3; ++input)
+      control->InputValue(input) = ControlValue::Zero();
+  }
+}
+
+constexpr unsigned kFull = ControlValue::MaxUInt();
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(pixel_map_effect)
+
+BOOST_AUTO_TEST_CASE(horizontal_rainbow) {
+  const system::Settings settings;
+  Management management(settings);
+  PixelMapEffect effect;
+  effect.SetPeriod(1000.0);
+  const std::vector<FixtureControl *> controls =
+      AddFixtures(management, effect, {2.0, 3.0, 4.0});
+
+  // Without input, nothing is written
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  CheckRgb(*controls[1], 0, 0, 0);
+
+  effect.InputValue(0) = ControlValue::Max();
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  // Hue goes from 0 (red) at the left via 0.5 (cyan) to 1 (red)
+  CheckRgb(*controls[0], kFull, 0, 0);
+  CheckRgb(*controls[1], 0, kFull, kFull);
+  CheckRgb(*controls[2], kFull, 0, 0);
+  Reset(controls);
+
+  // A third period later, the middle fixture has a hue of 1/6 (yellow)
+  effect.Mix(Timing::MakeForDebug(1000.0 / 3.0), true);
+  CheckRgb(*controls[1], kFull, kFull, 0);
+  Reset(controls);
+
+  // At half size, the pattern is repeated twice over the fixtures
+  effect.SetSize(50);
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  CheckRgb(*controls[1], kFull, 0, 0);
+  Reset(controls);
+
+  // Moving a fixture is picked up immediately
+  controls[1]->GetFixture().GetPosition().X() = 2.5;
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  CheckRgb(*controls[1], 0, kFull, kFull);
+}
+
+BOOST_AUTO_TEST_CASE(changed_connections) {
+  const system::Settings settings;
+  Management management(settings);
+  PixelMapEffect effect;
+  effect.InputValue(0) = ControlValue::Max() / 2;
+  const std::vector<FixtureControl *> controls =
+      AddFixtures(management, effect, {0.0, 10.0});
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  CheckRgb(*controls[0], kFull / 2, 0, 0);
+  CheckRgb(*controls[1], kFull / 2, 0, 0);
+  Reset(controls);
+
+  // With a single fixture, its pattern position is at the origin
+  for (size_t input = 0; input != 3; ++input)
+    effect.RemoveConnection(*controls[1], input);
+  controls[0]->GetFixture().GetPosition().X() = 5.0;
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  CheckRgb(*controls[0], kFull / 2, 0, 0);
+  CheckRgb(*controls[1], 0, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(non_fixture_connection) {
+  const system::Settings settings;
+  Management management(settings);
+  PixelMapEffect effect;
+  effect.InputValue(0) = ControlValue::Max();
+  VariableEffect variable;
+  effect.AddConnection(variable, 0);
+  const std::vector<FixtureControl *> controls =
+      AddFixtures(management, effect, {2.0, 3.0, 4.0});
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  // The connection does not stretch the pattern to the origin
+  CheckRgb(*controls[0], kFull, 0, 0);
+  CheckRgb(*controls[1], 0, kFull, kFull);
+  CheckRgb(*controls[2], kFull, 0, 0);
+  // It is placed at the start of the pattern, which is red
+  ToleranceCheck(variable.InputValue(0), kFull, 2);
+}
+
+BOOST_AUTO_TEST_CASE(pixel_block) {
+  const system::Settings settings;
+  Management management(settings);
+  FixtureType &type =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::RgbPixelBar);
+  FixtureMode &mode = type.Modes().front();
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  functions.front().GetPixelBlockParameters().SetPixelCount(3);
+  mode.SetFunctions(std::move(functions));
+  Fixture &fixture = *management.GetTheatre().AddFixture(mode);
+  FixtureControl &control = static_cast<FixtureControl &>(
+      *management.AddFixtureControl(fixture).Get());
+  PixelMapEffect effect;
+  effect.AddConnection(control, 0);
+  effect.InputValue(0) = ControlValue::Max();
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  // The cells are spread over the fixture, and are written directly
+  const std::span<const ControlValue> cells = control.PixelValues(0);
+  BOOST_REQUIRE_EQUAL(cells.size(), 9);
+  const unsigned expected[9] = {kFull, 0, 0, 0, kFull, kFull, kFull, 0, 0};
+  for (size_t i = 0; i != 9; ++i) ToleranceCheck(cells[i], expected[i], 2);
+  BOOST_CHECK_EQUAL(control.InputValue(0).UInt(), 0);
+
+  // Effects add to the cells, which are cleared by Management every mix
+  effect.Mix(Timing::MakeForDebug(0.0), true);
+  ToleranceCheck(control.PixelValues(0)[0], 2 * kFull, 4);
+  control.ClearPixelValues();
+  BOOST_CHECK_EQUAL(control.PixelValues(0)[0].UInt(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(patterns) {
+  const system::Settings settings;
+  Management management(settings);
+  std::unique_ptr<PropertySet> properties;
+  for (const std::string pattern :
+       {"horizontal_rainbow", "vertical_rainbow", "radial_rainbow", "plasma",
+        "noise"}) {
+    PixelMapEffect effect;
+    properties = PropertySet::Make(effect);
+    properties->SetChoice(properties->GetProperty("pattern"), pattern);
+    BOOST_CHECK_EQUAL(
+        properties->GetChoice(properties->GetProperty("pattern")), pattern);
+    effect.InputValue(0) = ControlValue::Max();
+    const std::vector<FixtureControl *> controls =
+        AddFixtures(management, effect, {0.0, 1.0, 2.0, 3.0});
+    effect.Mix(Timing::MakeForDebug(123.0), true);
+    for (FixtureControl *control : controls) {
+      // A fully saturated hue has at least one full and one zero component
+      unsigned max = 0;
+      unsigned min = kFull;
+      for (size_t input = 0; input != 3; ++input) {
+        max = std::max(max, control->InputValue(input).UInt());
+        min = std::min(min, control->InputValue(input).UInt());
+      }
+      BOOST_CHECK_GE(max, kFull - 2);
+      BOOST_CHECK_EQUAL(min, 0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(performance, *boost::unit_test::disabled()) {
+  const system::Settings settings;
+  Management management(settings);
+  PixelMapEffect effect;
+  effect.SetPattern(PixelMapEffect::Pattern::Plasma);
+  effect.InputValue(0) = ControlValue::Max();
+  std::vector<double> xs;
+  for (size_t i = 0; i != 3000; ++i) xs.emplace_back(i);
+  const std::vector<FixtureControl *> controls =
+      AddFixtures(management, effect, xs);
+  constexpr size_t n_frames = 1000;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame != n_frames; ++frame) {
+    effect.Mix(Timing::MakeForDebug(frame * 25.0), true);
+  }
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  BOOST_TEST_MESSAGE("Pixel map with 3000 RGB pixels: "
+                     << duration.count() * 1e6 / n_frames << " us per mix");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace glight::theatre
@@ -0,0 +1,111 @@
+#include "theatre/effects/randomselecteffect.h"
+
+#include "theatre/timing.h"
+
+#include "tests/effect_outputs.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace glight::theatre;
+
+namespace {
+
+/** Returns the indices of the outputs that are on, and resets them. */
+std::vector<size_t> TakeActive(EffectOutputs &outputs) {
+  const std::vector<unsigned> values = outputs.Take();
+  std::vector<size_t> active;
+  for (size_t i = 0; i != values.size(); ++i) {
+    if (values[i]) {
+      BOOST_CHECK_EQUAL(values[i], ControlValue::MaxUInt());
+      active.emplace_back(i);
+    }
+  }
+  return active;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(random_select_effect)
+
+BOOST_AUTO_TEST_CASE(selection) {
+  RandomSelectEffect effect;
+  effect.SetCount(3);
+  effect.SetDelay(100.0);
+  effect.SetTransition(Transition(0.0, TransitionType::Fade));
+  EffectOutputs outputs;
+  outputs.Add(effect, 10);
+  effect.InputValue(0) = ControlValue::Max();
+
+  std::vector<size_t> previous;
+  for (unsigned step = 0; step != 20; ++step) {
+    effect.Mix(MakeTiming(step, step * 25.0, step), true);
+    const std::vector<size_t> active = TakeActive(outputs);
+    BOOST_CHECK_EQUAL(active.size(), 3);
+    // The selection only changes when the delay has passed
+    if (step % 4 != 0) BOOST_CHECK(active == previous);
+    previous = active;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(single_output_changes) {
+  RandomSelectEffect effect;
+  effect.SetDelay(100.0);
+  effect.SetTransition(Transition(0.0, TransitionType::Fade));
+  EffectOutputs outputs;
+  outputs.Add(effect, 2);
+  effect.InputValue(0) = ControlValue::Max();
+
+  effect.Mix(MakeTiming(0, 0.0, 0), true);
+  std::vector<size_t> previous = TakeActive(outputs);
+  BOOST_REQUIRE_EQUAL(previous.size(), 1);
+  for (unsigned step = 1; step != 10; ++step) {
+    effect.Mix(MakeTiming(step, step * 100.0, step), true);
+    const std::vector<size_t> active = TakeActive(outputs);
+    BOOST_REQUIRE_EQUAL(active.size(), 1);
+    BOOST_CHECK_NE(active[0], previous[0]);
+    previous = active;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(first_selection) {
+  // Every output can be the first one that is selected
+  std::vector<size_t> counts(3, 0);
+  for (unsigned seed = 0; seed != 100; ++seed) {
+    RandomSelectEffect effect;
+    effect.SetTransition(Transition(0.0, TransitionType::Fade));
+    EffectOutputs outputs;
+    outputs.Add(effect, 3);
+    effect.InputValue(0) = ControlValue::Max();
+    effect.Mix(MakeTiming(0, 0.0, seed), true);
+    const std::vector<size_t> active = TakeActive(outputs);
+    BOOST_REQUIRE_EQUAL(active.size(), 1);
+    ++counts[active[0]];
+  }
+  for (size_t count : counts) BOOST_CHECK_GT(count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(changing_connections) {
+  RandomSelectEffect effect;
+  effect.SetCount(4);
+  EffectOutputs outputs;
+  outputs.Add(effect, 2);
+  effect.InputValue(0) = ControlValue::Max();
+  effect.Mix(MakeTiming(0, 0.0, 0), true);
+  BOOST_CHECK_EQUAL(TakeActive(outputs).size(), 2);
+
+  outputs.Add(effect, 8);
+  effect.Mix(MakeTiming(1, 25.0, 1), true);
+  BOOST_CHECK_EQUAL(TakeActive(outputs).size(), 4);
+
+  for (size_t i = 0; i != 7; ++i) effect.RemoveConnection(0);
+  effect.Mix(MakeTiming(2, 50.0, 2), true);
+  const std::vector<size_t> active = TakeActive(outputs);
+  // Only the last three outputs are still connected
+  BOOST_REQUIRE_EQUAL(active.size(), 3);
+  BOOST_CHECK_EQUAL(active[0], 7);
+  BOOST_CHECK_EQUAL(active[2], 9);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+#include "theatre/effects/twinkleeffect.h"
+
+#include "theatre/timing.h"
+
+#include "tests/effect_outputs.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace glight::theatre;
+
+namespace {
+
+/** Returns the number of outputs that are on, and resets them. */
+size_t TakeCount(EffectOutputs &outputs) {
+  const std::vector<unsigned> values = outputs.Take();
+  return std::count_if(values.begin(), values.end(),
+                       [](unsigned value) { return value != 0; });
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(twinkle_effect)
+
+BOOST_AUTO_TEST_CASE(field) {
+  TwinkleEffect effect;
+  effect.SetAverageDelay(500.0);
+  effect.SetHoldTime(100.0);
+  EffectOutputs outputs;
+  outputs.Add(effect, 300);
+  effect.InputValue(0) = ControlValue::Max();
+
+  for (unsigned step = 0; step != 100; ++step) {
+    effect.Mix(MakeTiming(step, step * 20.0, step), true);
+    const size_t count = TakeCount(outputs);
+    // All outputs start waiting, after that part of the field is on
+    if (step == 0) {
+      BOOST_CHECK_EQUAL(count, 0);
+    } else if (step >= 50) {
+      BOOST_CHECK_GT(count, 0);
+      BOOST_CHECK_LT(count, 300);
+    }
+  }
+
+  // Removing connections keeps the state of the remaining outputs valid
+  for (size_t i = 0; i != 200; ++i) effect.RemoveConnection(0);
+  for (unsigned step = 100; step != 200; ++step) {
+    effect.Mix(MakeTiming(step, step * 20.0, step), true);
+    TakeCount(outputs);
+  }
+  BOOST_CHECK_EQUAL(effect.Connections().size(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(off) {
+  TwinkleEffect effect;
+  EffectOutputs outputs;
+  outputs.Add(effect, 10);
+  for (unsigned step = 0; step != 100; ++step) {
+    effect.Mix(MakeTiming(step, step * 20.0, step), true);
+    BOOST_CHECK_EQUAL(TakeCount(outputs), 0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
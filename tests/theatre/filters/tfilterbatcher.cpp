@@ -0,0 +1,194 @@
+#include "theatre/filters/filterbatcher.h"
+
+#include "system/settings.h"
+
+#include "theatre/fixturecontrol.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/theatre.h"
+#include "theatre/timing.h"
+
+#include "theatre/filters/automasterfilter.h"
+#include "theatre/filters/colortemperaturefilter.h"
+#include "theatre/filters/monochromefilter.h"
+#include "theatre/filters/rgbfilter.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+
+using namespace glight::theatre;
+
+BOOST_AUTO_TEST_SUITE(filter_batcher)
+
+namespace {
+FixtureControl &AddControl(Management &management,
+                           const FixtureType &fixture_type, size_t index) {
+  Fixture &fixture =
+      *management.GetTheatre().AddFixture(fixture_type.Modes().front());
+  FixtureControl &control = *management.AddFixtureControlPtr(fixture);
+  control.AddFilter(std::make_unique<MonochromeFilter>());
+  control.AddFilter(std::make_unique<ColorTemperatureFilter>());
+  control.AddFilter(std::make_unique<RgbFilter>());
+  control.AddFilter(std::make_unique<AutoMasterFilter>());
+  for (size_t input = 0; input != control.NInputs(); ++input) {
+    control.InputValue(input) = ControlValue(
+        (index * 7919 + input * 104729) % (ControlValue::MaxUInt() + 1));
+  }
+  return control;
+}
+
+std::vector<std::vector<unsigned>> MixUnbatched(
+    const std::vector<FixtureControl *> &controls) {
+  std::vector<std::vector<unsigned>> result;
+  for (FixtureControl *control : controls) {
+    control->MixFilters();
+    std::vector<unsigned> &values = result.emplace_back();
+    for (size_t i = 0; i != control->GetFixture().Functions().size(); ++i)
+      values.emplace_back(control->FunctionValues()[i].UInt());
+  }
+  return result;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(same_as_unbatched) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  std::vector<FixtureControl *> controls;
+  for (StockFixture stock_fixture :
+       {StockFixture::RgbawUv, StockFixture::Light, StockFixture::Rgb}) {
+    const FixtureType &fixture_type =
+        *management.GetTheatre().AddFixtureTypePtr(stock_fixture);
+    for (size_t i = 0; i != 5; ++i)
+      controls.emplace_back(&AddControl(management, fixture_type, i));
+  }
+  std::vector<std::vector<ControlValue>> inputs;
+  for (FixtureControl *control : controls) {
+    std::vector<ControlValue> &values = inputs.emplace_back();
+    for (size_t i = 0; i != control->NInputs(); ++i)
+      values.emplace_back(control->InputValue(i));
+  }
+  const std::vector<std::vector<unsigned>> expected = MixUnbatched(controls);
+  // The outputs may have overwritten the inputs
+  for (size_t c = 0; c != controls.size(); ++c) {
+    for (size_t i = 0; i != inputs[c].size(); ++i)
+      controls[c]->InputValue(i) = inputs[c][i];
+  }
+
+  FilterBatcher batcher;
+  batcher.Compile(controls);
+  BOOST_CHECK_EQUAL(batcher.GroupCount(), 3);
+  for (FixtureControl *control : controls) BOOST_CHECK(control->IsBatched());
+  batcher.Mix();
+  BOOST_CHECK(!batcher.IsDirty());
+  for (size_t c = 0; c != controls.size(); ++c) {
+    for (size_t i = 0; i != expected[c].size(); ++i) {
+      BOOST_CHECK_EQUAL(controls[c]->FunctionValues()[i].UInt(),
+                        expected[c][i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(grouping) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  const FixtureType &rgb =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::Rgb);
+  const FixtureType &light =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::Light);
+  FixtureControl &a = AddControl(management, rgb, 0);
+  FixtureControl &b = AddControl(management, rgb, 1);
+  FixtureControl &single = AddControl(management, light, 2);
+  // A control with a different filter chain
+  FixtureControl &c = AddControl(management, rgb, 3);
+  c.AddFilter(std::make_unique<AutoMasterFilter>());
+  Fixture &fixture =
+      *management.GetTheatre().AddFixture(rgb.Modes().front());
+  FixtureControl &unfiltered = *management.AddFixtureControlPtr(fixture);
+
+  FilterBatcher batcher;
+  batcher.Compile({&a, &b, &single, &c, &unfiltered});
+  BOOST_CHECK_EQUAL(batcher.GroupCount(), 1);
+  BOOST_CHECK(a.IsBatched());
+  BOOST_CHECK(b.IsBatched());
+  BOOST_CHECK(!single.IsBatched());
+  BOOST_CHECK(!c.IsBatched());
+  BOOST_CHECK(!unfiltered.IsBatched());
+
+  // Changing the chain of a batched control falls back to unbatched mixing
+  b.AddFilter(std::make_unique<AutoMasterFilter>());
+  for (size_t input = 0; input != b.NInputs(); ++input)
+    b.InputValue(input) = ControlValue::Max();
+  const std::vector<std::vector<unsigned>> expected = MixUnbatched({&a, &b});
+  batcher.Mix();
+  BOOST_CHECK(batcher.IsDirty());
+  for (size_t i = 0; i != expected[1].size(); ++i)
+    BOOST_CHECK_EQUAL(b.FunctionValues()[i].UInt(), expected[1][i]);
+
+  batcher.Compile({&a, &b, &single, &c, &unfiltered});
+  BOOST_CHECK(!batcher.IsDirty());
+  BOOST_CHECK_EQUAL(batcher.GroupCount(), 1);
+  BOOST_CHECK(!a.IsBatched());
+  BOOST_CHECK(b.IsBatched());
+  BOOST_CHECK(c.IsBatched());
+}
+
+BOOST_AUTO_TEST_CASE(changed_settings) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  const FixtureType &rgb =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::RgbawUv);
+  FixtureControl &a = AddControl(management, rgb, 0);
+  FixtureControl &b = AddControl(management, rgb, 1);
+
+  FilterBatcher batcher;
+  batcher.Compile({&a, &b});
+  BOOST_CHECK_EQUAL(batcher.GroupCount(), 1);
+
+  // Changing the settings of a filter of a batched control falls back to
+  // unbatched mixing, so that the control does not use the settings of
+  // the other control
+  const size_t show_generation = Controllable::ShowGeneration();
+  for (const std::unique_ptr<Filter> &filter : b.Filters()) {
+    if (RgbFilter *rgb_filter = dynamic_cast<RgbFilter *>(filter.get()))
+      rgb_filter->SetMode(RgbFilterMode::Accurate);
+  }
+  BOOST_CHECK_NE(Controllable::ShowGeneration(), show_generation);
+  for (size_t input = 0; input != b.NInputs(); ++input)
+    b.InputValue(input) = ControlValue::Max();
+  const std::vector<std::vector<unsigned>> expected = MixUnbatched({&b});
+  for (size_t input = 0; input != b.NInputs(); ++input)
+    b.InputValue(input) = ControlValue::Max();
+  batcher.Mix();
+  BOOST_CHECK(batcher.IsDirty());
+  for (size_t i = 0; i != expected[0].size(); ++i)
+    BOOST_CHECK_EQUAL(b.FunctionValues()[i].UInt(), expected[0][i]);
+
+  batcher.Compile({&a, &b});
+  BOOST_CHECK(!batcher.IsDirty());
+  BOOST_CHECK_EQUAL(batcher.GroupCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(performance, *boost::unit_test::disabled()) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  const FixtureType &fixture_type =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::RgbawUv);
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 2000; ++i)
+    controls.emplace_back(&AddControl(management, fixture_type, i));
+  FilterBatcher batcher;
+  batcher.Compile(controls);
+  constexpr size_t n_frames = 1000;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame != n_frames; ++frame) batcher.Mix();
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  BOOST_TEST_MESSAGE("Batched filter chain of 2000 fixtures: "
+                     << duration.count() * 1e3 / n_frames << " ms per frame");
+  BOOST_CHECK(controls.front()->FunctionValues()[0].UInt() <=
+              ControlValue::MaxUInt());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 #include "tests/theatre/filters/outputexamples.h"
 
 #include <algorithm>
+#include <array>
 
 #include <boost/test/unit_test.hpp>
 
@@ -158,4 +159,51 @@ BOOST_AUTO_TEST_CASE(macro_with_master) {
   BOOST_CHECK_EQUAL(output[1].ToUChar(), 255);
 }
 
+BOOST_AUTO_TEST_CASE(macro_table) {
+  // Compares the table lookup with a direct search of the colour map
+  std::vector<FixtureModeFunction> functions =
+      MakeFunctionList({FunctionType::ColorMacro, FunctionType::Master});
+  std::vector<ColorRangeParameters::Range>& ranges =
+      functions.front().GetColorRangeParameters().GetRanges();
+  ranges.emplace_back(0, 10, std::optional<Color>());
+  ranges.emplace_back(10, 20, Color::RedC());
+  ranges.emplace_back(20, 30, Color::GreenC());
+  ranges.emplace_back(30, 40, Color::BlueC());
+  ranges.emplace_back(40, 50, Color::Amber());
+  ranges.emplace_back(50, 60, Color::White());
+  ranges.emplace_back(60, 256, Color{255, 0, 255});
+  std::vector<Color> colors;
+  for (const ColorRangeParameters::Range& range : ranges)
+    colors.emplace_back(range.color ? *range.color : Color::Black());
+  const glight::system::ColorMap color_map(colors, 8);
+
+  RgbFilter filter;
+  filter.SetOutputTypes(std::move(functions));
+  std::vector<ControlValue> output(2);
+  unsigned seed = 1;
+  for (size_t i = 0; i != 10000; ++i) {
+    std::array<unsigned, 3> rgb;
+    for (unsigned& value : rgb) {
+      seed = seed * 1103515245 + 12345;
+      value = (seed >> 4) % (kFull + 1);
+    }
+    if (i % 7 == 0) rgb[i % 3] = 0;
+    filter.Apply({ControlValue(rgb[0]), ControlValue(rgb[1]),
+                  ControlValue(rgb[2])},
+                 output);
+    const unsigned m = std::max({rgb[0], rgb[1], rgb[2]});
+    const Color color(
+        ControlValue(ControlValue::Fraction(rgb[0], m)).ToUChar(),
+        ControlValue(ControlValue::Fraction(rgb[1], m)).ToUChar(),
+        ControlValue(ControlValue::Fraction(rgb[2], m)).ToUChar());
+    const ColorRangeParameters::Range& range =
+        ranges[color_map.GetIndex(color)];
+    BOOST_CHECK_EQUAL(
+        output[0].UInt(),
+        ControlValue::FromUChar((range.input_min + range.input_max) / 2)
+            .UInt());
+    BOOST_CHECK_EQUAL(output[1].UInt(), m);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#include "theatre/beatclock.h"
+#include "theatre/timing.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace glight::theatre;
+
+BOOST_AUTO_TEST_SUITE(beat_clock)
+
+BOOST_AUTO_TEST_CASE(no_beats) {
+  const BeatClock clock;
+  BOOST_CHECK_EQUAL(clock.BeatValue(0.0), 0.0);
+  BOOST_CHECK_EQUAL(clock.BeatValue(1000.0), 0.0);
+  BOOST_CHECK_EQUAL(clock.BeatDuration(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(regular_beats) {
+  BeatClock clock;
+  clock.AddBeat(1000.0);
+  // Without a tempo, the position is not extrapolated
+  BOOST_CHECK_EQUAL(clock.BeatValue(1200.0), 1.0);
+  clock.AddBeat(1500.0);
+  BOOST_CHECK_CLOSE(clock.BeatDuration(), 500.0, 1e-6);
+  BOOST_CHECK_CLOSE(clock.BeatValue(1500.0), 2.0, 1e-6);
+  // In between frames, the position follows the tempo
+  BOOST_CHECK_CLOSE(clock.BeatValue(1612.5), 2.225, 1e-6);
+  BOOST_CHECK_CLOSE(clock.BeatValue(1999.0), 2.998, 1e-6);
+  clock.AddBeat(2000.0);
+  BOOST_CHECK_CLOSE(clock.BeatValue(2250.0), 3.5, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(irregular_beats) {
+  BeatClock clock;
+  clock.AddBeat(0.0);
+  clock.AddBeat(500.0);
+  // A missed beat is counted when the next beat arrives
+  clock.AddBeat(1500.0);
+  BOOST_CHECK_CLOSE(clock.BeatValue(1500.0), 4.0, 1e-6);
+  BOOST_CHECK_CLOSE(clock.BeatDuration(), 500.0, 1e-6);
+  // A late beat moves the position back, but not before the whole beat
+  BOOST_CHECK_CLOSE(clock.BeatValue(2100.0), 5.2, 1e-6);
+  clock.AddBeat(2100.0);
+  BOOST_CHECK_CLOSE(clock.BeatValue(2100.0), 5.0, 1e-6);
+  // ...and slows the tempo down
+  BOOST_CHECK_GT(clock.BeatDuration(), 500.0);
+  BOOST_CHECK_LT(clock.BeatDuration(), 600.0);
+  // An early beat moves the position forward
+  const double duration = clock.BeatDuration();
+  clock.AddBeat(2100.0 + duration * 0.8);
+  BOOST_CHECK_CLOSE(clock.BeatValue(2100.0 + duration * 0.8), 6.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(interrupted_music) {
+  BeatClock clock;
+  clock.AddBeat(0.0);
+  clock.AddBeat(500.0);
+  // The position stops a few beats after the last beat
+  BOOST_CHECK_CLOSE(clock.BeatValue(2500.0), 6.0, 1e-6);
+  BOOST_CHECK_CLOSE(clock.BeatValue(10000.0), 6.0, 1e-6);
+  clock.AddBeat(10000.0);
+  BOOST_CHECK_CLOSE(clock.BeatValue(10000.0), 7.0, 1e-6);
+  // The tempo is measured again
+  BOOST_CHECK_EQUAL(clock.BeatDuration(), 0.0);
+  BOOST_CHECK_CLOSE(clock.BeatValue(10200.0), 7.0, 1e-6);
+  clock.AddBeat(10400.0);
+  BOOST_CHECK_CLOSE(clock.BeatDuration(), 400.0, 1e-6);
+  BOOST_CHECK_CLOSE(clock.BeatValue(10500.0), 8.25, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(timing_at_beat) {
+  const Timing timing(1030.0, 5, 2.06, 0, 0, 500.0);
+  // The beat of 2.0 was 0.06 beats before this frame
+  const Timing at_beat = timing.AtBeat(2.0);
+  BOOST_CHECK_CLOSE(at_beat.TimeInMS(), 1000.0, 1e-6);
+  BOOST_CHECK_EQUAL(at_beat.BeatValue(), 2.0);
+  BOOST_CHECK_EQUAL(at_beat.TimestepNumber(), 5);
+  // Without tempo, the time is not changed
+  const Timing no_tempo(1030.0, 5, 2.0, 0, 0);
+  BOOST_CHECK_EQUAL(no_tempo.AtBeat(2.0).TimeInMS(), 1030.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,80 @@
+#include "theatre/channeloccupancy.h"
+
+#include <boost/test/unit_test.hpp>
+
+using glight::theatre::ChannelOccupancy;
+using glight::theatre::DmxChannel;
+
+BOOST_AUTO_TEST_SUITE(channel_occupancy)
+
+BOOST_AUTO_TEST_CASE(empty) {
+  const ChannelOccupancy occupancy;
+  BOOST_CHECK_EQUAL(occupancy.UniverseCount(), 0);
+  BOOST_CHECK(!occupancy.HighestChannel(0));
+  BOOST_CHECK(!occupancy.IsUsed(DmxChannel(0, 0)));
+  BOOST_CHECK(occupancy.IsFree(DmxChannel(0, 3), 512));
+  BOOST_CHECK(!occupancy.IsFree(DmxChannel(1, 3), 512));
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 512), 0);
+  BOOST_CHECK(!occupancy.FirstFreeSpan(0, 513));
+}
+
+BOOST_AUTO_TEST_CASE(add_and_remove) {
+  ChannelOccupancy occupancy;
+  occupancy.Add(DmxChannel(10, 1));
+  occupancy.Add(DmxChannel(200, 1));
+  BOOST_CHECK_EQUAL(occupancy.UniverseCount(), 2);
+  BOOST_CHECK(!occupancy.HighestChannel(0));
+  BOOST_CHECK_EQUAL(*occupancy.HighestChannel(1), 200);
+  BOOST_CHECK(occupancy.IsUsed(DmxChannel(10, 1)));
+  BOOST_CHECK(!occupancy.IsUsed(DmxChannel(10, 0)));
+
+  occupancy.Add(DmxChannel(200, 1));
+  BOOST_CHECK_EQUAL(occupancy.UseCount(DmxChannel(200, 1)), 2);
+  BOOST_CHECK_EQUAL(occupancy.SharedChannelCount(), 1);
+  occupancy.Remove(DmxChannel(200, 1));
+  BOOST_CHECK_EQUAL(occupancy.SharedChannelCount(), 0);
+  BOOST_CHECK_EQUAL(*occupancy.HighestChannel(1), 200);
+  occupancy.Remove(DmxChannel(200, 1));
+  BOOST_CHECK_EQUAL(*occupancy.HighestChannel(1), 10);
+  occupancy.Remove(DmxChannel(10, 1));
+  BOOST_CHECK(!occupancy.HighestChannel(1));
+
+  occupancy.Add(DmxChannel(511, 0));
+  BOOST_CHECK_EQUAL(*occupancy.HighestChannel(0), 511);
+  occupancy.Clear();
+  BOOST_CHECK_EQUAL(occupancy.UniverseCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(free_spans) {
+  ChannelOccupancy occupancy;
+  // Use channels 0-59, 62-129 and 140-511, leaving spans of 2 and 10
+  for (unsigned channel = 0; channel != 512; ++channel) {
+    if ((channel < 60 || channel > 61) && (channel < 130 || channel > 139))
+      occupancy.Add(DmxChannel(channel, 0));
+  }
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 1), 60);
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 2), 60);
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 3), 130);
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 10), 130);
+  BOOST_CHECK(!occupancy.FirstFreeSpan(0, 11));
+  BOOST_CHECK(occupancy.IsFree(DmxChannel(130, 0), 10));
+  BOOST_CHECK(!occupancy.IsFree(DmxChannel(129, 0), 2));
+  BOOST_CHECK(!occupancy.IsFree(DmxChannel(130, 0), 11));
+
+  // Use 0-59, 62-99 and 120-139, leaving spans that cross word boundaries
+  for (unsigned channel = 100; channel != 512; ++channel) {
+    if (channel < 130 || channel > 139)
+      occupancy.Remove(DmxChannel(channel, 0));
+  }
+  for (unsigned channel = 120; channel != 140; ++channel) {
+    occupancy.Add(DmxChannel(channel, 0));
+  }
+  BOOST_CHECK_EQUAL(*occupancy.HighestChannel(0), 139);
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 3), 100);
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 21), 140);
+  BOOST_CHECK_EQUAL(*occupancy.FirstFreeSpan(0, 372), 140);
+  BOOST_CHECK(!occupancy.FirstFreeSpan(0, 373));
+  BOOST_CHECK(occupancy.IsFree(DmxChannel(140, 0), 372));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,226 @@
+#include "system/settings.h"
+
+#include "theatre/channelwriter.h"
+#include "theatre/fixturecontrol.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/theatre.h"
+#include "theatre/timing.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <span>
+#include <vector>
+
+using namespace glight::theatre;
+
+namespace {
+
+/**
+ * Adds a fixture type with a single mode with @p n_cells RGB cells on
+ * consecutive channels.
+ */
+FixtureMode &AddPixelBar(Theatre &theatre, size_t n_cells) {
+  FixtureType &type = *theatre.AddFixtureType(StockFixture::Rgb);
+  FixtureMode &mode = type.Modes().front();
+  std::vector<FixtureModeFunction> functions;
+  for (size_t i = 0; i != n_cells * 3; ++i) {
+    const FunctionType function_type = i % 3 == 0   ? FunctionType::Red
+                                       : i % 3 == 1 ? FunctionType::Green
+                                                    : FunctionType::Blue;
+    functions.emplace_back(function_type, i,
+                           glight::system::OptionalNumber<size_t>(), 0);
+  }
+  mode.SetFunctions(std::move(functions));
+  return mode;
+}
+
+void CheckSameAsFixtureControls(const std::vector<FixtureControl *> &controls,
+                                const ChannelWriter &writer) {
+  for (unsigned universe = 0; universe != 3; ++universe) {
+    std::vector<unsigned> expected(512, 0);
+    for (const FixtureControl *control : controls)
+      control->GetChannelValues(expected.data(), universe);
+    std::vector<unsigned> result(512, 0);
+    writer.Write(universe, result.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                  expected.begin(), expected.end());
+  }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(channel_writer)
+
+BOOST_AUTO_TEST_CASE(same_as_fixture_control) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  const FixtureMode &rgb =
+      theatre.AddFixtureType(StockFixture::Rgb)->Modes().front();
+  const FixtureMode &light =
+      theatre.AddFixtureType(StockFixture::Light)->Modes().front();
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 200; ++i) {
+    Fixture &fixture = *theatre.AddFixture(i % 3 == 0 ? light : rgb);
+    controls.emplace_back(static_cast<FixtureControl *>(
+        management.AddFixtureControl(fixture).Get()));
+  }
+  // Make some fixtures 16 bit and let a few overlap
+  for (size_t i = 0; i < 200; i += 7) {
+    Fixture &fixture = controls[i]->GetFixture();
+    FixtureFunction &function = *fixture.Functions().front();
+    const DmxChannel main_channel = function.MainChannel();
+    function.SetChannel(main_channel,
+                        DmxChannel(500 - i / 7, main_channel.Universe()));
+    theatre.NotifyDmxChange(fixture);
+  }
+  controls[20]->GetFixture().SetChannel(DmxChannel(5, 1));
+
+  const Timing timing(0.0, 0, 0, 0, 0);
+  for (size_t i = 0; i != controls.size(); ++i) {
+    for (size_t input = 0; input != controls[i]->NInputs(); ++input) {
+      controls[i]->InputValue(input) =
+          ControlValue((i * 7919 + input * 104729) % ControlValue::MaxUInt());
+    }
+    controls[i]->Mix(timing, true);
+  }
+
+  ChannelWriter writer;
+  writer.Compile(controls);
+  size_t n_functions = 0;
+  for (const FixtureControl *control : controls)
+    n_functions += control->GetFixture().Functions().size();
+  BOOST_CHECK_EQUAL(writer.RecordCount(), n_functions);
+  CheckSameAsFixtureControls(controls, writer);
+}
+
+BOOST_AUTO_TEST_CASE(pixel_bar_blocks) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureMode &mode = AddPixelBar(theatre, 32);
+  // A response curve and a fine channel break up the block
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  functions[40].SetCurve(ResponseCurve::Gamma(2.2));
+  functions[60].SetFineChannelOffset(
+      glight::system::OptionalNumber<size_t>(96));
+  mode.SetFunctions(std::move(functions));
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 4; ++i) {
+    Fixture &fixture = *theatre.AddFixture(mode);
+    controls.emplace_back(static_cast<FixtureControl *>(
+        management.AddFixtureControl(fixture).Get()));
+  }
+  // This fixture crosses a universe boundary
+  controls[3]->GetFixture().SetChannel(DmxChannel(480, 1));
+  // Reversed channels can't be written as a block
+  Fixture &reversed = controls[2]->GetFixture();
+  for (size_t i = 0; i != 96; ++i)
+    reversed.Functions()[i]->SetChannel(DmxChannel(400 - i, 0));
+  theatre.NotifyDmxChange(reversed);
+
+  const Timing timing(0.0, 0, 0, 0, 0);
+  for (size_t i = 0; i != controls.size(); ++i) {
+    for (size_t input = 0; input != controls[i]->NInputs(); ++input) {
+      controls[i]->InputValue(input) =
+          ControlValue((i * 7919 + input * 104729) % ControlValue::MaxUInt());
+    }
+    controls[i]->Mix(timing, true);
+  }
+
+  ChannelWriter writer;
+  writer.Compile(controls);
+  BOOST_CHECK_EQUAL(writer.RecordCount(), 4 * 96);
+  // Fixture 0 and 1 each have 3 blocks: before the curve, between the
+  // curve and the fine channel, and after the fine channel. Fixture 3 has
+  // an additional split at the universe boundary.
+  BOOST_CHECK_EQUAL(writer.BlockCount(), 3 + 3 + 4);
+  CheckSameAsFixtureControls(controls, writer);
+}
+
+BOOST_AUTO_TEST_CASE(pixel_block) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureType &type = *theatre.AddFixtureType(StockFixture::RgbPixelBar);
+  FixtureMode &curved = type.AddMode();
+  std::vector<FixtureModeFunction> functions = type.Modes().front().Functions();
+  functions.front().SetCurve(ResponseCurve::Gamma(2.2));
+  functions.emplace_back(FunctionType::Master, 96,
+                         glight::system::OptionalNumber<size_t>(), 0);
+  curved.SetFunctions(std::move(functions));
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 4; ++i) {
+    Fixture &fixture =
+        *theatre.AddFixture(i % 2 == 0 ? type.Modes().front() : curved);
+    controls.emplace_back(static_cast<FixtureControl *>(
+        management.AddFixtureControl(fixture).Get()));
+  }
+  // This block wraps around the end of the universe
+  controls[3]->GetFixture().SetChannel(DmxChannel(480, 1));
+  BOOST_CHECK_EQUAL(controls[0]->PixelValues(0).size(), 96);
+  BOOST_CHECK_EQUAL(controls[1]->PixelValues(1).size(), 0);
+  BOOST_CHECK_EQUAL(controls[1]->PixelBlockFunction(0), 0);
+  BOOST_CHECK_EQUAL(controls[1]->PixelBlockFunction(1), 2);
+
+  const Timing timing(0.0, 0, 0, 0, 0);
+  for (size_t i = 0; i != controls.size(); ++i) {
+    for (size_t input = 0; input != controls[i]->NInputs(); ++input) {
+      controls[i]->InputValue(input) = ControlValue((i + 1) * 7919);
+    }
+    const std::span<ControlValue> cells = controls[i]->PixelValues(0);
+    for (size_t j = 0; j != cells.size(); ++j) {
+      cells[j] =
+          ControlValue((i * 7919 + j * 104729) % ControlValue::MaxUInt());
+    }
+    controls[i]->Mix(timing, true);
+  }
+
+  ChannelWriter writer;
+  writer.Compile(controls);
+  BOOST_CHECK_EQUAL(writer.RecordCount(), 4 * 96 + 2);
+  // One record per block, plus one for the wrap of the last fixture
+  BOOST_CHECK_EQUAL(writer.PixelRecordCount(), 5);
+  CheckSameAsFixtureControls(controls, writer);
+
+  std::vector<unsigned> values(512, 0);
+  writer.Write(0, values.data());
+  BOOST_CHECK_EQUAL(values[5], 7919 + (5 * 104729) % ControlValue::MaxUInt());
+
+  controls[0]->ClearPixelValues();
+  std::fill(values.begin(), values.end(), 0);
+  writer.Write(0, values.data());
+  BOOST_CHECK_EQUAL(values[5], 7919);
+}
+
+BOOST_AUTO_TEST_CASE(performance, *boost::unit_test::disabled()) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  const FixtureMode &mode = AddPixelBar(theatre, 32);
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 80; ++i) {
+    Fixture &fixture = *theatre.AddFixture(mode);
+    controls.emplace_back(static_cast<FixtureControl *>(
+        management.AddFixtureControl(fixture).Get()));
+  }
+  ChannelWriter writer;
+  writer.Compile(controls);
+  std::vector<unsigned> values(512);
+  constexpr size_t n_frames = 10000;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame != n_frames; ++frame) {
+    for (unsigned universe = 0; universe != 15; ++universe) {
+      std::fill(values.begin(), values.end(), 0);
+      writer.Write(universe, values.data());
+    }
+  }
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  BOOST_TEST_MESSAGE("Writing 80 pixel bars of 32 cells: "
+                     << duration.count() * 1e6 / n_frames << " us per frame");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
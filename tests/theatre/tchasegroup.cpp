@@ -0,0 +1,158 @@
+#include "theatre/chase.h"
+#include "theatre/chasegroup.h"
+#include "theatre/management.h"
+#include "theatre/timing.h"
+
+#include "theatre/effects/variableeffect.h"
+
+#include "system/settings.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace glight::theatre;
+
+namespace {
+
+/** A chase over a number of variables, which can report its active step. */
+struct TestChase {
+  explicit TestChase(size_t n_steps) {
+    for (size_t i = 0; i != n_steps; ++i) {
+      variables.emplace_back(std::make_unique<VariableEffect>());
+      chase.GetSequence().Add(*variables.back(), 0);
+    }
+    chase.GetTrigger().SetDelayInMs(300.0);
+    chase.GetTransition().SetLengthInMs(0.0);
+    chase.InputValue(0) = ControlValue::Max();
+  }
+
+  /** Index of the variable that is on, or -1 if none is. */
+  int ActiveStep(double time) {
+    for (std::unique_ptr<VariableEffect> &variable : variables)
+      variable->InputValue(0) = ControlValue::Zero();
+    chase.Mix(Timing::MakeForDebug(time), true);
+    int active = -1;
+    for (size_t i = 0; i != variables.size(); ++i) {
+      if (variables[i]->InputValue(0)) {
+        BOOST_CHECK_EQUAL(active, -1);
+        active = i;
+      }
+    }
+    return active;
+  }
+
+  std::vector<std::unique_ptr<VariableEffect>> variables;
+  Chase chase;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(chase_group)
+
+BOOST_AUTO_TEST_CASE(without_group) {
+  TestChase test(3);
+  BOOST_CHECK(test.chase.GetGroup() == nullptr);
+  BOOST_CHECK_EQUAL(test.ActiveStep(0.0), 0);
+  BOOST_CHECK_EQUAL(test.ActiveStep(299.0), 0);
+  BOOST_CHECK_EQUAL(test.ActiveStep(300.0), 1);
+  BOOST_CHECK_EQUAL(test.ActiveStep(650.0), 2);
+  BOOST_CHECK_EQUAL(test.ActiveStep(950.0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(shared_tempo) {
+  ChaseGroup group;
+  group.SetStepDuration(100.0);
+  TestChase a(3);
+  TestChase b(4);
+  // The own delay of a chase does not set the tempo in a group
+  b.chase.GetTrigger().SetDelayInMs(1234.0);
+  a.chase.SetGroup(&group);
+  b.chase.SetGroup(&group);
+  BOOST_CHECK_EQUAL(group.Chases().size(), 2);
+
+  group.Advance(5000.0);
+  BOOST_CHECK_EQUAL(a.ActiveStep(5000.0), 0);
+  BOOST_CHECK_EQUAL(b.ActiveStep(5000.0), 0);
+  group.Advance(5150.0);
+  BOOST_CHECK_EQUAL(a.ActiveStep(5150.0), 1);
+  BOOST_CHECK_EQUAL(b.ActiveStep(5150.0), 1);
+  group.Advance(5350.0);
+  BOOST_CHECK_EQUAL(a.ActiveStep(5350.0), 0);
+  BOOST_CHECK_EQUAL(b.ActiveStep(5350.0), 3);
+
+  // Changing the tempo continues from the current position
+  group.SetStepDuration(200.0);
+  BOOST_CHECK_CLOSE(group.Position(), 3.5, 1e-6);
+  group.Advance(5450.0);
+  BOOST_CHECK_CLOSE(group.Position(), 4.0, 1e-6);
+  BOOST_CHECK_EQUAL(a.ActiveStep(5450.0), 1);
+  BOOST_CHECK_EQUAL(b.ActiveStep(5450.0), 0);
+
+  group.Restart();
+  BOOST_CHECK_EQUAL(a.ActiveStep(5450.0), 0);
+  BOOST_CHECK_EQUAL(b.ActiveStep(5450.0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(tap) {
+  ChaseGroup group;
+  group.Advance(0.0);
+  group.Advance(1400.0);
+  BOOST_CHECK_CLOSE(group.Position(), 1.4, 1e-6);
+  // A single tap puts a step boundary on the tap
+  group.Tap(1400.0);
+  BOOST_CHECK_CLOSE(group.Position(), 1.0, 1e-6);
+  BOOST_CHECK_CLOSE(group.StepDuration(), 1000.0, 1e-6);
+  // A second tap sets the tempo
+  group.Tap(1900.0);
+  BOOST_CHECK_CLOSE(group.StepDuration(), 500.0, 1e-6);
+  BOOST_CHECK_CLOSE(group.Position(), 2.0, 1e-6);
+  group.Advance(2150.0);
+  BOOST_CHECK_CLOSE(group.Position(), 2.5, 1e-6);
+  // Time that goes back does not change the position
+  group.Advance(2100.0);
+  BOOST_CHECK_CLOSE(group.Position(), 2.5, 1e-6);
+  // Taps that are far apart do not set the tempo
+  group.Tap(20000.0);
+  BOOST_CHECK_CLOSE(group.StepDuration(), 500.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(lifetime) {
+  auto group = std::make_unique<ChaseGroup>();
+  auto a = std::make_unique<TestChase>(2);
+  TestChase b(2);
+  a->chase.SetGroup(group.get());
+  b.chase.SetGroup(group.get());
+  a.reset();
+  BOOST_REQUIRE_EQUAL(group->Chases().size(), 1);
+  BOOST_CHECK_EQUAL(group->Chases()[0], &b.chase);
+  group.reset();
+  BOOST_CHECK(b.chase.GetGroup() == nullptr);
+  BOOST_CHECK_EQUAL(b.ActiveStep(0.0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(management) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  ChaseGroup &group = management.AddChaseGroup();
+  Chase &chase = *management.AddChasePtr();
+  management.SetChaseGroup(chase, &group);
+  BOOST_CHECK_EQUAL(chase.GetGroup(), &group);
+  management.SetChaseGroupStepDuration(group, 250.0);
+  BOOST_CHECK_EQUAL(group.StepDuration(), 250.0);
+  group.Advance(0.0);
+  group.Advance(600.0);
+  management.RestartChaseGroup(group);
+  BOOST_CHECK_EQUAL(group.Position(), 0.0);
+  // A tap puts a step boundary on the current time
+  management.TapChaseGroup(group);
+  BOOST_CHECK_EQUAL(group.Position(), std::round(group.Position()));
+  BOOST_CHECK_EQUAL(management.ChaseGroups().size(), 1);
+  management.RemoveChaseGroup(group);
+  BOOST_CHECK(management.ChaseGroups().empty());
+  BOOST_CHECK(chase.GetGroup() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
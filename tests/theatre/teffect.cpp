@@ -0,0 +1,189 @@
+#include "theatre/effect.h"
+
+#include "system/settings.h"
+
+#include "theatre/effects/colortemperatureeffect.h"
+#include "theatre/effects/constantvalueeffect.h"
+#include "theatre/effects/variableeffect.h"
+#include "theatre/filters/automasterfilter.h"
+#include "theatre/fixturecontrol.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/properties/propertyset.h"
+#include "theatre/theatre.h"
+#include "theatre/timing.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+namespace glight::theatre {
+
+BOOST_AUTO_TEST_SUITE(effect)
+
+BOOST_AUTO_TEST_CASE(fan_out) {
+  ConstantValueEffect effect;
+  effect.SetValue(1000);
+  std::vector<std::unique_ptr<VariableEffect>> targets;
+  for (size_t i = 0; i != 10; ++i) {
+    targets.emplace_back(std::make_unique<VariableEffect>());
+    effect.AddConnection(*targets.back(), i % 3);
+  }
+  Timing timing;
+  effect.Mix(timing, true);
+  for (size_t i = 0; i != targets.size(); ++i) {
+    BOOST_CHECK_EQUAL(targets[i]->InputValue(i % 3).UInt(), 1000);
+  }
+  // Outputs are summed with the existing input value, like MixInput()
+  effect.Mix(timing, true);
+  for (size_t i = 0; i != targets.size(); ++i) {
+    BOOST_CHECK_EQUAL(targets[i]->InputValue(i % 3).UInt(), 2000);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(changed_connections) {
+  ConstantValueEffect effect;
+  effect.SetValue(1000);
+  VariableEffect a;
+  VariableEffect b;
+  Timing timing;
+  effect.AddConnection(a, 0);
+  effect.Mix(timing, true);
+  BOOST_CHECK_EQUAL(a.InputValue(0).UInt(), 1000);
+
+  effect.AddConnection(b, 1);
+  effect.Mix(timing, true);
+  BOOST_CHECK_EQUAL(a.InputValue(0).UInt(), 2000);
+  BOOST_CHECK_EQUAL(b.InputValue(1).UInt(), 1000);
+
+  effect.RemoveConnection(a, 0);
+  effect.Mix(timing, true);
+  BOOST_CHECK_EQUAL(a.InputValue(0).UInt(), 2000);
+  BOOST_CHECK_EQUAL(b.InputValue(1).UInt(), 2000);
+
+  // Deleting a connected controllable removes the connection
+  {
+    VariableEffect c;
+    effect.AddConnection(c, 0);
+    effect.Mix(timing, true);
+    BOOST_CHECK_EQUAL(c.InputValue(0).UInt(), 1000);
+  }
+  BOOST_CHECK_EQUAL(effect.Connections().size(), 1);
+  effect.Mix(timing, true);
+  BOOST_CHECK_EQUAL(b.InputValue(1).UInt(), 4000);
+}
+
+BOOST_AUTO_TEST_CASE(reallocated_inputs) {
+  const system::Settings settings;
+  Management management(settings);
+  const FixtureType &type =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::Rgb);
+  Fixture &fixture = *management.GetTheatre().AddFixture(type.Modes().front());
+  FixtureControl &control = static_cast<FixtureControl &>(
+      *management.AddFixtureControl(fixture).Get());
+  ConstantValueEffect effect;
+  effect.SetValue(1000);
+  effect.AddConnection(control, 1);
+  Timing timing;
+  effect.Mix(timing, true);
+  BOOST_CHECK_EQUAL(control.InputValue(1).UInt(), 1000);
+
+  // Adding a filter reallocates the input values of the control
+  const size_t generation = Controllable::InputGeneration();
+  control.AddFilter(std::make_unique<AutoMasterFilter>());
+  BOOST_CHECK_NE(Controllable::InputGeneration(), generation);
+  effect.Mix(timing, true);
+  BOOST_CHECK_EQUAL(control.InputValue(1).UInt(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(property_changes) {
+  ConstantValueEffect effect;
+  ConstantValueEffect other;
+  std::unique_ptr<PropertySet> properties = PropertySet::Make(effect);
+  Property &value = properties->GetProperty("value");
+  const size_t show_generation = Controllable::ShowGeneration();
+  const size_t generation = effect.PropertyGeneration();
+  const size_t other_generation = other.PropertyGeneration();
+
+  // Reading a property changes nothing
+  properties->GetControlValue(value);
+  BOOST_CHECK_EQUAL(Controllable::ShowGeneration(), show_generation);
+  BOOST_CHECK_EQUAL(effect.PropertyGeneration(), generation);
+
+  properties->SetControlValue(value, 1000);
+  BOOST_CHECK_NE(Controllable::ShowGeneration(), show_generation);
+  BOOST_CHECK_NE(effect.PropertyGeneration(), generation);
+  BOOST_CHECK_EQUAL(other.PropertyGeneration(), other_generation);
+}
+
+BOOST_AUTO_TEST_CASE(color_temperature_table) {
+  const system::Settings settings;
+  Management management(settings);
+  const FixtureType &type =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::Rgb);
+  Fixture &fixture = *management.GetTheatre().AddFixture(type.Modes().front());
+  FixtureControl &control = static_cast<FixtureControl &>(
+      *management.AddFixtureControl(fixture).Get());
+  ColorTemperatureEffect effect;
+  // Connect to the red and blue inputs of the control
+  effect.AddConnection(control, 0);
+  effect.AddConnection(control, 2);
+  effect.InputValue(1) = ControlValue::Max();
+
+  const auto check = [&](unsigned input, unsigned temperature) {
+    control.InputValue(0) = ControlValue::Zero();
+    control.InputValue(2) = ControlValue::Zero();
+    effect.InputValue(0) = ControlValue(input);
+    effect.Mix(Timing(), true);
+    const Color rgb = system::TemperatureToRgb(temperature);
+    const ControlValue max = ControlValue::Max();
+    BOOST_CHECK_EQUAL(control.InputValue(0).UInt(),
+                      (ControlValue(rgb.Red() << 16) * max).UInt());
+    BOOST_CHECK_EQUAL(control.InputValue(2).UInt(),
+                      (ControlValue(rgb.Blue() << 16) * max).UInt());
+  };
+  check(0, 1500);
+  check(ControlValue::MaxUInt(), 1500 + ((13500 * 1023) >> 10));
+  // Inputs can add up to more than the maximum
+  check(ControlValue::MaxUInt() * 2, 1500 + ((13500 * 1023) >> 10));
+  check(~0u, 1500 + ((13500 * 1023) >> 10));
+
+  // A changed range is picked up through the property set
+  std::unique_ptr<PropertySet> properties = PropertySet::Make(effect);
+  properties->SetInteger(properties->GetProperty("min-temperature"), 6000);
+  check(0, 6000);
+  effect.SetMaximumTemperature(7000);
+  check(512 << 14, 6500);
+}
+
+BOOST_AUTO_TEST_CASE(performance, *boost::unit_test::disabled()) {
+  const system::Settings settings;
+  Management management(settings);
+  const FixtureType &type =
+      *management.GetTheatre().AddFixtureTypePtr(StockFixture::Light);
+  ConstantValueEffect effect;
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 300; ++i) {
+    Fixture &fixture =
+        *management.GetTheatre().AddFixture(type.Modes().front());
+    FixtureControl &control = static_cast<FixtureControl &>(
+        *management.AddFixtureControl(fixture).Get());
+    effect.AddConnection(control, 0);
+    controls.emplace_back(&control);
+  }
+  Timing timing;
+  constexpr size_t n_frames = 100000;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame != n_frames; ++frame) {
+    effect.Mix(timing, true);
+    controls.front()->InputValue(0) = ControlValue(0);
+  }
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  BOOST_TEST_MESSAGE("Effect with 300 connections: "
+                     << duration.count() * 1e6 / n_frames << " us per mix");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace glight::theatre
@@ -0,0 +1,103 @@
+#include "theatre/fadeprocessor.h"
+#include "theatre/sourcevalue.h"
+
+#include "theatre/effects/fadeeffect.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace glight::theatre;
+
+BOOST_AUTO_TEST_SUITE(fade_processor)
+
+BOOST_AUTO_TEST_CASE(immediate_and_clamped) {
+  FadeEffect effect;
+  FadeProcessor processor;
+  SourceValue sv(effect, 0);
+  sv.SetFadeProcessor(processor);
+
+  processor.Process(0.1);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 0);
+
+  // A zero fade speed moves immediately, even when only the target is set
+  sv.A().SetTargetValue(1000);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 1);
+  processor.Process(0.1);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 0);
+  BOOST_CHECK_EQUAL(sv.A().Value().UInt(), 1000);
+
+  // Half a second with a speed of one full range per second
+  sv.B().Set(ControlValue::MaxUInt(), 1.0);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 1);
+  processor.Process(0.5);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 1);
+  BOOST_CHECK_EQUAL(sv.B().Value().UInt(), (ControlValue::MaxUInt() + 1) / 2);
+  processor.Process(0.75);
+  BOOST_CHECK_EQUAL(sv.B().Value().UInt(), ControlValue::MaxUInt());
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 0);
+
+  sv.CrossFader().Set(ControlValue::MaxUInt() / 2);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 0);
+  sv.CrossFader().Set(100, 4.0);
+  processor.Process(0.1);
+  BOOST_CHECK_EQUAL(sv.CrossFader().Value().UInt(),
+                    ControlValue::MaxUInt() / 2 - 6710886);
+  processor.Process(1.0);
+  BOOST_CHECK_EQUAL(sv.CrossFader().Value().UInt(), 100);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(same_as_apply_fade) {
+  FadeEffect effect;
+  FadeProcessor processor;
+  std::vector<std::unique_ptr<SourceValue>> source_values;
+  std::vector<SingleSourceValue> references;
+  for (size_t i = 0; i != 50; ++i) {
+    SourceValue &sv =
+        *source_values.emplace_back(std::make_unique<SourceValue>(effect, 0));
+    sv.SetFadeProcessor(processor);
+    sv.A().Set((i * 7919u) % ControlValue::MaxUInt());
+    sv.A().Set((i * 104729u) % ControlValue::MaxUInt(), 0.01 * i);
+    sv.B().Set(ControlValue::MaxUInt() - i * 1000, 0.1);
+    references.emplace_back(sv.A());
+    references.emplace_back(sv.B());
+  }
+  for (double time : {0.01, 0.04, 0.3, 0.02, 2.0}) {
+    processor.Process(time);
+    for (size_t i = 0; i != source_values.size(); ++i) {
+      references[i * 2].ApplyFade(time);
+      references[i * 2 + 1].ApplyFade(time);
+      BOOST_CHECK_EQUAL(source_values[i]->A().Value().UInt(),
+                        references[i * 2].Value().UInt());
+      BOOST_CHECK_EQUAL(source_values[i]->B().Value().UInt(),
+                        references[i * 2 + 1].Value().UInt());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(swap_and_remove) {
+  FadeEffect effect;
+  FadeProcessor processor;
+  auto sv = std::make_unique<SourceValue>(effect, 0);
+  sv->SetFadeProcessor(processor);
+  sv->A().Set(ControlValue::MaxUInt(), 1.0);
+  sv->CrossFader().Set(0);
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 1);
+
+  // Swapping moves the fade to B and inverts the cross fader
+  sv->Swap();
+  processor.Process(0.25);
+  BOOST_CHECK_EQUAL(sv->A().Value().UInt(), 0);
+  BOOST_CHECK_EQUAL(sv->B().Value().UInt(), (ControlValue::MaxUInt() + 1) / 4);
+  BOOST_CHECK_EQUAL(sv->CrossFader().Value().UInt(), ControlValue::MaxUInt());
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 1);
+
+  // A removed value leaves the list
+  sv.reset();
+  BOOST_CHECK_EQUAL(processor.NActiveFades(), 0);
+  processor.Process(0.25);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,11 +8,13 @@
 #include "theatre/timing.h"
 
 #include "theatre/filters/automasterfilter.h"
+#include "theatre/filters/colortemperaturefilter.h"
 #include "theatre/filters/monochromefilter.h"
 #include "theatre/filters/rgbfilter.h"
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
 #include <memory>
 
 using namespace glight::theatre;
@@ -83,4 +85,82 @@ BOOST_AUTO_TEST_CASE(Filters) {
   }
 }
 
+namespace {
+void AddLongFilterChain(FixtureControl &control) {
+  // Filters are added in front, so the inputs pass through the auto master
+  // filter first and through the monochrome filter last.
+  control.AddFilter(std::make_unique<MonochromeFilter>());
+  control.AddFilter(std::make_unique<ColorTemperatureFilter>());
+  control.AddFilter(std::make_unique<RgbFilter>());
+  control.AddFilter(std::make_unique<AutoMasterFilter>());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(FilterChain) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  for (StockFixture stock_fixture :
+       {StockFixture::RgbawUv, StockFixture::Light, StockFixture::Rgb}) {
+    ObservingPtr<FixtureType> fixture_type =
+        management.GetTheatre().AddFixtureTypePtr(stock_fixture);
+    Fixture &fixture =
+        *management.GetTheatre().AddFixture(fixture_type->Modes().front());
+    ObservingPtr<FixtureControl> control =
+        management.AddFixtureControlPtr(fixture);
+    AddLongFilterChain(*control);
+
+    std::vector<ControlValue> values(control->NInputs());
+    for (size_t i = 0; i != control->NInputs(); ++i) {
+      values[i] = ControlValue((i + 1) * (ControlValue::MaxUInt() / 7));
+      control->InputValue(i) = values[i];
+    }
+    const Timing timing(0.0, 0, 0, 0, 0);
+    control->Mix(timing, true);
+
+    // Apply the same chain step by step with the vector interface
+    const std::vector<std::unique_ptr<Filter>> &filters = control->Filters();
+    for (auto iter = filters.rbegin(); iter != filters.rend(); ++iter) {
+      std::vector<ControlValue> output((*iter)->OutputTypes().size());
+      (*iter)->Apply(values, output);
+      values = std::move(output);
+    }
+    BOOST_REQUIRE_EQUAL(values.size(), fixture.Functions().size());
+    for (size_t i = 0; i != values.size(); ++i) {
+      BOOST_CHECK_EQUAL(control->FunctionValues()[i].UInt(),
+                        values[i].UInt());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(performance_filter_chain, *boost::unit_test::disabled()) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  ObservingPtr<FixtureType> fixture_type =
+      management.GetTheatre().AddFixtureTypePtr(StockFixture::RgbawUv);
+  std::vector<FixtureControl *> controls;
+  for (size_t i = 0; i != 2000; ++i) {
+    Fixture &fixture =
+        *management.GetTheatre().AddFixture(fixture_type->Modes().front());
+    FixtureControl &control = *management.AddFixtureControlPtr(fixture);
+    AddLongFilterChain(control);
+    for (size_t input = 0; input != control.NInputs(); ++input) {
+      control.InputValue(input) =
+          ControlValue((i * 7919 + input * 104729) % ControlValue::MaxUInt());
+    }
+    controls.emplace_back(&control);
+  }
+  const Timing timing(0.0, 0, 0, 0, 0);
+  constexpr size_t n_frames = 1000;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t frame = 0; frame != n_frames; ++frame) {
+    for (FixtureControl *control : controls) control->Mix(timing, true);
+  }
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  BOOST_TEST_MESSAGE("Filter chain of 2000 fixtures: "
+                     << duration.count() * 1e3 / n_frames << " ms per frame");
+  BOOST_CHECK(controls.front()->FunctionValues()[0].UInt() <=
+              ControlValue::MaxUInt());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
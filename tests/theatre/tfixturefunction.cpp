@@ -38,4 +38,17 @@ BOOST_AUTO_TEST_CASE(MixChannels_16bit) {
   BOOST_CHECK_EQUAL(channelValues[4], (((1 << 24) - 1) & 0x00FFFF) << 8);
 }
 
+BOOST_AUTO_TEST_CASE(MixChannels_16bit_overflow) {
+  Theatre theatre;
+  FixtureFunction ff("ff test");
+  ff.SetChannel(DmxChannel(3, 0), DmxChannel(4, 0));
+  std::vector<unsigned> channelValues(512, 0);
+  ff.MixChannels((1 << 24) - 0x100, MixStyle::Default, channelValues.data(),
+                 0);
+  ff.MixChannels(0x300, MixStyle::Default, channelValues.data(), 0);
+  // The sum is clipped instead of wrapping the fine channel to zero
+  BOOST_CHECK_EQUAL(channelValues[3], 0xFF0000);
+  BOOST_CHECK_EQUAL(channelValues[4], 0xFFFF00);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -123,6 +123,63 @@ BOOST_AUTO_TEST_CASE(GetAvailableName) {
   TrackablePtr<Folder> d(new Folder("obj2"));
   a->Add(d.GetObserver());
   BOOST_CHECK_EQUAL(a->GetAvailableName("obj"), "obj4");
+
+  b->SetName("renamed");
+  BOOST_CHECK_EQUAL(a->GetAvailableName("obj"), "obj1");
+  a->Remove(*d);
+  BOOST_CHECK_EQUAL(a->GetAvailableName("obj"), "obj1");
+  b->SetName("obj1");
+  BOOST_CHECK_EQUAL(a->GetAvailableName("obj"), "obj2");
+}
+
+BOOST_AUTO_TEST_CASE(NameIndex) {
+  TrackablePtr<Folder> a(new Folder("a"));
+  std::vector<TrackablePtr<Folder>> children;
+  for (size_t i = 0; i != Folder::kIndexThreshold * 2; ++i) {
+    BOOST_CHECK_EQUAL(a->IsIndexed(), i >= Folder::kIndexThreshold);
+    const std::string name = a->GetAvailableName("child");
+    BOOST_CHECK_EQUAL(name, "child" + std::to_string(i + 1));
+    children.emplace_back(new Folder(name));
+    a->Add(children.back().GetObserver());
+  }
+  BOOST_CHECK(a->IsIndexed());
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("child1"), children[0].Get());
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("child20"), children[19].Get());
+  BOOST_CHECK(a->GetChildIfExists("child0") == nullptr);
+  BOOST_CHECK_THROW(a->Add(TrackablePtr<Folder>(new Folder("child3"))
+                               .GetObserver()),
+                    std::exception);
+
+  children[2]->SetName("renamed");
+  BOOST_CHECK(a->GetChildIfExists("child3") == nullptr);
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("renamed"), children[2].Get());
+  BOOST_CHECK_EQUAL(a->FollowRelPath("renamed"), children[2].Get());
+  BOOST_CHECK_EQUAL(a->GetAvailableName("child"), "child3");
+
+  a->Remove(*children[4]);
+  BOOST_CHECK(a->GetChildIfExists("child5") == nullptr);
+  TrackablePtr<Folder> sub(new Folder("sub"));
+  children[5]->Add(sub.GetObserver());
+  BOOST_CHECK_EQUAL(a->FollowDown("child6/sub"), sub.Get());
+
+  Folder::Move(children[6].GetObserver(), *children[7]);
+  BOOST_CHECK(a->GetChildIfExists("child7") == nullptr);
+  BOOST_CHECK_EQUAL(a->FollowRelPath("child8/child7"), children[6].Get());
+
+  // A rename to an existing name does not take over the existing child
+  children[10]->SetName("child10");
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("child10"), children[9].Get());
+  children[10]->SetName("child11");
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("child10"), children[9].Get());
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("child11"), children[10].Get());
+  BOOST_CHECK_THROW(a->Add(TrackablePtr<Folder>(new Folder("child10"))
+                               .GetObserver()),
+                    std::exception);
+  // When the first is renamed away, the other child is found by its name
+  children[11]->SetName("child11");
+  children[10]->SetName("other");
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("child11"), children[11].Get());
+  BOOST_CHECK_EQUAL(a->GetChildIfExists("other"), children[10].Get());
 }
 
 BOOST_AUTO_TEST_CASE(FolderManagement) {
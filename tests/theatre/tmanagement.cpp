@@ -3,6 +3,7 @@
 #include "theatre/fixturetype.h"
 #include "theatre/folder.h"
 #include "theatre/management.h"
+#include "theatre/managementbatch.h"
 #include "theatre/presetcollection.h"
 #include "theatre/sourcevalue.h"
 #include "theatre/theatre.h"
@@ -29,6 +30,16 @@ BOOST_AUTO_TEST_CASE(Destruct) {
   management.StartBeatFinder();
 }
 
+BOOST_AUTO_TEST_CASE(OutputDithering) {
+  glight::system::Settings settings;
+  BOOST_CHECK(!Management(settings).OutputDithering());
+  settings.output_dithering = true;
+  Management management(settings);
+  BOOST_CHECK(management.OutputDithering());
+  management.SetOutputDithering(false);
+  BOOST_CHECK(!management.OutputDithering());
+}
+
 BOOST_AUTO_TEST_CASE(RemoveObject) {
   const glight::system::Settings settings;
   Management management(settings);
@@ -161,4 +172,53 @@ BOOST_AUTO_TEST_CASE(HasCycles) {
   BOOST_CHECK_EQUAL(management.HasCycle(), true);
 }
 
+BOOST_AUTO_TEST_CASE(Batch) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  size_t n_changes = 0;
+  management.SignalChange().connect([&]() { ++n_changes; });
+  ObservingPtr<FixtureType> type =
+      management.GetTheatre().AddFixtureTypePtr(StockFixture::Rgb);
+  std::vector<Fixture *> fixtures;
+  {
+    ManagementBatch batch(management);
+    BOOST_CHECK(management.InBatch());
+    BOOST_CHECK(management.GetTheatre().DmxChangesDeferred());
+    for (size_t i = 0; i != 10; ++i) {
+      Fixture &fixture =
+          *management.GetTheatre().AddFixture(type->Modes().front());
+      // Adding fixtures should still give every fixture its own channels
+      BOOST_CHECK_EQUAL(fixture.GetFirstChannel().Channel(), i * 3);
+      management.AddFixtureControl(fixture, management.RootFolder());
+      fixtures.emplace_back(&fixture);
+    }
+    BOOST_CHECK_EQUAL(management.GetTheatre().HighestChannel(), 29);
+    // Re-patching a single fixture is applied immediately
+    fixtures.back()->SetChannel(DmxChannel(100, 0));
+    BOOST_CHECK_EQUAL(management.GetTheatre().HighestChannel(), 102);
+    BOOST_CHECK_EQUAL(n_changes, 0);
+    batch.Commit();
+    BOOST_CHECK(!management.InBatch());
+    BOOST_CHECK_EQUAL(n_changes, 1);
+  }
+  BOOST_CHECK_EQUAL(n_changes, 1);
+  BOOST_CHECK_EQUAL(management.GetTheatre().HighestChannel(), 102);
+  for (Fixture *fixture : fixtures) {
+    BOOST_CHECK_EQUAL(&management.GetFixtureControl(*fixture)->GetFixture(),
+                      fixture);
+  }
+
+  {
+    std::unique_lock lock(management.Mutex());
+    ManagementBatch batch(management, std::defer_lock);
+    management.RemoveFixture(*fixtures[3]);
+    fixtures.erase(fixtures.begin() + 3);
+  }
+  BOOST_CHECK_EQUAL(n_changes, 1);
+  for (Fixture *fixture : fixtures) {
+    BOOST_CHECK_EQUAL(&management.GetFixtureControl(*fixture)->GetFixture(),
+                      fixture);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
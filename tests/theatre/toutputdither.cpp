@@ -0,0 +1,87 @@
+#include "system/settings.h"
+
+#include "theatre/fixturecontrol.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/outputdither.h"
+#include "theatre/theatre.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace glight::theatre;
+
+BOOST_AUTO_TEST_SUITE(output_dither)
+
+BOOST_AUTO_TEST_CASE(truncate) {
+  OutputDither dither;
+  const std::vector<unsigned> values{0,          0xFFFF,     0x10000,
+                                     0x7FFFFF,   0xFFFFFF,   0x2000000};
+  std::vector<unsigned char> output(values.size());
+  for (size_t frame = 0; frame != 3; ++frame) {
+    dither.Convert(0, true, values.data(), output.data(), values.size(),
+                   false);
+    const std::vector<unsigned char> expected{0, 0, 1, 127, 255, 255};
+    BOOST_CHECK_EQUAL_COLLECTIONS(output.begin(), output.end(),
+                                  expected.begin(), expected.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(average) {
+  OutputDither dither;
+  // A quarter step, half a step and a value near the maximum
+  const std::vector<unsigned> values{0x4000, 0x128000, 0xFFFFFF, 0x3000000};
+  std::vector<unsigned> sums(values.size(), 0);
+  std::vector<unsigned char> output(values.size());
+  constexpr size_t n_frames = 256;
+  for (size_t frame = 0; frame != n_frames; ++frame) {
+    dither.Convert(0, true, values.data(), output.data(), values.size(),
+                   true);
+    for (size_t i = 0; i != values.size(); ++i) sums[i] += output[i];
+    if (frame < 4) {
+      // A quarter step should produce one step every fourth frame
+      BOOST_CHECK_EQUAL(output[0], frame == 3 ? 1 : 0);
+    }
+  }
+  BOOST_CHECK_EQUAL(sums[0], n_frames / 4);
+  BOOST_CHECK_EQUAL(sums[1], n_frames * 0x12 + n_frames / 2);
+  BOOST_CHECK_EQUAL(sums[2], n_frames * 255);
+  BOOST_CHECK_EQUAL(sums[3], n_frames * 255);
+
+  // The secondary values have their own errors
+  const std::vector<unsigned> half{0x8000};
+  dither.Convert(0, false, half.data(), output.data(), 1, true);
+  BOOST_CHECK_EQUAL(output[0], 0);
+  dither.Convert(0, false, half.data(), output.data(), 1, true);
+  BOOST_CHECK_EQUAL(output[0], 1);
+}
+
+BOOST_AUTO_TEST_CASE(fine_channels) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  const FixtureMode &light =
+      theatre.AddFixtureType(StockFixture::Light)->Modes().front();
+  Fixture &fixture = *theatre.AddFixture(light);
+  FixtureFunction &function = *fixture.Functions().front();
+  function.SetChannel(DmxChannel(10, 1), DmxChannel(11, 1));
+  theatre.NotifyDmxChange(fixture);
+  FixtureControl &control = static_cast<FixtureControl &>(
+      *management.AddFixtureControl(fixture).Get());
+
+  OutputDither dither;
+  dither.Compile({&control});
+  std::vector<unsigned> values(512, 0x8000);
+  std::vector<unsigned char> output(512);
+  for (size_t frame = 0; frame != 2; ++frame) {
+    dither.Convert(1, true, values.data(), output.data(), values.size(),
+                   true);
+    BOOST_CHECK_EQUAL(output[9], frame);
+    BOOST_CHECK_EQUAL(output[10], 0);
+    BOOST_CHECK_EQUAL(output[11], 0);
+    BOOST_CHECK_EQUAL(output[12], frame);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+#include "theatre/fixture.h"
+#include "theatre/fixturetype.h"
+#include "theatre/patchindex.h"
+#include "theatre/theatre.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace glight::theatre;
+
+namespace {
+std::vector<DmxChannel> Span(unsigned first, unsigned n, unsigned universe) {
+  std::vector<DmxChannel> channels;
+  for (unsigned i = 0; i != n; ++i)
+    channels.emplace_back(first + i, universe);
+  return channels;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(patch_index)
+
+BOOST_AUTO_TEST_CASE(add_and_remove) {
+  Theatre theatre;
+  const FixtureMode &mode =
+      theatre.AddFixtureType(StockFixture::Rgb)->Modes().front();
+  const Fixture &a = *theatre.AddFixture(mode);
+  const Fixture &b = *theatre.AddFixture(mode);
+  const Fixture &c = *theatre.AddFixture(mode);
+
+  PatchIndex index;
+  BOOST_CHECK(index.FixturesAt(DmxChannel(0, 0)).empty());
+  BOOST_CHECK(!index.Add(a, Span(0, 10, 0)));
+  BOOST_CHECK(!index.Add(b, Span(10, 10, 0)));
+  BOOST_CHECK(!index.Add(c, Span(5, 5, 1)));
+  BOOST_CHECK(index.Conflicts().empty());
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(9, 0)).size(), 1);
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(9, 0)).front(), &a);
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(10, 0)).front(), &b);
+  BOOST_CHECK(index.FixturesAt(DmxChannel(20, 0)).empty());
+  BOOST_CHECK(index.FixturesAt(DmxChannel(4, 1)).empty());
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(5, 1)).front(), &c);
+
+  // Move c on top of a and b
+  index.Remove(c, Span(5, 5, 1));
+  BOOST_CHECK(index.Add(c, Span(8, 4, 0)));
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(8, 0)).size(), 2);
+  const std::vector<const Fixture *> overlapping =
+      index.Overlapping(c, Span(8, 4, 0));
+  BOOST_REQUIRE_EQUAL(overlapping.size(), 2);
+  BOOST_CHECK(std::find(overlapping.begin(), overlapping.end(), &a) !=
+              overlapping.end());
+  BOOST_CHECK(std::find(overlapping.begin(), overlapping.end(), &b) !=
+              overlapping.end());
+  BOOST_CHECK(index.Overlapping(a, Span(0, 8, 0)).empty());
+
+  const std::vector<PatchConflict> conflicts = index.Conflicts();
+  BOOST_REQUIRE_EQUAL(conflicts.size(), 2);
+  BOOST_CHECK_EQUAL(conflicts[0].universe, 0);
+  BOOST_CHECK_EQUAL(conflicts[0].first_channel, 8);
+  BOOST_CHECK_EQUAL(conflicts[0].n_channels, 2);
+  BOOST_CHECK_EQUAL(conflicts[0].fixtures.size(), 2);
+  BOOST_CHECK_EQUAL(conflicts[1].first_channel, 10);
+  BOOST_CHECK_EQUAL(conflicts[1].n_channels, 2);
+
+  // Removing everything should leave one empty segment per universe
+  index.Remove(c, Span(8, 4, 0));
+  index.Remove(a, Span(0, 10, 0));
+  index.Remove(b, Span(10, 10, 0));
+  BOOST_CHECK_EQUAL(index.SegmentCount(), 2);
+  BOOST_CHECK(index.FixturesAt(DmxChannel(10, 0)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(runs) {
+  Theatre theatre;
+  const FixtureMode &mode =
+      theatre.AddFixtureType(StockFixture::Rgb)->Modes().front();
+  const Fixture &a = *theatre.AddFixture(mode);
+  PatchIndex index;
+  // Unordered channels with a gap and one that wrapped around
+  index.Add(a, {DmxChannel(511, 0), DmxChannel(0, 0), DmxChannel(3, 0),
+                DmxChannel(2, 0)});
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(0, 0)).front(), &a);
+  BOOST_CHECK(index.FixturesAt(DmxChannel(1, 0)).empty());
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(3, 0)).front(), &a);
+  BOOST_CHECK(index.FixturesAt(DmxChannel(4, 0)).empty());
+  BOOST_CHECK_EQUAL(index.FixturesAt(DmxChannel(511, 0)).front(), &a);
+  BOOST_CHECK_EQUAL(index.SegmentCount(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(theatre_conflicts) {
+  Theatre theatre;
+  const FixtureMode &mode =
+      theatre.AddFixtureType(StockFixture::Rgb)->Modes().front();
+  std::vector<Fixture *> fixtures;
+  for (size_t i = 0; i != 1000; ++i) {
+    fixtures.emplace_back(theatre.AddFixture(mode).Get());
+  }
+  BOOST_CHECK(theatre.PatchConflicts().empty());
+  // 170 fixtures fit in a universe
+  BOOST_CHECK_EQUAL(theatre.FixturesAt(DmxChannel(2, 4)).front(),
+                    fixtures[680]);
+  BOOST_CHECK(theatre.FixturesAt(DmxChannel(511, 4)).empty());
+
+  fixtures[500]->SetChannel(fixtures[10]->GetFirstChannel() + 1);
+  const std::vector<PatchConflict> conflicts = theatre.PatchConflicts();
+  BOOST_REQUIRE_EQUAL(conflicts.size(), 2);
+  BOOST_CHECK_EQUAL(conflicts[0].first_channel, 31);
+  BOOST_CHECK_EQUAL(conflicts[0].n_channels, 2);
+  BOOST_CHECK_EQUAL(conflicts[1].first_channel, 33);
+  BOOST_CHECK_EQUAL(conflicts[1].n_channels, 1);
+  BOOST_CHECK_EQUAL(theatre.OverlappingFixtures(*fixtures[500]).size(), 2);
+  BOOST_CHECK_EQUAL(theatre.OverlappingFixtures(*fixtures[10]).size(), 1);
+  BOOST_CHECK(theatre.OverlappingFixtures(*fixtures[12]).empty());
+
+  theatre.RemoveFixture(*fixtures[500]);
+  BOOST_CHECK(theatre.PatchConflicts().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,162 @@
+#include "theatre/powerestimator.h"
+
+#include "system/settings.h"
+
+#include "theatre/fixture.h"
+#include "theatre/fixturemode.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/theatre.h"
+#include "theatre/valuesnapshot.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <random>
+
+namespace glight::theatre {
+
+BOOST_AUTO_TEST_SUITE(power_estimator)
+
+BOOST_AUTO_TEST_CASE(empty) {
+  PowerEstimator estimator;
+  estimator.Compile({});
+  estimator.Estimate(ValueSnapshot(true, 1));
+  BOOST_CHECK(estimator.Phases().empty());
+}
+
+BOOST_AUTO_TEST_CASE(same_as_fixture_mode) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  size_t phase = 0;
+  for (StockFixture stock_fixture :
+       {StockFixture::Rgb, StockFixture::BtVintage, StockFixture::RgbawUv,
+        StockFixture::AdjStarBurst, StockFixture::Light}) {
+    FixtureType &type = *theatre.AddFixtureType(stock_fixture);
+    FixtureMode &mode = type.Modes().front();
+    std::vector<FixtureModeFunction> functions = mode.Functions();
+    for (FixtureModeFunction &function : functions) {
+      function.SetPower(function.Type() == FunctionType::Master ? 25 : 10);
+    }
+    // Make the first function 16 bit, using the channel after the last one
+    functions.front().SetFineChannelOffset(
+        system::OptionalNumber<size_t>(mode.Functions().size()));
+    mode.SetFunctions(std::move(functions));
+    type.SetIdlePower(5);
+    for (size_t i = 0; i != 2; ++i) {
+      Fixture &fixture = *theatre.AddFixture(mode);
+      fixture.SetElectricPhase(phase % 3 + 1);
+      ++phase;
+    }
+  }
+
+  PowerEstimator estimator;
+  estimator.Compile(theatre.Fixtures());
+  BOOST_REQUIRE_EQUAL(estimator.Phases().size(), 3);
+
+  std::mt19937 rng;
+  std::uniform_int_distribution<unsigned> distribution(0, 255);
+  ValueSnapshot snapshot(true, 1);
+  std::vector<unsigned char> values(512);
+  for (size_t repeat = 0; repeat != 10; ++repeat) {
+    for (unsigned char &value : values) value = distribution(rng);
+    snapshot.GetUniverseSnapshot(0).SetValues(values.data(), values.size());
+    estimator.Estimate(snapshot);
+
+    std::map<size_t, std::pair<double, double>> expected;
+    for (const system::TrackablePtr<Fixture> &fixture : theatre.Fixtures()) {
+      std::pair<double, double> &phase_power =
+          expected[fixture->ElectricPhase()];
+      phase_power.first += fixture->Mode().GetPower(*fixture, snapshot);
+      phase_power.second += fixture->Mode().Type().MaxPower();
+    }
+    auto expected_iter = expected.begin();
+    for (const PhasePower &phase_power : estimator.Phases()) {
+      BOOST_CHECK_EQUAL(phase_power.phase, expected_iter->first);
+      // Fixture powers are rounded to milliwatts
+      BOOST_CHECK_SMALL(phase_power.power - expected_iter->second.first, 0.01);
+      BOOST_CHECK_EQUAL(phase_power.max_power, expected_iter->second.second);
+      ++expected_iter;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(limited_to_max_power) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureType &type = *theatre.AddFixtureType(StockFixture::Rgb);
+  FixtureMode &mode = type.Modes().front();
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  for (FixtureModeFunction &function : functions) function.SetPower(10);
+  mode.SetFunctions(std::move(functions));
+  type.SetMaxPower(20);
+  type.SetIdlePower(2);
+  theatre.AddFixture(mode);
+  PowerEstimator estimator;
+  estimator.Compile(theatre.Fixtures());
+
+  ValueSnapshot snapshot(true, 1);
+  std::vector<unsigned char> values{0, 0, 0};
+  snapshot.GetUniverseSnapshot(0).SetValues(values.data(), values.size());
+  estimator.Estimate(snapshot);
+  BOOST_REQUIRE_EQUAL(estimator.Phases().size(), 1);
+  BOOST_CHECK_EQUAL(estimator.Phases()[0].power, 2.0);
+
+  values = {255, 255, 255};
+  snapshot.GetUniverseSnapshot(0).SetValues(values.data(), values.size());
+  estimator.Estimate(snapshot);
+  BOOST_CHECK_EQUAL(estimator.Phases()[0].power, 20.0);
+  BOOST_CHECK_EQUAL(estimator.Phases()[0].max_power, 20.0);
+}
+
+BOOST_AUTO_TEST_CASE(changed_channels) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureType &type = *theatre.AddFixtureType(StockFixture::Rgb);
+  FixtureMode &mode = type.Modes().front();
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  for (FixtureModeFunction &function : functions) function.SetPower(10);
+  mode.SetFunctions(std::move(functions));
+  type.SetMaxPower(30);
+  type.SetIdlePower(0);
+  theatre.AddFixture(mode);
+  Fixture &second = *theatre.AddFixture(mode);
+  second.SetChannel(DmxChannel(10, 1));
+  PowerEstimator estimator;
+  estimator.Compile(theatre.Fixtures());
+  BOOST_REQUIRE_EQUAL(estimator.Phases().size(), 1);
+
+  // Power of a colour channel at full, without fine channel
+  const double full = 10.0 * 255 * 256 * 256 / ControlValue::MaxUInt();
+  std::vector<std::array<unsigned, kChannelsPerUniverse>> universes(2);
+  universes[0].fill(0);
+  universes[1].fill(0);
+  universes[1][11] = ControlValue::MaxUInt();
+  estimator.Estimate(universes);
+  BOOST_CHECK_SMALL(estimator.Phases()[0].power - full, 0.01);
+
+  // Values above the maximum count as the maximum
+  universes[0][0] = ControlValue::MaxUInt() * 2;
+  estimator.Estimate(universes);
+  BOOST_CHECK_SMALL(estimator.Phases()[0].power - 2.0 * full, 0.01);
+
+  universes[1][11] = 0;
+  estimator.Estimate(universes);
+  BOOST_CHECK_SMALL(estimator.Phases()[0].power - full, 0.01);
+
+  // Missing universes count as zero
+  universes[1][12] = ControlValue::MaxUInt();
+  universes.resize(1);
+  estimator.Estimate(universes);
+  BOOST_CHECK_SMALL(estimator.Phases()[0].power - full, 0.01);
+  universes[0][0] = 0;
+  estimator.Estimate(universes);
+  BOOST_CHECK_SMALL(estimator.Phases()[0].power, 0.01);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace glight::theatre
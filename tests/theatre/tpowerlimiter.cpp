@@ -0,0 +1,167 @@
+#include "theatre/powerlimiter.h"
+
+#include "system/settings.h"
+
+#include "theatre/controlvalue.h"
+#include "theatre/fixture.h"
+#include "theatre/fixturemode.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/theatre.h"
+
+#include <boost/test/unit_test.hpp>
+
+namespace glight::theatre {
+
+namespace {
+using Universes = std::vector<std::array<unsigned, kChannelsPerUniverse>>;
+
+constexpr unsigned kFull = ControlValue::MaxUInt();
+
+/**
+ * Adds @p n fixtures with a 10 W red, green and blue channel and 2 W idle
+ * power to the given phase.
+ */
+void AddFixtures(Theatre &theatre, FixtureMode &mode, size_t n, size_t phase) {
+  for (size_t i = 0; i != n; ++i) {
+    Fixture &fixture = *theatre.AddFixture(mode);
+    fixture.SetElectricPhase(phase);
+  }
+}
+
+FixtureMode &MakeMode(Theatre &theatre, StockFixture stock_fixture) {
+  FixtureType &type = *theatre.AddFixtureType(stock_fixture);
+  FixtureMode &mode = type.Modes().front();
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  for (FixtureModeFunction &function : functions) {
+    function.SetPower(IsColor(function.Type()) ? 10 : 0);
+  }
+  mode.SetFunctions(std::move(functions));
+  type.SetIdlePower(2);
+  type.SetMaxPower(100);
+  return mode;
+}
+
+Universes FullUniverse() {
+  Universes universes(1);
+  universes[0].fill(kFull);
+  return universes;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(power_limiter)
+
+BOOST_AUTO_TEST_CASE(no_limit) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  AddFixtures(theatre, MakeMode(theatre, StockFixture::Rgb), 4, 1);
+  PowerLimiter limiter;
+  limiter.Compile(theatre.Fixtures());
+  BOOST_CHECK(!limiter.HasLimits());
+
+  Universes universes = FullUniverse();
+  limiter.Apply(universes, 0.025);
+  // Full DMX values are slightly less than full power in the power model
+  BOOST_CHECK_CLOSE(limiter.Load()[0].power, 4 * 32.0, 0.5);
+  BOOST_CHECK_EQUAL(limiter.Scale(1), 1.0);
+  for (unsigned value : universes[0]) BOOST_CHECK_EQUAL(value, kFull);
+
+  limiter.SetLimit(1, 200.0);
+  BOOST_CHECK(limiter.HasLimits());
+  BOOST_REQUIRE(limiter.Limit(1));
+  BOOST_CHECK_EQUAL(*limiter.Limit(1), 200.0);
+  BOOST_CHECK(!limiter.Limit(2));
+  limiter.Apply(universes, 0.025);
+  BOOST_CHECK_EQUAL(limiter.Scale(1), 1.0);
+  for (unsigned value : universes[0]) BOOST_CHECK_EQUAL(value, kFull);
+
+  limiter.SetLimit(1, {});
+  BOOST_CHECK(!limiter.HasLimits());
+}
+
+BOOST_AUTO_TEST_CASE(limit_colour_channels) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureMode &mode = MakeMode(theatre, StockFixture::Rgb);
+  AddFixtures(theatre, mode, 4, 1);
+  AddFixtures(theatre, mode, 2, 2);
+  PowerLimiter limiter;
+  limiter.SetLimit(1, 68.0);
+  limiter.Compile(theatre.Fixtures());
+
+  // Phase 1 uses about 4 x (2 + 30) = 128 W, of which 8 W is idle
+  Universes universes = FullUniverse();
+  limiter.Apply(universes, 0.025);
+  const double load = limiter.Load()[0].power;
+  BOOST_CHECK_CLOSE(load, 128.0, 0.5);
+  const double scale = (68.0 - 8.0) / (load - 8.0);
+  BOOST_CHECK_CLOSE(limiter.Scale(1), scale, 1e-6);
+  BOOST_CHECK_EQUAL(limiter.Scale(2), 1.0);
+  for (const system::TrackablePtr<Fixture> &fixture : theatre.Fixtures()) {
+    const double expected =
+        fixture->ElectricPhase() == 1 ? kFull * scale : kFull;
+    for (const std::unique_ptr<FixtureFunction> &function :
+         fixture->Functions()) {
+      const unsigned value = universes[0][function->MainChannel().Channel()];
+      BOOST_CHECK_CLOSE(double(value), expected, 0.01);
+    }
+  }
+
+  // The limited output should be within the budget
+  PowerEstimator estimator;
+  estimator.Compile(theatre.Fixtures());
+  estimator.Estimate(universes);
+  BOOST_CHECK_LE(estimator.Phases()[0].power, 68.0);
+
+  // Once the load drops, the scale is released gradually
+  universes = Universes(1);
+  limiter.Apply(universes, 0.5);
+  BOOST_CHECK_CLOSE(limiter.Scale(1), scale + PowerLimiter::kReleaseRate * 0.5,
+                    1e-6);
+  limiter.Apply(universes, 0.5);
+  BOOST_CHECK_EQUAL(limiter.Scale(1), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(limit_master_channel) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureType &type = *theatre.AddFixtureType(StockFixture::Rgb);
+  // The second mode has a master channel
+  FixtureMode &mode = type.Modes()[1];
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  for (FixtureModeFunction &function : functions) {
+    function.SetPower(IsColor(function.Type()) ? 10 : 0);
+  }
+  functions.back().SetFineChannelOffset(system::OptionalNumber<size_t>(4));
+  mode.SetFunctions(std::move(functions));
+  type.SetIdlePower(0);
+  type.SetMaxPower(100);
+  Fixture &fixture = *theatre.AddFixture(mode);
+  PowerLimiter limiter;
+  limiter.SetLimit(0, 7.5);
+  limiter.Compile(theatre.Fixtures());
+
+  Universes universes = FullUniverse();
+  limiter.Apply(universes, 0.025);
+  BOOST_CHECK_CLOSE(limiter.Scale(0), 0.25, 1.0);
+  // Only the master is scaled
+  for (size_t i = 0; i != 3; ++i) {
+    BOOST_CHECK_EQUAL(
+        universes[0][fixture.Functions()[i]->MainChannel().Channel()], kFull);
+  }
+  const FixtureFunction &master = *fixture.Functions()[3];
+  const unsigned main = universes[0][master.MainChannel().Channel()];
+  const unsigned fine = universes[0][master.FineChannel()->Channel()];
+  BOOST_CHECK_EQUAL(main & 0xFFFF, 0);
+  BOOST_CHECK_EQUAL(fine & 0xFF, 0);
+  const unsigned combined = main + (fine >> 8);
+  BOOST_CHECK_CLOSE(double(combined), kFull * limiter.Scale(0), 0.01);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace glight::theatre
@@ -0,0 +1,106 @@
+#include "theatre/responsecurve.h"
+
+#include "system/settings.h"
+
+#include "theatre/channelwriter.h"
+#include "theatre/fixturecontrol.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/theatre.h"
+#include "theatre/timing.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace glight::theatre;
+
+BOOST_AUTO_TEST_SUITE(response_curve)
+
+constexpr unsigned kFull = ControlValue::MaxUInt();
+
+BOOST_AUTO_TEST_CASE(linear) {
+  const ResponseCurve curve;
+  BOOST_CHECK(curve.IsLinear());
+  BOOST_CHECK(!curve.GetTable());
+  BOOST_CHECK_EQUAL(curve.Apply(0), 0);
+  BOOST_CHECK_EQUAL(curve.Apply(12345), 12345);
+  BOOST_CHECK_EQUAL(curve.Apply(kFull), kFull);
+}
+
+BOOST_AUTO_TEST_CASE(gamma) {
+  const ResponseCurve curve = ResponseCurve::Gamma(2.2);
+  BOOST_CHECK(curve.Type() == CurveType::Gamma);
+  BOOST_CHECK_EQUAL(curve.Apply(0), 0);
+  BOOST_CHECK_EQUAL(curve.Apply(kFull), kFull);
+  BOOST_CHECK_EQUAL(curve.Apply(kFull * 2), kFull);
+  for (unsigned value = 0; value < kFull; value += 99991) {
+    const double expected = std::pow(double(value) / kFull, 2.2) * kFull;
+    // The interpolation error of the table is largest near zero
+    BOOST_CHECK_LE(std::abs(double(curve.Apply(value)) - expected), 64.0);
+  }
+  // Copies share the table
+  const ResponseCurve copy = curve;
+  BOOST_CHECK(copy.GetTable() == curve.GetTable());
+}
+
+BOOST_AUTO_TEST_CASE(s_curve) {
+  const ResponseCurve curve = ResponseCurve::SCurve();
+  BOOST_CHECK_EQUAL(curve.Apply(0), 0);
+  BOOST_CHECK_EQUAL(curve.Apply(kFull / 2 + 1), kFull / 2 + 1);
+  BOOST_CHECK_LT(curve.Apply(kFull / 4), kFull / 4);
+  BOOST_CHECK_GT(curve.Apply(kFull * 3 / 4), kFull * 3 / 4);
+  BOOST_CHECK_EQUAL(curve.Apply(kFull), kFull);
+}
+
+BOOST_AUTO_TEST_CASE(custom) {
+  const ResponseCurve curve =
+      ResponseCurve::Custom({{1.0, 0.5}, {0.5, 1.0}, {0.25, 0.25}});
+  BOOST_REQUIRE_EQUAL(curve.Points().size(), 3);
+  BOOST_CHECK_EQUAL(curve.Points().front().first, 0.25);
+  BOOST_CHECK_EQUAL(curve.Evaluate(0.0), 0.25);
+  BOOST_CHECK_EQUAL(curve.Evaluate(0.375), 0.625);
+  BOOST_CHECK_EQUAL(curve.Evaluate(0.75), 0.75);
+  BOOST_CHECK_EQUAL(curve.Evaluate(1.0), 0.5);
+  BOOST_CHECK_LE(std::abs(int(curve.Apply(kFull / 2)) - int(kFull)), 8);
+  // Decreasing parts are interpolated correctly
+  BOOST_CHECK_LE(std::abs(int(curve.Apply(kFull * 3 / 4)) - int(kFull * 3 / 4)),
+                 8);
+  BOOST_CHECK_EQUAL(curve.Apply(kFull), (kFull + 1) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(output) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureType &type = *theatre.AddFixtureType(StockFixture::Rgb);
+  FixtureMode &mode = type.Modes().front();
+  std::vector<FixtureModeFunction> functions = mode.Functions();
+  functions[0].SetCurve(ResponseCurve::Gamma(2.0));
+  functions[1].SetFineChannelOffset(glight::system::OptionalNumber<size_t>(3));
+  functions[1].SetCurve(ResponseCurve::Gamma(3.0));
+  mode.SetFunctions(std::move(functions));
+  Fixture &fixture = *theatre.AddFixture(mode);
+  FixtureControl &control = static_cast<FixtureControl &>(
+      *management.AddFixtureControl(fixture).Get());
+  for (size_t i = 0; i != control.NInputs(); ++i)
+    control.InputValue(i) = ControlValue(kFull / 2);
+  control.Mix(Timing(0.0, 0, 0, 0, 0), true);
+
+  std::vector<unsigned> expected(512, 0);
+  control.GetChannelValues(expected.data(), 0);
+  const unsigned first = fixture.Functions()[0]->MainChannel().Channel();
+  BOOST_CHECK_EQUAL(expected[first] >> 16, 63);
+  BOOST_CHECK_EQUAL(expected[first + 1] >> 16, 31);
+  BOOST_CHECK_EQUAL(expected[first + 2] >> 16, 127);
+
+  ChannelWriter writer;
+  writer.Compile({&control});
+  std::vector<unsigned> result(512, 0);
+  writer.Write(0, result.data());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(),
+                                expected.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -84,6 +84,56 @@ BOOST_AUTO_TEST_CASE(remove_fixture) {
   BOOST_CHECK_EQUAL(management.RootFolder().Children().size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(channel_occupancy) {
+  const glight::system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  FixtureType &fixtureType = *theatre.AddFixtureType(StockFixture::Rgb);
+  const FixtureMode &mode = fixtureType.Modes().front();
+  BOOST_CHECK_EQUAL(mode.ChannelCount(), 3);
+  BOOST_CHECK_EQUAL(theatre.FirstFreeChannel(0, 3).Channel(), 0);
+
+  std::vector<Fixture *> fixtures;
+  for (size_t i = 0; i != 171; ++i) {
+    fixtures.emplace_back(theatre.AddFixture(mode).Get());
+  }
+  // 170 fixtures fit in universe 0, the last one is placed in universe 1
+  BOOST_CHECK_EQUAL(fixtures[169]->GetFirstChannel().Channel(), 507);
+  BOOST_CHECK_EQUAL(fixtures[169]->GetUniverse(), 0);
+  BOOST_CHECK_EQUAL(fixtures[170]->GetFirstChannel().Channel(), 0);
+  BOOST_CHECK_EQUAL(fixtures[170]->GetUniverse(), 1);
+  BOOST_CHECK_EQUAL(*theatre.HighestChannel(0), 509);
+  BOOST_CHECK_EQUAL(*theatre.HighestChannel(1), 2);
+  BOOST_CHECK(!theatre.HighestChannel(2));
+  BOOST_CHECK_EQUAL(theatre.HighestChannel(), 509);
+
+  fixtures[170]->SetUniverse(2);
+  BOOST_CHECK(!theatre.HighestChannel(1));
+  BOOST_CHECK_EQUAL(*theatre.HighestChannel(2), 2);
+  BOOST_CHECK_EQUAL(theatre.FirstFreeChannel(1, 3).Universe(), 1);
+
+  theatre.RemoveFixture(*fixtures[169]);
+  BOOST_CHECK_EQUAL(*theatre.HighestChannel(0), 506);
+  theatre.RemoveFixture(*fixtures[5]);
+  BOOST_CHECK_EQUAL(*theatre.Occupancy().FirstFreeSpan(0, 3), 15);
+  BOOST_CHECK_EQUAL(*theatre.Occupancy().FirstFreeSpan(0, 4), 507);
+  BOOST_CHECK(theatre.Occupancy().IsFree(DmxChannel(15, 0), 3));
+  BOOST_CHECK(!theatre.Occupancy().IsFree(DmxChannel(14, 0), 3));
+
+  BOOST_CHECK(!theatre.HasOverlap(*fixtures[0]));
+  fixtures[0]->IncChannel();
+  BOOST_CHECK(theatre.HasOverlap(*fixtures[0]));
+  BOOST_CHECK(theatre.HasOverlap(*fixtures[1]));
+  BOOST_CHECK(!theatre.HasOverlap(*fixtures[2]));
+  BOOST_CHECK_EQUAL(theatre.Occupancy().SharedChannelCount(), 1);
+  fixtures[0]->DecChannel();
+  BOOST_CHECK_EQUAL(theatre.Occupancy().SharedChannelCount(), 0);
+
+  theatre.Clear();
+  BOOST_CHECK_EQUAL(theatre.HighestChannel(), 0);
+  BOOST_CHECK(!theatre.HighestChannel(0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace glight
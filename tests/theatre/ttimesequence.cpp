@@ -0,0 +1,57 @@
+#include "theatre/timesequence.h"
+#include "theatre/timing.h"
+
+#include "theatre/effects/variableeffect.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace glight::theatre;
+
+namespace {
+
+constexpr double kBeatDuration = 500.0;
+
+/** Timing of a frame at the given beat, at a constant tempo. */
+Timing AtBeat(unsigned timestep, double beat) {
+  return Timing(beat * kBeatDuration, timestep, beat, 0, 0, kBeatDuration);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(time_sequence)
+
+BOOST_AUTO_TEST_CASE(beat_trigger) {
+  VariableEffect a;
+  VariableEffect b;
+  TimeSequence sequence;
+  sequence.SetRepeatCount(0);
+  for (VariableEffect *variable : {&a, &b}) {
+    TimeSequence::Step &step = sequence.AddStep(*variable, 0);
+    step.trigger.SetType(TriggerType::Beat);
+    step.trigger.SetDelayInBeats(4.0);
+    step.transition = Transition(0.0, TransitionType::None);
+  }
+  sequence.InputValue(0) = ControlValue::Max();
+
+  unsigned timestep = 0;
+  // Returns 0 if a is on, 1 if b is on and -1 otherwise
+  const auto active_step = [&](double beat) {
+    a.InputValue(0) = ControlValue::Zero();
+    b.InputValue(0) = ControlValue::Zero();
+    sequence.Mix(AtBeat(++timestep, beat), true);
+    if (a.InputValue(0) && !b.InputValue(0)) return 0;
+    if (b.InputValue(0) && !a.InputValue(0)) return 1;
+    return -1;
+  };
+
+  // A step that starts in the middle of a beat lasts the full delay
+  BOOST_CHECK_EQUAL(active_step(3.7), 0);
+  BOOST_CHECK_EQUAL(active_step(4.0), 0);
+  BOOST_CHECK_EQUAL(active_step(7.6), 0);
+  BOOST_CHECK_EQUAL(active_step(7.75), 1);
+  // The next step is timed from the end of the transition
+  BOOST_CHECK_EQUAL(active_step(11.7), 1);
+  BOOST_CHECK_EQUAL(active_step(11.8), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
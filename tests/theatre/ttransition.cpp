@@ -154,6 +154,67 @@ BOOST_AUTO_TEST_CASE(fade_through_full_out) {
   BOOST_CHECK_EQUAL(end.UInt(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(constant_acceleration) {
+  const Transition t(1000, TransitionType::ConstantAcceleration);
+  for (double time = 0.0; time <= 1000.0; time += 37.0) {
+    const double ratio = time / 1000.0;
+    const double expected = ratio <= 0.5
+                                ? ratio * ratio * 2.0
+                                : 1.0 - (ratio - 1.0) * (ratio - 1.0) * 2.0;
+    // The curve is interpolated from a table
+    theatre::ToleranceCheck(t.InValue(time, Timing()),
+                            ControlValue::FromRatio(expected).UInt(), 16);
+    theatre::ToleranceCheck(t.OutValue(time, Timing()),
+                            ControlValue::FromRatio(1.0 - expected).UInt(), 16);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(zero_length) {
+  const Transition t(0, TransitionType::Fade);
+  BOOST_CHECK_EQUAL(t.InValue(0.0, Timing()).UInt(), 0);
+  BOOST_CHECK_EQUAL(t.InValue(10.0, Timing()).UInt(), ControlValue::MaxUInt());
+  BOOST_CHECK_EQUAL(t.OutValue(10.0, Timing()).UInt(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(step_values) {
+  const unsigned max = ControlValue::MaxUInt();
+  const Transition none(1000, TransitionType::None);
+  BOOST_CHECK_EQUAL(none.InValue(500.0, Timing()).UInt(), 0);
+  BOOST_CHECK_EQUAL(none.InValue(500.5, Timing()).UInt(), max);
+  BOOST_CHECK_EQUAL(none.OutValue(500.0, Timing()).UInt(), max);
+  BOOST_CHECK_EQUAL(none.OutValue(500.5, Timing()).UInt(), 0);
+
+  const Transition stepped(1000, TransitionType::Stepped);
+  BOOST_CHECK_EQUAL(stepped.InValue(0.0, Timing()).UInt(), 0);
+  BOOST_CHECK_EQUAL(stepped.InValue(199.5, Timing()).UInt(), 0);
+  BOOST_CHECK_EQUAL(stepped.InValue(200.0, Timing()).UInt(), max / 5);
+  BOOST_CHECK_EQUAL(stepped.InValue(799.5, Timing()).UInt(), max * 3 / 5);
+  BOOST_CHECK_EQUAL(stepped.InValue(1000.0, Timing()).UInt(), max);
+  BOOST_CHECK_EQUAL(stepped.InValue(1500.0, Timing()).UInt(), max);
+  BOOST_CHECK_EQUAL(stepped.OutValue(-10.0, Timing()).UInt(), max);
+  BOOST_CHECK_EQUAL(stepped.OutValue(199.5, Timing()).UInt(), max);
+}
+
+BOOST_AUTO_TEST_CASE(batch_values) {
+  const std::vector<double> times{-10.0, 0.0,   13.0,  100.0, 250.0,
+                                  399.0, 400.0, 401.0, 500.0};
+  for (TransitionType type : theatre::GetTransitionTypes()) {
+    const Transition t(400, type);
+    std::vector<ControlValue> in_values(times.size());
+    std::vector<ControlValue> out_values(times.size());
+    t.InValues(times, in_values, Timing());
+    t.OutValues(times, out_values, Timing());
+    // Random transitions draw different values for every call
+    if (theatre::DependsOnTiming(type)) continue;
+    for (size_t i = 0; i != times.size(); ++i) {
+      BOOST_CHECK_EQUAL(in_values[i].UInt(),
+                        t.InValue(times[i], Timing()).UInt());
+      BOOST_CHECK_EQUAL(out_values[i].UInt(),
+                        t.OutValue(times[i], Timing()).UInt());
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace glight
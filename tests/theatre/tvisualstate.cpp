@@ -0,0 +1,94 @@
+#include "theatre/visualstate.h"
+
+#include "system/settings.h"
+
+#include "theatre/fixture.h"
+#include "theatre/fixturemode.h"
+#include "theatre/fixturetype.h"
+#include "theatre/management.h"
+#include "theatre/theatre.h"
+#include "theatre/valuesnapshot.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+namespace glight::theatre {
+
+BOOST_AUTO_TEST_SUITE(visual_state)
+
+BOOST_AUTO_TEST_CASE(empty) {
+  VisualStateDecoder decoder;
+  BOOST_CHECK_EQUAL(decoder.FixtureCount(), 0);
+  decoder.Decode({}, ValueSnapshot(true, 1));
+  BOOST_CHECK_EQUAL(decoder.FixtureCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(same_as_getters) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  for (StockFixture stock_fixture :
+       {StockFixture::Rgb, StockFixture::BtVintage, StockFixture::AdjStarBurst,
+        StockFixture::H2ODmxPro, StockFixture::ZoomingMovingHead,
+        StockFixture::MovingHead, StockFixture::Light}) {
+    theatre.AddFixture(theatre.AddFixtureType(stock_fixture)->Modes().front());
+  }
+  const std::vector<system::TrackablePtr<Fixture>> &fixtures =
+      theatre.Fixtures();
+
+  std::mt19937 rng;
+  std::uniform_int_distribution<unsigned> distribution(0, 255);
+  ValueSnapshot snapshot(true, 1);
+  std::vector<unsigned char> values(512);
+  VisualStateDecoder decoder;
+  for (size_t repeat = 0; repeat != 10; ++repeat) {
+    for (unsigned char &value : values) value = distribution(rng);
+    snapshot.GetUniverseSnapshot(0).SetValues(values.data(), values.size());
+    decoder.Decode(fixtures, snapshot);
+    BOOST_REQUIRE_EQUAL(decoder.FixtureCount(), fixtures.size());
+    for (size_t i = 0; i != fixtures.size(); ++i) {
+      const Fixture &fixture = *fixtures[i];
+      const FixtureMode &mode = fixture.Mode();
+      const FixtureType &type = mode.Type();
+      const std::span<const ShapeVisualState> shapes = decoder.Shapes(i);
+      BOOST_REQUIRE_EQUAL(shapes.size(), type.ShapeCount());
+      for (size_t shape = 0; shape != shapes.size(); ++shape) {
+        BOOST_CHECK(shapes[shape].color ==
+                    mode.GetColor(fixture, snapshot, shape));
+        BOOST_CHECK_EQUAL(shapes[shape].rotation_speed,
+                          mode.GetRotationSpeed(fixture, snapshot, shape));
+        BOOST_CHECK_EQUAL(shapes[shape].direction,
+                          fixture.GetBeamDirection(snapshot, shape));
+        BOOST_CHECK_EQUAL(shapes[shape].tilt,
+                          fixture.GetBeamTilt(snapshot, shape));
+        const double beam_angle = type.CanZoom()
+                                      ? mode.GetZoom(fixture, snapshot, shape)
+                                      : type.MinBeamAngle();
+        BOOST_CHECK_EQUAL(shapes[shape].beam_angle, beam_angle);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rgb_color) {
+  const system::Settings settings;
+  Management management(settings);
+  Theatre &theatre = management.GetTheatre();
+  const FixtureMode &mode =
+      theatre.AddFixtureType(StockFixture::Rgb)->Modes().front();
+  theatre.AddFixture(mode);
+  ValueSnapshot snapshot(true, 1);
+  const std::vector<unsigned char> values{255, 100, 0};
+  snapshot.GetUniverseSnapshot(0).SetValues(values.data(), values.size());
+  VisualStateDecoder decoder;
+  decoder.Decode(theatre.Fixtures(), snapshot);
+  const Color color = decoder.Shapes(0)[0].color;
+  BOOST_CHECK_EQUAL(color.Red(), 255);
+  BOOST_CHECK_EQUAL(color.Green(), 100);
+  BOOST_CHECK_EQUAL(color.Blue(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace glight::theatre
@@ -0,0 +1,57 @@
+#include "beatclock.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace glight::theatre {
+
+namespace {
+
+/**
+ * When no beat is detected for this many beats, the music is assumed to
+ * have stopped, and the position is no longer extrapolated.
+ */
+constexpr double kMaximumExtrapolation = 4.0;
+
+/** Beat intervals longer than this (30 bpm) are not used as tempo. */
+constexpr double kMaximumBeatDuration = 2000.0;
+
+/** Weight of a newly measured beat interval in the tempo estimate. */
+constexpr double kTempoSmoothing = 0.25;
+
+}  // namespace
+
+void BeatClock::AddBeat(double time_in_ms) {
+  if (!last_beat_time_) {
+    beat_count_ += 1.0;
+    last_beat_time_ = time_in_ms;
+    return;
+  }
+  const double interval = time_in_ms - *last_beat_time_;
+  if (interval <= 0.0) return;
+  if (beat_duration_ == 0.0) {
+    beat_count_ += 1.0;
+    if (interval <= kMaximumBeatDuration) beat_duration_ = interval;
+  } else {
+    const double extrapolated = interval / beat_duration_;
+    if (extrapolated < kMaximumExtrapolation) {
+      const double beats = std::max(1.0, std::round(extrapolated));
+      beat_count_ += beats;
+      beat_duration_ += (interval / beats - beat_duration_) * kTempoSmoothing;
+    } else {
+      // The music was interrupted: count one beat after where the
+      // extrapolation stopped, and measure the tempo again
+      beat_count_ += kMaximumExtrapolation + 1.0;
+      beat_duration_ = 0.0;
+    }
+  }
+  last_beat_time_ = time_in_ms;
+}
+
+double BeatClock::BeatValue(double time_in_ms) const {
+  if (!last_beat_time_ || beat_duration_ == 0.0) return beat_count_;
+  const double beats = (time_in_ms - *last_beat_time_) / beat_duration_;
+  return beat_count_ + std::clamp(beats, 0.0, kMaximumExtrapolation);
+}
+
+}  // namespace glight::theatre
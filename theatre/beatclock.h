@@ -0,0 +1,44 @@
+#ifndef THEATRE_BEAT_CLOCK_H_
+#define THEATRE_BEAT_CLOCK_H_
+
+#include <optional>
+
+namespace glight::theatre {
+
+/**
+ * Turns beats that are detected at discrete moments into a continuous beat
+ * position. The tempo is estimated from the intervals between detected
+ * beats, and the position in between beats is extrapolated from it. This
+ * makes it possible to find the moment of a beat (or of a fraction of a
+ * beat) with an accuracy that is independent of the frame rate.
+ *
+ * The whole part of the position counts the beats. A beat that is
+ * detected late makes the position jump back by the amount that it was
+ * extrapolated too far, but never to before the last whole beat. A beat
+ * that is missed is extrapolated, and is counted when the next beat
+ * arrives. When no beats are detected for a few beats, the position stops
+ * until the music continues.
+ */
+class BeatClock {
+ public:
+  /**
+   * Registers a beat that was detected at the given time. Times may have
+   * any origin, as long as the same origin is used for @ref BeatValue().
+   */
+  void AddBeat(double time_in_ms);
+
+  /** Beat position at the given time. */
+  double BeatValue(double time_in_ms) const;
+
+  /** Duration of one beat in ms, or zero when the tempo is not known. */
+  double BeatDuration() const { return beat_duration_; }
+
+ private:
+  double beat_count_ = 0.0;
+  std::optional<double> last_beat_time_;
+  double beat_duration_ = 0.0;
+};
+
+}  // namespace glight::theatre
+
+#endif
@@ -0,0 +1,91 @@
+#include "channeloccupancy.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace glight::theatre {
+
+void ChannelOccupancy::Add(DmxChannel channel) {
+  assert(channel.Channel() < kChannelsPerUniverse);
+  if (channel.Universe() >= universes_.size())
+    universes_.resize(channel.Universe() + 1);
+  Universe &universe = universes_[channel.Universe()];
+  const unsigned index = channel.Channel();
+  ++universe.counts[index];
+  if (universe.counts[index] == 1) {
+    universe.used[index / 64] |= uint64_t(1) << (index % 64);
+    universe.end = std::max(universe.end, index + 1);
+  } else if (universe.counts[index] == 2) {
+    ++n_shared_channels_;
+  }
+}
+
+void ChannelOccupancy::Remove(DmxChannel channel) {
+  assert(UseCount(channel) != 0);
+  Universe &universe = universes_[channel.Universe()];
+  const unsigned index = channel.Channel();
+  --universe.counts[index];
+  if (universe.counts[index] == 0) {
+    universe.used[index / 64] &= ~(uint64_t(1) << (index % 64));
+    if (index + 1 == universe.end) UpdateEnd(universe);
+  } else if (universe.counts[index] == 1) {
+    --n_shared_channels_;
+  }
+}
+
+void ChannelOccupancy::UpdateEnd(Universe &universe) {
+  for (size_t word = kNWords; word != 0; --word) {
+    const uint64_t bits = universe.used[word - 1];
+    if (bits != 0) {
+      universe.end = word * 64 - std::countl_zero(bits);
+      return;
+    }
+  }
+  universe.end = 0;
+}
+
+bool ChannelOccupancy::IsFree(DmxChannel first, size_t n_channels) const {
+  size_t begin = first.Channel();
+  const size_t end = begin + n_channels;
+  if (end > kChannelsPerUniverse) return false;
+  if (first.Universe() >= universes_.size()) return true;
+  const Universe &universe = universes_[first.Universe()];
+  while (begin < end) {
+    const size_t bit = begin % 64;
+    const size_t n_bits = std::min<size_t>(64 - bit, end - begin);
+    const uint64_t mask =
+        (n_bits == 64 ? ~uint64_t(0) : ((uint64_t(1) << n_bits) - 1)) << bit;
+    if (universe.used[begin / 64] & mask) return false;
+    begin += n_bits;
+  }
+  return true;
+}
+
+std::optional<unsigned> ChannelOccupancy::FirstFreeSpan(
+    unsigned universe_index, size_t n_channels) const {
+  if (n_channels > kChannelsPerUniverse) return {};
+  if (universe_index >= universes_.size()) return 0;
+  const Universe &universe = universes_[universe_index];
+  size_t span_start = 0;
+  size_t channel = 0;
+  while (channel < kChannelsPerUniverse) {
+    const uint64_t bits = universe.used[channel / 64] >> (channel % 64);
+    if (bits == 0) {
+      // The remainder of this word is free
+      channel = (channel / 64 + 1) * 64;
+    } else {
+      channel += std::countr_zero(bits);
+      if (channel - span_start >= n_channels) return span_start;
+      // Skip the used channels
+      channel += std::countr_one(bits >> std::countr_zero(bits));
+      span_start = channel;
+    }
+  }
+  if (kChannelsPerUniverse - span_start >= n_channels)
+    return span_start;
+  else
+    return {};
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,91 @@
+#ifndef THEATRE_CHANNEL_OCCUPANCY_H_
+#define THEATRE_CHANNEL_OCCUPANCY_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "dmxchannel.h"
+#include "valueuniversesnapshot.h"
+
+namespace glight::theatre {
+
+/**
+ * Keeps track of which DMX channels are in use. For every universe, a
+ * bitmap of the used channels and the number of users per channel is
+ * stored. Channels are added and removed incrementally, and all queries
+ * only look at the bitmap of a single universe, which is a few machine
+ * words, so their cost does not depend on the number of fixtures.
+ */
+class ChannelOccupancy {
+ public:
+  void Clear() {
+    universes_.clear();
+    n_shared_channels_ = 0;
+  }
+
+  void Add(DmxChannel channel);
+  void Remove(DmxChannel channel);
+
+  size_t UniverseCount() const { return universes_.size(); }
+
+  /**
+   * Number of times that a channel was added (and not removed).
+   */
+  unsigned UseCount(DmxChannel channel) const {
+    return channel.Universe() < universes_.size()
+               ? universes_[channel.Universe()].counts[channel.Channel()]
+               : 0;
+  }
+  bool IsUsed(DmxChannel channel) const { return UseCount(channel) != 0; }
+
+  /**
+   * Highest used channel of a universe, or an empty optional if no channel
+   * of the universe is used.
+   */
+  std::optional<unsigned> HighestChannel(unsigned universe) const {
+    if (universe < universes_.size() && universes_[universe].end != 0)
+      return universes_[universe].end - 1;
+    else
+      return {};
+  }
+
+  /**
+   * True if none of the @p n_channels channels starting at @p first are
+   * used. Spans that run past the end of the universe are never free.
+   */
+  bool IsFree(DmxChannel first, size_t n_channels) const;
+
+  /**
+   * Lowest channel at which @p n_channels consecutive channels are free in
+   * the given universe, or an empty optional if there is no such span.
+   */
+  std::optional<unsigned> FirstFreeSpan(unsigned universe,
+                                        size_t n_channels) const;
+
+  /**
+   * Total number of channels that are used more than once, over all
+   * universes. Non-zero means that there are overlapping fixtures.
+   */
+  size_t SharedChannelCount() const { return n_shared_channels_; }
+
+ private:
+  static constexpr size_t kNWords = kChannelsPerUniverse / 64;
+
+  struct Universe {
+    std::array<uint64_t, kNWords> used{};
+    std::array<unsigned, kChannelsPerUniverse> counts{};
+    // One past the highest used channel, or zero if no channel is used
+    unsigned end = 0;
+  };
+
+  static void UpdateEnd(Universe &universe);
+
+  std::vector<Universe> universes_;
+  size_t n_shared_channels_ = 0;
+};
+
+}  // namespace glight::theatre
+
+#endif
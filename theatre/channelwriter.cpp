@@ -0,0 +1,183 @@
+#include "channelwriter.h"
+
+#include <algorithm>
+
+#include "fixturecontrol.h"
+
+namespace glight::theatre {
+
+namespace {
+// Shorter runs are written as separate coarse records
+constexpr unsigned kMinimumBlockSize = 2;
+}  // namespace
+
+void ChannelWriter::Compile(
+    const std::vector<FixtureControl *> &fixture_controls) {
+  // Clearing instead of recreating the lists keeps their capacity
+  for (Universe &universe : universes_) {
+    universe.groups.clear();
+    universe.coarse.clear();
+    universe.fine.clear();
+    universe.blocks.clear();
+    universe.pixels.clear();
+    universe.curves.clear();
+  }
+  for (const FixtureControl *control : fixture_controls) {
+    const std::vector<std::unique_ptr<FixtureFunction>> &functions =
+        control->GetFixture().Functions();
+    const std::vector<FixtureModeFunction> &mode_functions =
+        control->GetFixture().Mode().Functions();
+    for (size_t i = 0; i != functions.size(); ++i) {
+      const DmxChannel &main_channel = functions[i]->MainChannel();
+      if (main_channel.Universe() >= universes_.size())
+        universes_.resize(main_channel.Universe() + 1);
+      Universe &universe = universes_[main_channel.Universe()];
+      const std::shared_ptr<const ResponseCurve::Table> &curve =
+          mode_functions[i].Curve().GetTable();
+      if (curve && (universe.curves.empty() || universe.curves.back() != curve))
+        universe.curves.emplace_back(curve);
+      if (universe.groups.empty() ||
+          universe.groups.back().control != control) {
+        const unsigned n_coarse = universe.coarse.size();
+        const unsigned n_fine = universe.fine.size();
+        const unsigned n_pixels = universe.pixels.size();
+        universe.groups.emplace_back(Group{control, n_coarse, n_coarse, n_fine,
+                                           n_fine, 0, 0, n_pixels, n_pixels});
+      }
+      Group &group = universe.groups.back();
+      if (const unsigned n_cell_values = functions[i]->PixelCount() * 3;
+          n_cell_values != 0) {
+        // A block that runs past the end of the universe continues at its
+        // start, like DmxChannel::operator+ does.
+        const unsigned first = main_channel.Channel();
+        const unsigned size = std::min(n_cell_values, 512 - first);
+        universe.pixels.emplace_back(
+            PixelRecord{unsigned(i), first, 0, size, curve.get()});
+        if (size != n_cell_values) {
+          universe.pixels.emplace_back(PixelRecord{
+              unsigned(i), 0, size, n_cell_values - size, curve.get()});
+        }
+        group.pixel_end = universe.pixels.size();
+      } else if (const std::optional<DmxChannel> &fine_channel =
+                     functions[i]->FineChannel();
+                 fine_channel) {
+        universe.fine.emplace_back(
+            FineRecord{unsigned(i), main_channel.Channel(),
+                       fine_channel->Channel(), curve.get()});
+        group.fine_end = universe.fine.size();
+      } else {
+        universe.coarse.emplace_back(
+            CoarseRecord{unsigned(i), main_channel.Channel(), curve.get()});
+        group.coarse_end = universe.coarse.size();
+      }
+    }
+  }
+  for (Universe &universe : universes_) MakeBlocks(universe);
+}
+
+void ChannelWriter::MakeBlocks(Universe &universe) {
+  coarse_buffer_.swap(universe.coarse);
+  universe.coarse.clear();
+  const std::vector<CoarseRecord> &records = coarse_buffer_;
+  for (Group &group : universe.groups) {
+    const unsigned begin = group.coarse_begin;
+    const unsigned end = group.coarse_end;
+    group.coarse_begin = universe.coarse.size();
+    group.block_begin = universe.blocks.size();
+    unsigned i = begin;
+    while (i != end) {
+      unsigned run_end = i + 1;
+      if (!records[i].curve) {
+        while (run_end != end && !records[run_end].curve &&
+               records[run_end].value_index ==
+                   records[run_end - 1].value_index + 1 &&
+               records[run_end].channel == records[run_end - 1].channel + 1)
+          ++run_end;
+      }
+      if (run_end - i >= kMinimumBlockSize) {
+        universe.blocks.emplace_back(BlockRecord{
+            records[i].value_index, records[i].channel, run_end - i});
+      } else {
+        universe.coarse.insert(universe.coarse.end(), records.begin() + i,
+                               records.begin() + run_end);
+      }
+      i = run_end;
+    }
+    group.coarse_end = universe.coarse.size();
+    group.block_end = universe.blocks.size();
+  }
+}
+
+void ChannelWriter::Write(unsigned universe_index,
+                          unsigned *channel_values) const {
+  if (universe_index >= universes_.size()) return;
+  const Universe &universe = universes_[universe_index];
+  const CoarseRecord *coarse = universe.coarse.data();
+  const FineRecord *fine = universe.fine.data();
+  const BlockRecord *blocks = universe.blocks.data();
+  const PixelRecord *pixels = universe.pixels.data();
+  for (const Group &group : universe.groups) {
+    const ControlValue *values = group.control->FunctionValues();
+    for (unsigned i = group.coarse_begin; i != group.coarse_end; ++i) {
+      channel_values[coarse[i].channel] +=
+          ApplyCurve(coarse[i].curve, values[coarse[i].value_index].UInt());
+    }
+    for (unsigned i = group.block_begin; i != group.block_end; ++i) {
+      unsigned *block_channels = channel_values + blocks[i].channel;
+      const ControlValue *block_values = values + blocks[i].value_index;
+      for (unsigned j = 0; j != blocks[i].size; ++j)
+        block_channels[j] += block_values[j].UInt();
+    }
+    for (unsigned i = group.pixel_begin; i != group.pixel_end; ++i) {
+      const PixelRecord &record = pixels[i];
+      unsigned *block_channels = channel_values + record.channel;
+      const ControlValue *cells =
+          group.control->PixelValues(record.value_index).data() +
+          record.first_cell_value;
+      const unsigned flood = values[record.value_index].UInt();
+      if (record.curve) {
+        for (unsigned j = 0; j != record.size; ++j)
+          block_channels[j] += ResponseCurve::Lookup(
+              *record.curve, flood + cells[j].UInt());
+      } else {
+        for (unsigned j = 0; j != record.size; ++j)
+          block_channels[j] += flood + cells[j].UInt();
+      }
+    }
+    for (unsigned i = group.fine_begin; i != group.fine_end; ++i) {
+      // See FixtureFunction::MixChannels()
+      const FineRecord &record = fine[i];
+      const unsigned mixed = std::min(
+          channel_values[record.channel] +
+              (channel_values[record.fine_channel] >> 8) +
+              ApplyCurve(record.curve, values[record.value_index].UInt()),
+          ControlValue::MaxUInt());
+      channel_values[record.channel] = mixed & (~0xFFFF);
+      channel_values[record.fine_channel] = (mixed & 0xFFFF) << 8;
+    }
+  }
+}
+
+size_t ChannelWriter::RecordCount() const {
+  size_t count = 0;
+  for (const Universe &universe : universes_) {
+    count += universe.coarse.size() + universe.fine.size();
+    for (const BlockRecord &block : universe.blocks) count += block.size;
+    for (const PixelRecord &pixel : universe.pixels) count += pixel.size;
+  }
+  return count;
+}
+
+size_t ChannelWriter::PixelRecordCount() const {
+  size_t count = 0;
+  for (const Universe &universe : universes_) count += universe.pixels.size();
+  return count;
+}
+
+size_t ChannelWriter::BlockCount() const {
+  size_t count = 0;
+  for (const Universe &universe : universes_) count += universe.blocks.size();
+  return count;
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,120 @@
+#ifndef THEATRE_CHANNEL_WRITER_H_
+#define THEATRE_CHANNEL_WRITER_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "responsecurve.h"
+
+namespace glight::theatre {
+
+class FixtureControl;
+
+/**
+ * Writes the function values of fixture controls to DMX channels. The
+ * patch of all fixtures is compiled once into flat per-universe lists of
+ * records, so that writing a universe does not need to visit the fixture
+ * functions, check their universes or branch on whether they have a fine
+ * channel. Records are grouped per fixture control, such that the values
+ * of a control are looked up once per group. Response curves of the
+ * functions are applied while writing.
+ *
+ * Runs of 8-bit functions without a response curve that have consecutive
+ * function indices and consecutive channels, such as the cells of a pixel
+ * bar, are stored as a single block record. A block is written with one
+ * contiguous loop, which the compiler can vectorize.
+ *
+ * Pixel block functions are stored as pixel records, which write all cells
+ * of the block from the dense cell values of the fixture control in one
+ * loop.
+ *
+ * The records hold the patch as it was when @ref Compile() was called, so
+ * it needs to be called again after fixtures are re-patched.
+ */
+class ChannelWriter {
+ public:
+  void Compile(const std::vector<FixtureControl *> &fixture_controls);
+
+  /**
+   * Adds the values of the fixtures that are patched in the universe to
+   * @p channel_values, which should hold 512 values. The result is equal
+   * to calling @ref FixtureControl::GetChannelValues() for every compiled
+   * fixture control.
+   */
+  void Write(unsigned universe, unsigned *channel_values) const;
+
+  /**
+   * Number of channels that are written, counting every channel of a
+   * block and of a pixel block.
+   */
+  size_t RecordCount() const;
+
+  size_t BlockCount() const;
+
+  size_t PixelRecordCount() const;
+
+ private:
+  struct CoarseRecord {
+    unsigned value_index;
+    unsigned channel;
+    // Null for a linear response curve
+    const ResponseCurve::Table *curve;
+  };
+  struct FineRecord {
+    unsigned value_index;
+    unsigned channel;
+    unsigned fine_channel;
+    const ResponseCurve::Table *curve;
+  };
+  struct BlockRecord {
+    unsigned value_index;
+    unsigned channel;
+    unsigned size;
+  };
+  struct PixelRecord {
+    unsigned value_index;
+    unsigned channel;
+    // Index of the first written cell value in the pixel values of the
+    // function, which is not zero when a block wraps around the end of the
+    // universe.
+    unsigned first_cell_value;
+    unsigned size;
+    const ResponseCurve::Table *curve;
+  };
+  struct Group {
+    const FixtureControl *control;
+    unsigned coarse_begin;
+    unsigned coarse_end;
+    unsigned fine_begin;
+    unsigned fine_end;
+    unsigned block_begin;
+    unsigned block_end;
+    unsigned pixel_begin;
+    unsigned pixel_end;
+  };
+  struct Universe {
+    std::vector<Group> groups;
+    std::vector<CoarseRecord> coarse;
+    std::vector<FineRecord> fine;
+    std::vector<BlockRecord> blocks;
+    std::vector<PixelRecord> pixels;
+    // Keeps the tables of the records alive
+    std::vector<std::shared_ptr<const ResponseCurve::Table>> curves;
+  };
+
+  void MakeBlocks(Universe &universe);
+
+  static unsigned ApplyCurve(const ResponseCurve::Table *curve,
+                             unsigned value) {
+    return curve ? ResponseCurve::Lookup(*curve, value) : value;
+  }
+
+  std::vector<Universe> universes_;
+  // Temporary list used by MakeBlocks(), kept to reuse its capacity
+  std::vector<CoarseRecord> coarse_buffer_;
+};
+
+}  // namespace glight::theatre
+
+#endif
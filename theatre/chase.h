@@ -1,6 +1,9 @@
 #ifndef THEATRE_CHASE_H_
 #define THEATRE_CHASE_H_
 
+#include <cmath>
+
+#include "chasegroup.h"
 #include "controllable.h"
 #include "sequence.h"
 #include "timing.h"
@@ -15,6 +18,7 @@ namespace glight::theatre {
 class Chase final : public Controllable {
  public:
   Chase() : _phaseOffset(0.0) {}
+  ~Chase() { SetGroup(nullptr); }
 
   size_t NInputs() const override { return 1; }
 
@@ -64,8 +68,25 @@ class Chase final : public Controllable {
   const Sequence &GetSequence() const { return _sequence; }
   Sequence &GetSequence() { return _sequence; }
 
+  /**
+   * The group whose time base is used when this chase is delay triggered,
+   * or nullptr when the chase runs on its own time base.
+   */
+  ChaseGroup *GetGroup() const { return _group; }
+  void SetGroup(ChaseGroup *group) {
+    if (_group) _group->RemoveChase(*this);
+    _group = group;
+    if (_group) _group->AddChase(*this);
+  }
+
   void ShiftDelayTrigger(double triggerTime, double transitionTime,
                          double currentTime) {
+    if (_group) {
+      // The group sets the tempo, so no phase shift is necessary
+      _trigger.SetDelayInMs(triggerTime);
+      _transition.SetLengthInMs(transitionTime);
+      return;
+    }
     double currentDuration = _trigger.DelayInMs() + _transition.LengthInMs();
     double currentPhase = std::fmod(currentTime + _phaseOffset,
                                     currentDuration * _sequence.Size());
@@ -118,10 +139,15 @@ class Chase final : public Controllable {
   }
 
   void mixDelayChase(const Timing &timing) {
-    double timeInMs = timing.TimeInMS() + _phaseOffset;
-    double totalDuration = _trigger.DelayInMs() + _transition.LengthInMs();
-    double phase = std::fmod(timeInMs, totalDuration);
-    unsigned step = (unsigned)fmod(timeInMs / totalDuration, _sequence.Size());
+    const double totalDuration =
+        _trigger.DelayInMs() + _transition.LengthInMs();
+    // Position in steps
+    const double position =
+        _group ? _group->Position()
+               : (timing.TimeInMS() + _phaseOffset) / totalDuration;
+    const double wholeSteps = std::floor(position);
+    const double phase = (position - wholeSteps) * totalDuration;
+    const unsigned step = (unsigned)std::fmod(wholeSteps, _sequence.Size());
     if (phase < _trigger.DelayInMs()) {
       // We are not in a transition, just mix the corresponding controllable
       _sequence.List()[step].GetControllable()->MixInput(
@@ -144,6 +170,7 @@ class Chase final : public Controllable {
   Trigger _trigger;
   Transition _transition;
   double _phaseOffset;
+  ChaseGroup *_group = nullptr;
 };
 
 }  // namespace glight::theatre
@@ -0,0 +1,54 @@
+#include "chasegroup.h"
+
+#include "chase.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace glight::theatre {
+
+namespace {
+
+/** Shortest step duration in ms, to keep the position finite. */
+constexpr double kMinimumStepDuration = 1.0;
+
+/** Taps that are further apart than this (in ms) start a new tempo. */
+constexpr double kMaximumTapInterval = 10000.0;
+
+}  // namespace
+
+ChaseGroup::~ChaseGroup() {
+  while (!chases_.empty()) chases_.back()->SetGroup(nullptr);
+}
+
+void ChaseGroup::SetStepDuration(double step_duration) {
+  step_duration_ = std::max(step_duration, kMinimumStepDuration);
+}
+
+void ChaseGroup::Tap(double time_in_ms) {
+  if (previous_tap_) {
+    const double interval = time_in_ms - *previous_tap_;
+    if (interval > 0.0 && interval <= kMaximumTapInterval)
+      SetStepDuration(interval);
+  }
+  previous_tap_ = time_in_ms;
+  Advance(time_in_ms);
+  position_ = std::round(position_);
+}
+
+void ChaseGroup::Advance(double time_in_ms) {
+  // Time that goes backwards (e.g. a tap that is processed after a frame
+  // with a later time) does not move the position.
+  if (previous_time_ && time_in_ms > *previous_time_) {
+    position_ += (time_in_ms - *previous_time_) / step_duration_;
+  }
+  if (!previous_time_ || time_in_ms > *previous_time_)
+    previous_time_ = time_in_ms;
+}
+
+void ChaseGroup::RemoveChase(Chase &chase) {
+  chases_.erase(std::remove(chases_.begin(), chases_.end(), &chase),
+                chases_.end());
+}
+
+}  // namespace glight::theatre
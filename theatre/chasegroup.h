@@ -0,0 +1,83 @@
+#ifndef THEATRE_CHASE_GROUP_H_
+#define THEATRE_CHASE_GROUP_H_
+
+#include <optional>
+#include <vector>
+
+namespace glight::theatre {
+
+class Chase;
+
+/**
+ * A time base that is shared by a group of chases. The group holds one
+ * position, measured in steps, which is advanced once per frame. Delay
+ * triggered chases in the group take their step and the progress in the
+ * step from this position, instead of each calculating it from the time.
+ * Their own delay and transition times then only set the ratio between
+ * the delay and the transition within a step, while the group sets the
+ * tempo.
+ *
+ * Because all members read the same position, changing the tempo or
+ * tapping it re-phases all chases in the group at once, independent of
+ * the number of chases.
+ *
+ * The group is advanced by the mix thread, so a group of a running show
+ * should be changed through the functions of @ref Management that lock
+ * its mutex, such as Management::TapChaseGroup().
+ */
+class ChaseGroup {
+ public:
+  ChaseGroup() = default;
+  ~ChaseGroup();
+
+  ChaseGroup(const ChaseGroup &) = delete;
+  ChaseGroup &operator=(const ChaseGroup &) = delete;
+
+  /** Duration of one step (delay plus transition) of the chases, in ms. */
+  double StepDuration() const { return step_duration_; }
+  /**
+   * Changes the tempo. The position continues from where it is, so the
+   * chases keep their current step.
+   */
+  void SetStepDuration(double step_duration);
+
+  /**
+   * Registers a tap of the tempo at the given time. The interval between
+   * two taps becomes the step duration, and the nearest step boundary is
+   * moved to the tap.
+   */
+  void Tap(double time_in_ms);
+
+  /** Makes all chases of the group start at their first step. */
+  void Restart() { position_ = 0.0; }
+
+  /**
+   * Advances the position to the given time. This is called once per
+   * frame, before the chases are mixed.
+   */
+  void Advance(double time_in_ms);
+
+  /**
+   * Position in steps. The whole part counts the steps, and the fraction
+   * is the progress within the current step.
+   */
+  double Position() const { return position_; }
+
+  const std::vector<Chase *> &Chases() const { return chases_; }
+
+ private:
+  friend class Chase;
+
+  void AddChase(Chase &chase) { chases_.emplace_back(&chase); }
+  void RemoveChase(Chase &chase);
+
+  double step_duration_ = 1000.0;
+  double position_ = 0.0;
+  std::optional<double> previous_time_;
+  std::optional<double> previous_tap_;
+  std::vector<Chase *> chases_;
+};
+
+}  // namespace glight::theatre
+
+#endif
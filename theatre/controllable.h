@@ -1,6 +1,7 @@
 #ifndef THEATRE_CONTROL_H_
 #define THEATRE_CONTROL_H_
 
+#include <atomic>
 #include <string>
 
 #include "color.h"
@@ -70,6 +71,56 @@ class Controllable : public FolderObject {
       return Name() + " (" + AbbreviatedFunctionType(InputType(index)) + ")";
   }
 
+  /**
+   * Number that is increased whenever a reference returned by
+   * @ref InputValue() of any controllable might have become invalid, e.g.
+   * because a controllable reallocated its input values. Controllables that
+   * keep pointers to the inputs of others should resolve them again when
+   * this number changes.
+   */
+  static size_t InputGeneration() {
+    return input_generation_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Number that is increased whenever a setting of any controllable is
+   * changed, e.g. an effect property that is edited through a
+   * @ref PropertySet, or a setting of a filter. Caches of the engine that
+   * are derived from these settings store this number and only check the
+   * settings again when it has changed.
+   */
+  static size_t ShowGeneration() {
+    return show_generation_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Increases @ref ShowGeneration(). Should be called after changing a
+   * setting that is not a property of a controllable, such as a setting
+   * of a filter.
+   */
+  static void NotifyShowChange() {
+    show_generation_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Number that changes whenever a setting of this controllable has
+   * changed. See @ref NotifyPropertyChange(). Settings are changed from the
+   * GUI thread while the mix thread reads this, hence it is atomic.
+   */
+  size_t PropertyGeneration() const {
+    return property_generation_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Marks the settings of this controllable as changed, which increases
+   * both @ref PropertyGeneration() and @ref ShowGeneration(). This is
+   * called by @ref PropertySet after setting a property.
+   */
+  void NotifyPropertyChange() {
+    property_generation_.fetch_add(1, std::memory_order_relaxed);
+    NotifyShowChange();
+  }
+
   /**
    * Sets the value at the controllable's input.
    */
@@ -90,7 +141,19 @@ class Controllable : public FolderObject {
 
   void SetVisitLevel(char visitLevel) { _visitLevel = visitLevel; }
 
+ protected:
+  /**
+   * Should be called after the storage of the input values of this
+   * controllable was moved. See @ref InputGeneration().
+   */
+  static void InvalidateInputReferences() {
+    input_generation_.fetch_add(1, std::memory_order_relaxed);
+  }
+
  private:
+  inline static std::atomic<size_t> input_generation_ = 0;
+  inline static std::atomic<size_t> show_generation_ = 0;
+  std::atomic<size_t> property_generation_ = 0;
   ControlValue _inputValue;
   char _visitLevel;
 };
@@ -1,6 +1,7 @@
 #include "beatfinder.h"
 
-#include <cmath>
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -78,14 +79,15 @@ void BeatFinder::open() {
 
   std::vector<int16_t> alsaBuffer(period_size * 2);
 
-  _beat = Beat(0.0, 0.0);
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    beat_clock_ = BeatClock();
+  }
+  _confidence = 0.0;
   _audioLevel = 0;
   uint32_t audio_level_accumulator = 0;
   uint16_t nAudioLevels = 0;
-
-  unsigned samples_since_last_beat = 0;
-  unsigned last_beat_duration = std::numeric_limits<unsigned>::max();
-  enum class Stage { Start, Quarter, Half, ThreeQuarter } stage = Stage::Start;
+  uint64_t processed_samples = 0;
 
   while (!_isStopping) {
     rc = snd_pcm_readi(_handle, alsaBuffer.data(), period_size);
@@ -99,6 +101,8 @@ void BeatFinder::open() {
       if (rc != static_cast<int>(period_size))
         std::cout << "Only " << rc << " frames were read in snd_pcm_readi().\n";
     }
+    // Approximate time at which the last sample of this period was recorded
+    const double period_end_time = TimeInMS();
     uint32_t audioRMS = 0;
     for (size_t i = 0; i != period_size; ++i) {
       int16_t l = alsaBuffer[i * 2];
@@ -122,6 +126,7 @@ void BeatFinder::open() {
       audio_level_accumulator = 0;
     }
     aubio_tempo_do(tempo, ibuf, tempo_out);
+    processed_samples += period_size;
     const smpl_t is_beat = fvec_get_sample(tempo_out, 0);
     if (silence_threshold != -90)
       is_silence = aubio_silence_detection(ibuf, silence_threshold);
@@ -129,54 +134,22 @@ void BeatFinder::open() {
     if (is_beat && !is_silence) {
       const smpl_t confidence = aubio_tempo_get_confidence(tempo);
       if (confidence > _minimumConfidence) {
-        Beat beat = _beat;  // atomic load
-        beat.confidence = confidence;
-        // We do a simple reset on high numbers just to make sure that the
-        // 'float' precision does not run out. With 8 beats per second, this
-        // would still take 24h to run out.
-        if (beat.value < (60.0 * 60.0 * 24.0 * 8.0))
-          beat.value = std::floor(beat.value + 1);
-        else
-          beat.value = 0.0;
-        _beat = beat;  // atomic store
-        last_beat_duration = samples_since_last_beat;
-        samples_since_last_beat = 0;
-        stage = Stage::Start;
+        _confidence = confidence;
+        // Aubio reports the beat position with sample accuracy, which is
+        // used to date the beat more precisely than the period. The sample
+        // counter of aubio has 32 bits, so the difference is taken modulo
+        // 2^32 to remain correct after it wraps.
+        const uint32_t samples_ago = std::min<uint32_t>(
+            static_cast<uint32_t>(processed_samples) -
+                aubio_tempo_get_last(tempo),
+            samplerate);
+        const double beat_time =
+            period_end_time - samples_ago * 1000.0 / samplerate;
+        std::lock_guard<std::mutex> lock(_mutex);
+        beat_clock_.AddBeat(beat_time);
       }
     } else if (is_silence) {
-      Beat beat = _beat;  // atomic load
-      beat.confidence = 0.0;
-      _beat = beat;  // atomic store
-    }
-
-    ++samples_since_last_beat;
-    switch (stage) {
-      case Stage::Start:
-        if (samples_since_last_beat * 4 > last_beat_duration) {
-          stage = Stage::Quarter;
-          Beat beat = _beat;  // atomic load
-          beat.value += 0.25;
-          _beat = beat;
-        }
-        break;
-      case Stage::Quarter:
-        if (samples_since_last_beat * 2 > last_beat_duration) {
-          stage = Stage::Half;
-          Beat beat = _beat;  // atomic load
-          beat.value += 0.25;
-          _beat = beat;
-        }
-        break;
-      case Stage::Half:
-        if (samples_since_last_beat * 4 > last_beat_duration * 3) {
-          stage = Stage::ThreeQuarter;
-          Beat beat = _beat;  // atomic load
-          beat.value += 0.25;
-          _beat = beat;
-        }
-        break;
-      case Stage::ThreeQuarter:
-        break;
+      _confidence = 0.0;
     }
   }
   snd_pcm_drop(_handle);
@@ -4,12 +4,15 @@
 #include <alsa/asoundlib.h>
 
 #include <atomic>
+#include <chrono>
 #include <iostream>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 #include <thread>
 
+#include "../beatclock.h"
+
 namespace glight::theatre {
 
 class BeatFinder {
@@ -20,7 +23,13 @@ class BeatFinder {
         : runtime_error(std::string("Alsa error: ") + message) {}
   };
 
-  BeatFinder(const std::string &device_name) : device_name_(device_name) {}
+  /**
+   * @param time_origin Moment from which the times of the beat clock are
+   * measured.
+   */
+  BeatFinder(const std::string &device_name,
+             std::chrono::steady_clock::time_point time_origin)
+      : device_name_(device_name), time_origin_(time_origin) {}
 
   ~BeatFinder() { close(); }
 
@@ -29,9 +38,17 @@ class BeatFinder {
   }
 
   void GetBeatValue(double &beatValue, double &confidence) {
-    const Beat beat = _beat;
-    beatValue = beat.value;
-    confidence = beat.confidence;
+    beatValue = GetBeatClock().BeatValue(TimeInMS());
+    confidence = _confidence;
+  }
+
+  /**
+   * The beat clock holds the times of the detected beats in ms since the
+   * time origin, with sub-frame accuracy.
+   */
+  BeatClock GetBeatClock() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return beat_clock_;
   }
 
   uint16_t GetAudioLevel() const { return _audioLevel; }
@@ -52,17 +69,19 @@ class BeatFinder {
   std::atomic<bool> _isStopping = false;
   bool _isOpen = false;
   std::string device_name_;
+  std::chrono::steady_clock::time_point time_origin_;
   std::mutex _mutex;
-  struct Beat {
-    Beat() = default;
-    Beat(float c, float v) : value(v), confidence(c) {}
-    float value = 0.0;
-    float confidence = 0.0;
-  };
-  std::atomic<Beat> _beat = Beat();
+  BeatClock beat_clock_;
+  std::atomic<float> _confidence = 0.0;
   std::atomic<uint16_t> _audioLevel = 0;
   float _minimumConfidence = 0.05;
 
+  double TimeInMS() const {
+    const std::chrono::duration<double, std::milli> time =
+        std::chrono::steady_clock::now() - time_origin_;
+    return time.count();
+  }
+
   void open();
   void close();
 };
@@ -14,6 +14,7 @@
 #include "effects/hue_saturation_lightness_effect.h"
 #include "effects/inverteffect.h"
 #include "effects/musicactivationeffect.h"
+#include "effects/pixelmapeffect.h"
 #include "effects/pulseeffect.h"
 #include "effects/randomselecteffect.h"
 #include "effects/rgbmastereffect.h"
@@ -58,6 +59,8 @@ std::unique_ptr<Effect> Effect::Make(EffectType type) {
       return up(new InvertEffect());
     case ET::MusicActivation:
       return up(new MusicActivationEffect());
+    case ET::PixelMap:
+      return up(new PixelMapEffect());
     case ET::Pulse:
       return up(new PulseEffect());
     case ET::RandomSelect:
@@ -87,4 +90,16 @@ std::unique_ptr<Effect> Effect::Copy() const {
   return copy;
 }
 
+void Effect::ResolveTargets() const {
+  targets_generation_ = InputGeneration();
+  targets_.clear();
+  targets_.reserve(outputs_.size());
+  for (const std::pair<Controllable *, size_t> &connection : outputs_) {
+    targets_.emplace_back(
+        OutputTarget{&connection.first->InputValue(connection.second),
+                     connection.first->InputType(connection.second)});
+  }
+  targets_are_resolved_ = true;
+}
+
 }  // namespace glight::theatre
@@ -9,6 +9,7 @@
 #include <sigc++/connection.h>
 
 #include <algorithm>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
@@ -30,10 +31,12 @@ class Effect : public Controllable {
 
   void AddConnection(Controllable &controllable, size_t input) {
     outputs_.emplace_back(&controllable, input);
+    targets_are_resolved_ = false;
     on_delete_connections_.emplace_back(
         controllable.SignalDelete().connect([&controllable, input, this]() {
           RemoveConnection(controllable, input);
         }));
+    OnConnectionsChanged();
   }
 
   void RemoveConnection(Controllable &controllable, size_t input) {
@@ -49,8 +52,10 @@ class Effect : public Controllable {
 
   void RemoveConnection(size_t index) {
     outputs_.erase(outputs_.begin() + index);
+    targets_are_resolved_ = false;
     on_delete_connections_[index].disconnect();
     on_delete_connections_.erase(on_delete_connections_.begin() + index);
+    OnConnectionsChanged();
   }
 
   const std::vector<std::pair<Controllable *, size_t>> &Connections() const {
@@ -81,25 +86,66 @@ class Effect : public Controllable {
   }
 
  protected:
+  /**
+   * An output connection, resolved to the input value that it writes to.
+   */
+  struct OutputTarget {
+    ControlValue *value;
+    FunctionType type;
+  };
+
   virtual void MixImplementation(const ControlValue *inputValues,
                                  const Timing &timing, bool primary) = 0;
 
+  /**
+   * Called after a connection was added or removed. Effects that keep
+   * state per connection can (re)allocate it here, so that mixing does not
+   * need to allocate.
+   */
+  virtual void OnConnectionsChanged() {}
+
+  /**
+   * The input values that the output connections write to, in the same
+   * order as @ref Connections(). They are resolved on first use, and again
+   * after the connections changed or @ref Controllable::InputGeneration()
+   * changed, so that effects with many connections can write all outputs
+   * in one loop without a virtual call per connection.
+   */
+  std::span<const OutputTarget> OutputTargets() const {
+    if (!targets_are_resolved_ || targets_generation_ != InputGeneration())
+      ResolveTargets();
+    return targets_;
+  }
+
+  /**
+   * Mixes a value into an output target, equal to calling
+   * @ref Controllable::MixInput() for the corresponding connection.
+   */
+  static void MixOutput(const OutputTarget &target, const ControlValue &value) {
+    *target.value += value;
+  }
+
   /**
    * Output the provided value to all output connections. Because
    * inputs are where the values are stored, this implies that this
    * function sets the inputs of the connected objects.
    */
   void setAllOutputs(const ControlValue &value) const {
-    for (const std::pair<Controllable *, size_t> &connection : Connections())
-      connection.first->MixInput(connection.second, value);
+    for (const OutputTarget &target : OutputTargets())
+      MixOutput(target, value);
   }
 
  private:
   friend class EffectControl;
 
+  void ResolveTargets() const;
+
   std::vector<ControlValue> input_values_;
   std::vector<std::pair<Controllable *, size_t>> outputs_;
   std::vector<sigc::connection> on_delete_connections_;
+  mutable std::vector<OutputTarget> targets_;
+  mutable bool targets_are_resolved_ = false;
+  mutable size_t targets_generation_ = 0;
 };
 
 }  // namespace glight::theatre
@@ -40,8 +40,8 @@ class AudioLevelEffect final : public Effect {
     unsigned v = ControlValue::Mix(_lastValue[primary], values[0].UInt(),
                                    MixStyle::Multiply);
     ControlValue audioLevelCV(v);
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      connection.first->MixInput(connection.second, audioLevelCV);
+    for (const OutputTarget &target : OutputTargets()) {
+      MixOutput(target, audioLevelCV);
     }
   }
 
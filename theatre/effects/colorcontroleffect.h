@@ -43,49 +43,49 @@ class ColorControlEffect final : public Effect {
  protected:
   virtual void MixImplementation(const ControlValue *values,
                                  const Timing &timing, bool primary) override {
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      switch (connection.first->InputType(connection.second)) {
+    for (const OutputTarget &target : OutputTargets()) {
+      switch (target.type) {
         case FunctionType::Red: {
           const ControlValue v = values[0] * values[1];
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::Green: {
           const ControlValue v = values[0] * values[2];
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::Blue: {
           const ControlValue v = values[0] * values[3];
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::White: {
           const ControlValue v =
               values[0] * DeduceWhite(values[1], values[2], values[3]);
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::Amber: {
           const ControlValue v =
               values[0] * DeduceAmber(values[1], values[2], values[3]);
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::UV: {
           const ControlValue v =
               values[0] * DeduceUv(values[1], values[2], values[3]);
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::Lime: {
           const ControlValue v =
               values[0] * DeduceLime(values[1], values[2], values[3]);
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::ColdWhite: {
           const ControlValue v =
               values[0] * DeduceColdWhite(values[1], values[2], values[3]);
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         case FunctionType::WarmWhite: {
           const ControlValue v =
               values[0] * DeduceWarmWhite(values[1], values[2], values[3]);
-          connection.first->MixInput(connection.second, v);
+          MixOutput(target, v);
         } break;
         default:
           break;
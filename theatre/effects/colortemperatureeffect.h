@@ -4,6 +4,9 @@
 #include "../effect.h"
 #include "../../system/colortemperature.h"
 
+#include <algorithm>
+#include <array>
+
 namespace glight::theatre {
 
 class ColorTemperatureEffect final : public Effect {
@@ -24,42 +27,41 @@ class ColorTemperatureEffect final : public Effect {
 
   void SetMinimumTemperature(unsigned temperature) {
     min_temperature_ = temperature;
+    NotifyPropertyChange();
   }
 
   unsigned MaximumTemperature() const { return max_temperature_; }
 
   void SetMaximumTemperature(unsigned temperature) {
     max_temperature_ = temperature;
+    NotifyPropertyChange();
   }
 
  protected:
   virtual void MixImplementation(const ControlValue *values, const Timing &,
                                  bool) override {
-    const unsigned range =
-        std::min(40000u, max_temperature_ - min_temperature_);
-    const unsigned scaled_value = values[0].UInt() >> 14;  // make 10 bit
-    const unsigned temperature =
-        min_temperature_ + ((range * scaled_value) >> 10);
-    const theatre::Color rgb = system::TemperatureToRgb(temperature);
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      switch (connection.first->InputType(connection.second)) {
+    if (!table_is_valid_ || table_generation_ != PropertyGeneration())
+      UpdateTable();
+    // Make 10 bit. Inputs can add up to more than the maximum.
+    const unsigned scaled_value =
+        std::min(values[0].UInt(), ControlValue::MaxUInt()) >> 14;
+    const theatre::Color &rgb = table_[scaled_value];
+    for (const OutputTarget &target : OutputTargets()) {
+      switch (target.type) {
         case FunctionType::Red:
-          connection.first->MixInput(
-              connection.second,
-              ControlValue(static_cast<int>(rgb.Red()) << 16) * values[1]);
+          MixOutput(target, ControlValue(static_cast<int>(rgb.Red()) << 16) *
+                                values[1]);
           break;
         case FunctionType::Green:
-          connection.first->MixInput(
-              connection.second,
-              ControlValue(static_cast<int>(rgb.Green()) << 16) * values[1]);
+          MixOutput(target, ControlValue(static_cast<int>(rgb.Green()) << 16) *
+                                values[1]);
           break;
         case FunctionType::Blue:
-          connection.first->MixInput(
-              connection.second,
-              ControlValue(static_cast<int>(rgb.Blue()) << 16) * values[1]);
+          MixOutput(target, ControlValue(static_cast<int>(rgb.Blue()) << 16) *
+                                values[1]);
           break;
         case FunctionType::White:
-          connection.first->MixInput(connection.second, values[1]);
+          MixOutput(target, values[1]);
           break;
         case FunctionType::Amber:
           // TODO
@@ -83,8 +85,30 @@ class ColorTemperatureEffect final : public Effect {
   }
 
  private:
+  /**
+   * Converting a temperature to RGB is expensive, so the colours of all
+   * 1024 input steps are calculated once, and again only after the
+   * temperature range has changed.
+   */
+  void UpdateTable() {
+    // The generation is read first, so that a change during the update
+    // causes another update
+    const size_t generation = PropertyGeneration();
+    const unsigned range =
+        std::min(40000u, max_temperature_ - min_temperature_);
+    for (unsigned i = 0; i != table_.size(); ++i) {
+      const unsigned temperature = min_temperature_ + ((range * i) >> 10);
+      table_[i] = system::TemperatureToRgb(temperature);
+    }
+    table_generation_ = generation;
+    table_is_valid_ = true;
+  }
+
   unsigned min_temperature_ = 1500;
   unsigned max_temperature_ = 15000;
+  bool table_is_valid_ = false;
+  size_t table_generation_ = 0;
+  std::array<theatre::Color, 1024> table_;
 };
 
 }  // namespace glight::theatre
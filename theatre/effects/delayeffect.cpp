@@ -0,0 +1,115 @@
+#include "delayeffect.h"
+
+#include "../timing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace glight::theatre {
+
+namespace {
+
+/**
+ * Duration of a slot for short delays. This is well below the interval
+ * between DMX frames (about 23 ms), so that a delay is rounded to at most a
+ * fraction of a frame.
+ */
+constexpr double kMinimumSlotDuration = 5.0;
+
+/**
+ * For very long delays, slots are made longer to keep the number of slots
+ * below this value.
+ */
+constexpr size_t kMaximumSlots = 16384;
+
+}  // namespace
+
+DelayEffect::DelayEffect() : Effect(1) { Resize(delay_in_ms_, taps_); }
+
+void DelayEffect::SetDelayInMS(double delay_in_ms) {
+  delay_in_ms_ = std::max(delay_in_ms, 0.0);
+}
+
+void DelayEffect::SetTaps(size_t taps) { taps_ = std::max<size_t>(taps, 1); }
+
+size_t DelayEffect::Capacity() const { return SlotCount(delay_in_ms_ * taps_); }
+
+double DelayEffect::SlotDuration(double longest_delay) {
+  return std::max(kMinimumSlotDuration, longest_delay / (kMaximumSlots - 2));
+}
+
+size_t DelayEffect::SlotCount(double longest_delay) {
+  // One slot for the current value, one for rounding, and the delayed ones
+  return static_cast<size_t>(
+             std::ceil(longest_delay / SlotDuration(longest_delay))) +
+         2;
+}
+
+void DelayEffect::Resize(double delay_in_ms, size_t taps) {
+  ring_delay_in_ms_ = delay_in_ms;
+  ring_taps_ = taps;
+  const double longest_delay = delay_in_ms * taps;
+  slot_duration_ = SlotDuration(longest_delay);
+  const size_t capacity = SlotCount(longest_delay);
+  for (History &history : history_) {
+    history.values.assign(capacity, ControlValue::Zero());
+    history.last_slot = -1;
+  }
+}
+
+void DelayEffect::Write(History &history, int64_t slot,
+                        const ControlValue &value, unsigned timestep) {
+  const int64_t size = history.values.size();
+  if (history.last_slot >= 0 && timestep == history.last_timestep) {
+    // Mixed more than once in the same timestep: combine the values
+    ControlValue &current = history.values[history.last_slot % size];
+    current.Set(
+        ControlValue::Mix(current.UInt(), value.UInt(), MixStyle::Default));
+    return;
+  }
+  if (history.last_slot >= 0 && slot > history.last_slot) {
+    // The input is held until the current slot. Slots that are more than
+    // one ring ago are overwritten anyway.
+    const ControlValue held = Read(history, history.last_slot);
+    const int64_t first = std::max(history.last_slot + 1, slot - size + 1);
+    for (int64_t i = first; i != slot; ++i) {
+      history.values[i % size] = held;
+    }
+  }
+  history.values[slot % size] = value;
+  history.last_slot = slot;
+  history.last_timestep = timestep;
+}
+
+void DelayEffect::MixImplementation(const ControlValue *values,
+                                    const Timing &timing, bool primary) {
+  // The settings are read once, because they may be changed while mixing
+  const double delay_in_ms = delay_in_ms_;
+  const size_t taps = taps_;
+  if (delay_in_ms != ring_delay_in_ms_ || taps != ring_taps_)
+    Resize(delay_in_ms, taps);
+  History &history = history_[primary];
+  const int64_t slot = std::max<int64_t>(
+      0, static_cast<int64_t>(timing.TimeInMS() / slot_duration_));
+  if (slot < history.last_slot) {
+    // Time went backwards: the history is no longer valid
+    history.values.assign(history.values.size(), ControlValue::Zero());
+    history.last_slot = -1;
+  }
+  Write(history, slot, values[0], timing.TimestepNumber());
+
+  const std::span<const OutputTarget> targets = OutputTargets();
+  const double time = timing.TimeInMS();
+  size_t tap = 0;
+  for (const OutputTarget &target : targets) {
+    const double delay = delay_in_ms * (tap + 1);
+    const int64_t read_slot =
+        static_cast<int64_t>(std::floor((time - delay) / slot_duration_));
+    // Slots before the first write have never been written and are zero
+    if (read_slot >= 0) MixOutput(target, Read(history, read_slot));
+    ++tap;
+    if (tap == taps) tap = 0;
+  }
+}
+
+}  // namespace glight::theatre
@@ -2,74 +2,76 @@
 #define DELAY_EFFECT_H
 
 #include <array>
+#include <cstdint>
 #include <vector>
 
 #include "../effect.h"
-#include "../timing.h"
 
 namespace glight::theatre {
 
+/**
+ * Outputs its input after a delay. With more than one tap, the effect
+ * outputs several delayed copies: tap i is delayed by (i + 1) times the
+ * delay, and connection j receives tap (j modulo the number of taps). This
+ * makes it possible to make echo chases with a single effect.
+ *
+ * The input history is stored in a ring of fixed-duration slots, sized
+ * from the longest delay. Every slot holds the input value at that time, so
+ * reading a tap is a single indexed lookup, and the memory use does not
+ * depend on how often the effect is mixed. The setters only store the new
+ * settings: the ring is resized by the mix itself, so that changing the
+ * settings of a running effect never frees a ring that is being mixed.
+ */
 class DelayEffect final : public Effect {
  public:
-  DelayEffect()
-      : Effect(1),
-        _previousTimestep{0, 0},
-        _buffer{std::vector<std::pair<double, ControlValue>>(
-                    2, std::pair<double, ControlValue>(0.0, 0)),
-                std::vector<std::pair<double, ControlValue>>(
-                    2, std::pair<double, ControlValue>(0.0, 0))},
-        _bufferReadPos{0, 0},
-        _bufferWritePos{0, 0},
-        _delayInMS(100.0) {}
+  DelayEffect();
 
-  virtual EffectType GetType() const override { return EffectType::Delay; }
+  EffectType GetType() const override { return EffectType::Delay; }
 
-  double DelayInMS() const { return _delayInMS; }
-  void SetDelayInMS(double delayInMS) { _delayInMS = delayInMS; }
+  double DelayInMS() const { return delay_in_ms_; }
+  void SetDelayInMS(double delay_in_ms);
+
+  size_t GetTaps() const { return taps_; }
+  void SetTaps(size_t taps);
+
+  /**
+   * Number of slots in the history of one input with the current settings,
+   * for testing.
+   */
+  size_t Capacity() const;
 
  protected:
-  virtual void MixImplementation(const ControlValue *values,
-                                 const Timing &timing, bool primary) override {
-    std::vector<std::pair<double, ControlValue>> &buffer = _buffer[primary];
-    if (_previousTimestep[primary] == timing.TimestepNumber()) {
-      unsigned prevWritePos =
-          (_bufferWritePos[primary] + buffer.size() - 1) % buffer.size();
-      buffer[prevWritePos].second.Set(
-          ControlValue::Mix(buffer[prevWritePos].second.UInt(),
-                            values[0].UInt(), MixStyle::Default));
-    } else {
-      _previousTimestep[primary] = timing.TimestepNumber();
-      buffer[_bufferWritePos[primary]].first = timing.TimeInMS();
-      buffer[_bufferWritePos[primary]].second = values[0];
-      _bufferWritePos[primary] = (_bufferWritePos[primary] + 1) % buffer.size();
-      if (_bufferWritePos[primary] == _bufferReadPos[primary]) {
-        // Increase size of circular buffer
-        size_t n = buffer.size();
-        _bufferReadPos[primary] += n;
-        buffer.resize(buffer.size() * 2);
-        std::copy_backward(buffer.begin() + _bufferWritePos[primary],
-                           buffer.begin() + n,
-                           buffer.begin() + _bufferReadPos[primary]);
-      }
-      while (_bufferReadPos[primary] != _bufferWritePos[primary] &&
-             buffer[_bufferReadPos[primary]].first + _delayInMS <
-                 timing.TimeInMS()) {
-        _bufferReadPos[primary] = (_bufferReadPos[primary] + 1) % buffer.size();
-      }
-    }
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      connection.first->MixInput(connection.second,
-                                 buffer[_bufferReadPos[primary]].second);
-    }
-  }
+  void MixImplementation(const ControlValue *values, const Timing &timing,
+                         bool primary) override;
 
  private:
-  unsigned _previousTimestep[2];
-  std::array<std::vector<std::pair<double, ControlValue>>, 2> _buffer;
-  size_t _bufferReadPos[2];
-  size_t _bufferWritePos[2];
+  struct History {
+    std::vector<ControlValue> values;
+    /** Slot number of the last write, or -1 if nothing was written. */
+    int64_t last_slot = -1;
+    unsigned last_timestep = 0;
+  };
+
+  /** Duration of a slot for the given longest delay. */
+  static double SlotDuration(double longest_delay);
+  /** Number of slots in a ring for the given longest delay. */
+  static size_t SlotCount(double longest_delay);
+  void Resize(double delay_in_ms, size_t taps);
+  void Write(History &history, int64_t slot, const ControlValue &value,
+             unsigned timestep);
+  const ControlValue &Read(const History &history, int64_t slot) const {
+    const int64_t size = history.values.size();
+    return history.values[((slot % size) + size) % size];
+  }
 
-  double _delayInMS;
+  double delay_in_ms_ = 100.0;
+  size_t taps_ = 1;
+  // The settings for which the ring was sized, which may lag behind the
+  // above settings until the next mix.
+  double ring_delay_in_ms_;
+  size_t ring_taps_;
+  double slot_duration_;
+  std::array<History, 2> history_;
 };
 
 }  // namespace glight::theatre
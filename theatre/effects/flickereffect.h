@@ -49,9 +49,9 @@ class FlickerEffect final : public Effect {
       }
 
       if (_independentOutputs) {
-        for (size_t i = 0; i != Connections().size(); ++i) {
-          Connections()[i].first->MixInput(Connections()[i].second,
-                                           values[0] * ControlValue(value[i]));
+        const std::span<const OutputTarget> targets = OutputTargets();
+        for (size_t i = 0; i != targets.size(); ++i) {
+          MixOutput(targets[i], values[0] * ControlValue(value[i]));
         }
       } else {
         setAllOutputs(values[0] * ControlValue(value[0]));
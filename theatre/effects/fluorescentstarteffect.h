@@ -75,8 +75,7 @@ class FluorescentStartEffect final : public Effect {
         else
           value = _glowValue;
         if (_independentOutputs) {
-          Connections()[i].first->MixInput(Connections()[i].second,
-                                           values[0] * ControlValue(value));
+          MixOutput(OutputTargets()[i], values[0] * ControlValue(value));
         } else {
           setAllOutputs(values[0] * ControlValue(value));
         }
@@ -0,0 +1,143 @@
+#include "functiongeneratoreffect.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace glight::theatre {
+
+namespace {
+
+constexpr size_t kSineTableSize = 4096;
+
+// Two extra entries, so that a phase of exactly 1.0 (which can occur
+// after subtracting an offset) can still be interpolated.
+using SineTable = std::array<double, kSineTableSize + 2>;
+
+SineTable MakeSineTable() {
+  SineTable table;
+  for (size_t i = 0; i != table.size(); ++i)
+    table[i] = std::sin(double(i) * 2.0 * M_PI / kSineTableSize);
+  return table;
+}
+
+const SineTable sine_table = MakeSineTable();
+
+/**
+ * Linearly interpolated sin(2 pi phase), with phase in [0, 1]. The maximum
+ * error is about 3e-7, which is below the resolution of a 16-bit channel.
+ */
+double TableSine(double phase) {
+  const double position = phase * kSineTableSize;
+  const size_t index = static_cast<size_t>(position);
+  const double fraction = position - index;
+  return sine_table[index] +
+         (sine_table[index + 1] - sine_table[index]) * fraction;
+}
+
+uint64_t SplitMix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+/**
+ * Evaluates a waveform for all outputs. The waveform is passed as a
+ * lambda, such that the loop is specialized (and can be vectorized) for
+ * each function, instead of switching on the function per output.
+ */
+template <typename WaveFunction>
+void Evaluate(std::vector<double> &outputs, const std::vector<double> &offsets,
+              double phase, WaveFunction wave_function) {
+  for (size_t i = 0; i != outputs.size(); ++i) {
+    double output_phase = phase - offsets[i];
+    if (output_phase < 0.0) output_phase += 1.0;
+    outputs[i] = wave_function(output_phase);
+  }
+}
+
+}  // namespace
+
+void FunctionGeneratorEffect::UpdatePhaseOffsets(size_t n) {
+  phase_offsets_.resize(n);
+  for (size_t i = 0; i != n; ++i) {
+    switch (spread_) {
+      case Spread::None:
+        phase_offsets_[i] = 0.0;
+        break;
+      case Spread::Linear:
+        phase_offsets_[i] = double(i) / n;
+        break;
+      case Spread::CenterOut:
+        phase_offsets_[i] = std::abs(2.0 * i - double(n - 1)) / (2.0 * n);
+        break;
+      case Spread::Random:
+        // Use the top 53 bits to make a double in [0, 1)
+        phase_offsets_[i] = double(SplitMix64(i) >> 11) * 0x1.0p-53;
+        break;
+    }
+  }
+}
+
+void FunctionGeneratorEffect::MixSpread(const ControlValue &input,
+                                        const Timing &timing, bool primary) {
+  const std::span<const OutputTarget> targets = OutputTargets();
+  if (phase_offsets_.size() != targets.size())
+    UpdatePhaseOffsets(targets.size());
+  outputs_.resize(targets.size());
+  const double phase = std::fmod(timing.TimeInMS(), period_) / period_;
+  switch (function_) {
+    case Function::Sine:
+      Evaluate(outputs_, phase_offsets_, phase,
+               [](double p) { return TableSine(p); });
+      break;
+    case Function::Cosine:
+      Evaluate(outputs_, phase_offsets_, phase, [](double p) {
+        return TableSine(p < 0.75 ? p + 0.25 : p - 0.75);
+      });
+      break;
+    case Function::Square:
+      Evaluate(outputs_, phase_offsets_, phase,
+               [](double p) { return p < 0.5 ? 1.0 : -1.0; });
+      break;
+    case Function::Sawtooth:
+      Evaluate(outputs_, phase_offsets_, phase,
+               [](double p) { return p * 2.0 - 1.0; });
+      break;
+    case Function::Triangle:
+      Evaluate(outputs_, phase_offsets_, phase, [](double p) {
+        return p < 0.5 ? 4.0 * p - 1.0 : 3.0 - 4.0 * p;
+      });
+      break;
+    case Function::Staircase:
+      Evaluate(outputs_, phase_offsets_, phase, [](double p) {
+        return std::floor(p * 4.9999) * 0.5 - 1.0;
+      });
+      break;
+    case Function::Strobe: {
+      // An output flashes for one frame when its shifted phase wraps
+      const double time = timing.TimeInMS() / period_;
+      const double previous = previous_time_[primary] / period_;
+      const bool first =
+          previous_time_[primary] < 0.0 || time - previous >= 1.0;
+      for (size_t i = 0; i != outputs_.size(); ++i) {
+        const bool flash =
+            first || std::floor(time - phase_offsets_[i]) !=
+                         std::floor(previous - phase_offsets_[i]);
+        outputs_[i] = flash ? 1.0 : -1.0;
+      }
+    } break;
+  }
+  previous_time_[primary] = timing.TimeInMS();
+
+  const double amplitude = invert_ ? -amplitude_.Ratio() : amplitude_.Ratio();
+  const double offset = offset_.Ratio();
+  const unsigned input_value = input.UInt();
+  for (size_t i = 0; i != targets.size(); ++i) {
+    const double output =
+        std::clamp(outputs_[i] * amplitude + offset, 0.0, 1.0) * input_value;
+    MixOutput(targets[i], ControlValue(output));
+  }
+}
+
+}  // namespace glight::theatre
@@ -2,6 +2,7 @@
 #define THEATRE_FUNCTION_GENERATOR_EFFECT_H_
 
 #include <array>
+#include <vector>
 
 #include "../effect.h"
 
@@ -21,6 +22,25 @@ class FunctionGeneratorEffect final : public Effect {
     Strobe
   };
 
+  /**
+   * How the phase of the waveform is spread over the connected outputs.
+   * With a spread, output i lags behind by a fraction of the period, so
+   * that a single effect produces a wave that travels over its outputs.
+   */
+  enum class Spread {
+    /** All outputs receive the same value. */
+    None,
+    /** Output i lags by i / n periods. */
+    Linear,
+    /** The wave starts in the middle and travels towards both ends. */
+    CenterOut,
+    /**
+     * Every output has a fixed pseudo-random offset. The offset of an
+     * output only depends on its index.
+     */
+    Random
+  };
+
   FunctionGeneratorEffect() : Effect(1) {}
 
   virtual EffectType GetType() const override {
@@ -45,9 +65,19 @@ class FunctionGeneratorEffect final : public Effect {
   void SetOffset(ControlValue value) { offset_ = value; }
   ControlValue GetOffset() const { return offset_; }
 
+  void SetSpread(Spread spread) {
+    spread_ = spread;
+    phase_offsets_.clear();
+  }
+  Spread GetSpread() const { return spread_; }
+
  protected:
   virtual void MixImplementation(const ControlValue *values,
                                  const Timing &timing, bool primary) override {
+    if (spread_ != Spread::None) {
+      MixSpread(values[0], timing, primary);
+      return;
+    }
     const double phase = std::fmod(timing.TimeInMS(), period_) / period_;
     double output = 0;
     switch (function_) {
@@ -89,12 +119,22 @@ class FunctionGeneratorEffect final : public Effect {
   }
 
  private:
+  void MixSpread(const ControlValue &input, const Timing &timing,
+                 bool primary);
+  void UpdatePhaseOffsets(size_t n);
+
   Function function_ = Function::Sine;
   bool invert_ = false;
   ControlValue offset_ = ControlValue::Max() / 2;
   ControlValue amplitude_ = ControlValue::Max() / 2;
   double period_ = 750.0;
   std::array<double, 2> next_strobe_time_ = {0.0, 0.0};
+  Spread spread_ = Spread::None;
+  // Per output lag as fraction of the period, in [0, 1)
+  std::vector<double> phase_offsets_;
+  // Per output waveform value, reused between frames
+  std::vector<double> outputs_;
+  std::array<double, 2> previous_time_ = {-1.0, -1.0};
 };
 
 }  // namespace glight::theatre
@@ -99,49 +99,43 @@ void HueSaturationLightnessEffect::MixImplementation(const ControlValue *values,
                                                      bool /*primary*/) {
   // TODO cache
   std::array<ControlValue, 3> rgb = Convert(values[0], values[1], values[2]);
-  for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-    switch (connection.first->InputType(connection.second)) {
+  for (const OutputTarget &target : OutputTargets()) {
+    switch (target.type) {
       case FunctionType::Red:
-        connection.first->MixInput(connection.second, rgb[0]);
+        MixOutput(target, rgb[0]);
         break;
       case FunctionType::Green:
-        connection.first->MixInput(connection.second, rgb[1]);
+        MixOutput(target, rgb[1]);
         break;
       case FunctionType::Blue:
-        connection.first->MixInput(connection.second, rgb[2]);
+        MixOutput(target, rgb[2]);
         break;
       case FunctionType::White:
-        connection.first->MixInput(connection.second,
-                                   DeduceWhite(rgb[0], rgb[1], rgb[2]));
+        MixOutput(target, DeduceWhite(rgb[0], rgb[1], rgb[2]));
         break;
       case FunctionType::Amber:
-        connection.first->MixInput(connection.second,
-                                   DeduceAmber(rgb[0], rgb[1], rgb[2]));
+        MixOutput(target, DeduceAmber(rgb[0], rgb[1], rgb[2]));
         break;
       case FunctionType::UV:
-        connection.first->MixInput(connection.second,
-                                   DeduceUv(rgb[0], rgb[1], rgb[2]));
+        MixOutput(target, DeduceUv(rgb[0], rgb[1], rgb[2]));
         break;
       case FunctionType::Lime:
-        connection.first->MixInput(connection.second,
-                                   DeduceLime(rgb[0], rgb[1], rgb[2]));
+        MixOutput(target, DeduceLime(rgb[0], rgb[1], rgb[2]));
         break;
       case FunctionType::ColdWhite:
-        connection.first->MixInput(connection.second,
-                                   DeduceColdWhite(rgb[0], rgb[1], rgb[2]));
+        MixOutput(target, DeduceColdWhite(rgb[0], rgb[1], rgb[2]));
         break;
       case FunctionType::WarmWhite:
-        connection.first->MixInput(connection.second,
-                                   DeduceWarmWhite(rgb[0], rgb[1], rgb[2]));
+        MixOutput(target, DeduceWarmWhite(rgb[0], rgb[1], rgb[2]));
         break;
       case FunctionType::Hue:
-        connection.first->MixInput(connection.second, values[0]);
+        MixOutput(target, values[0]);
         break;
       case FunctionType::Saturation:
-        connection.first->MixInput(connection.second, values[1]);
+        MixOutput(target, values[1]);
         break;
       case FunctionType::Lightness:
-        connection.first->MixInput(connection.second, values[2]);
+        MixOutput(target, values[2]);
         break;
       default:
         break;
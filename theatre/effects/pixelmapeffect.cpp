@@ -0,0 +1,238 @@
+#include "pixelmapeffect.h"
+
+#include "../colordeduction.h"
+#include "../fixture.h"
+#include "../fixturecontrol.h"
+#include "../timing.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+
+namespace glight::theatre {
+
+namespace {
+
+double Fraction(double x) { return x - std::floor(x); }
+
+/** Hash of a lattice point, returned as value in [0, 1]. */
+double LatticeValue(int64_t x, int64_t y) {
+  uint64_t h =
+      (uint64_t(x) * 0x9e3779b97f4a7c15) ^ (uint64_t(y) * 0xc2b2ae3d27d4eb4f);
+  h = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9;
+  h ^= h >> 32;
+  return double(h & 0xFFFFFF) / double(0xFFFFFF);
+}
+
+/** Smoothly interpolated value noise in [0, 1]. */
+double ValueNoise(double x, double y) {
+  const double fx = std::floor(x);
+  const double fy = std::floor(y);
+  const int64_t ix = static_cast<int64_t>(fx);
+  const int64_t iy = static_cast<int64_t>(fy);
+  double tx = x - fx;
+  double ty = y - fy;
+  tx = tx * tx * (3.0 - 2.0 * tx);
+  ty = ty * ty * (3.0 - 2.0 * ty);
+  const double top =
+      LatticeValue(ix, iy) * (1.0 - tx) + LatticeValue(ix + 1, iy) * tx;
+  const double bottom = LatticeValue(ix, iy + 1) * (1.0 - tx) +
+                        LatticeValue(ix + 1, iy + 1) * tx;
+  return top * (1.0 - ty) + bottom * ty;
+}
+
+}  // namespace
+
+void PixelMapEffect::UpdatePixels() {
+  const std::vector<std::pair<Controllable *, size_t>> &connections =
+      Connections();
+  const size_t n = connections.size();
+  connection_pixels_.resize(n);
+  blocks_.clear();
+  fixtures_.clear();
+  offsets_.clear();
+  std::map<const Fixture *, size_t> pixels;
+  for (size_t i = 0; i != n; ++i) {
+    FixtureControl *control =
+        dynamic_cast<FixtureControl *>(connections[i].first);
+    const Fixture *fixture = control ? &control->GetFixture() : nullptr;
+    const size_t block_function =
+        control ? control->PixelBlockFunction(connections[i].second) : 0;
+    if (control && block_function != fixture->Functions().size()) {
+      const size_t n_cells = control->PixelValues(block_function).size() / 3;
+      blocks_.emplace_back(
+          Block{control, block_function, fixtures_.size(), n_cells});
+      connection_pixels_[i] = fixtures_.size();
+      for (size_t cell = 0; cell != n_cells; ++cell) {
+        fixtures_.emplace_back(fixture);
+        offsets_.emplace_back((cell + 0.5) / n_cells - 0.5);
+      }
+    } else {
+      const auto [iter, is_new] = pixels.emplace(fixture, fixtures_.size());
+      if (is_new) {
+        fixtures_.emplace_back(fixture);
+        offsets_.emplace_back(0.0);
+      }
+      connection_pixels_[i] = iter->second;
+    }
+  }
+  const size_t n_pixels = fixtures_.size();
+  u_.resize(n_pixels);
+  v_.resize(n_pixels);
+  hue_.resize(n_pixels);
+  red_.resize(n_pixels);
+  green_.resize(n_pixels);
+  blue_.resize(n_pixels);
+  pixels_are_valid_ = true;
+}
+
+void PixelMapEffect::UpdatePositions() {
+  // Positions are read every frame, so that moving a fixture is
+  // immediately visible.
+  double min_x = std::numeric_limits<double>::max();
+  double min_y = std::numeric_limits<double>::max();
+  double max_x = std::numeric_limits<double>::lowest();
+  double max_y = std::numeric_limits<double>::lowest();
+  for (size_t i = 0; i != fixtures_.size(); ++i) {
+    if (fixtures_[i]) {
+      u_[i] = fixtures_[i]->GetPosition().X() + offsets_[i];
+      v_[i] = fixtures_[i]->GetPosition().Y();
+      min_x = std::min(min_x, u_[i]);
+      min_y = std::min(min_y, v_[i]);
+      max_x = std::max(max_x, u_[i]);
+      max_y = std::max(max_y, v_[i]);
+    }
+  }
+  // Use the same scale in both directions, so that the pattern keeps its
+  // aspect ratio.
+  const double extent = std::max(max_x - min_x, max_y - min_y);
+  const double scale = extent > 0.0 ? 1.0 / extent : 0.0;
+  for (size_t i = 0; i != u_.size(); ++i) {
+    if (fixtures_[i]) {
+      u_[i] = (u_[i] - min_x) * scale;
+      v_[i] = (v_[i] - min_y) * scale;
+    } else {
+      u_[i] = 0.0;
+      v_[i] = 0.0;
+    }
+  }
+}
+
+void PixelMapEffect::Render(double phase, const ControlValue &master) {
+  const double repeat = 100.0 / size_;
+  const size_t n = hue_.size();
+  switch (pattern_) {
+    case Pattern::HorizontalRainbow:
+      for (size_t i = 0; i != n; ++i) {
+        hue_[i] = Fraction(u_[i] * repeat - phase);
+      }
+      break;
+    case Pattern::VerticalRainbow:
+      for (size_t i = 0; i != n; ++i) {
+        hue_[i] = Fraction(v_[i] * repeat - phase);
+      }
+      break;
+    case Pattern::RadialRainbow:
+      for (size_t i = 0; i != n; ++i) {
+        const double du = u_[i] - 0.5;
+        const double dv = v_[i] - 0.5;
+        const double distance = std::sqrt(du * du + dv * dv) * 2.0;
+        hue_[i] = Fraction(distance * repeat - phase);
+      }
+      break;
+    case Pattern::Plasma: {
+      const double angle = 2.0 * M_PI * phase;
+      const double frequency = 2.0 * M_PI * repeat;
+      for (size_t i = 0; i != n; ++i) {
+        const double sum = std::sin(u_[i] * frequency + angle) +
+                           std::sin(v_[i] * frequency - angle) +
+                           std::sin((u_[i] + v_[i]) * frequency * 0.5 + angle);
+        hue_[i] = sum / 6.0 + 0.5;
+      }
+    } break;
+    case Pattern::Noise: {
+      // Four noise cells per repetition, moving horizontally
+      const double cells = 4.0 * repeat;
+      const double shift = 4.0 * phase;
+      for (size_t i = 0; i != n; ++i) {
+        hue_[i] = ValueNoise(u_[i] * cells - shift, v_[i] * cells);
+      }
+    } break;
+  }
+  // Fully saturated hue to RGB, written without branches
+  const double scale = master.UInt();
+  for (size_t i = 0; i != n; ++i) {
+    const double h = hue_[i] * 6.0;
+    red_[i] = ControlValue(
+        std::clamp(std::abs(h - 3.0) - 1.0, 0.0, 1.0) * scale);
+    green_[i] = ControlValue(
+        std::clamp(2.0 - std::abs(h - 2.0), 0.0, 1.0) * scale);
+    blue_[i] = ControlValue(
+        std::clamp(2.0 - std::abs(h - 4.0), 0.0, 1.0) * scale);
+  }
+}
+
+void PixelMapEffect::MixImplementation(const ControlValue *values,
+                                       const Timing &timing,
+                                       bool /*primary*/) {
+  const std::span<const OutputTarget> targets = OutputTargets();
+  if (!values[0] || targets.empty()) return;
+  if (!pixels_are_valid_) UpdatePixels();
+  UpdatePositions();
+  Render(std::fmod(timing.TimeInMS(), period_) / period_, values[0]);
+  for (const Block &block : blocks_) {
+    // The number of cells can be changed while the effect is connected
+    const std::span<ControlValue> cells =
+        block.control->PixelValues(block.function_index);
+    const size_t n_cells = std::min(block.n_cells, cells.size() / 3);
+    ControlValue *cell_values = cells.data();
+    const ControlValue *r = red_.data() + block.first_pixel;
+    const ControlValue *g = green_.data() + block.first_pixel;
+    const ControlValue *b = blue_.data() + block.first_pixel;
+    for (size_t cell = 0; cell != n_cells; ++cell) {
+      cell_values[cell * 3] += r[cell];
+      cell_values[cell * 3 + 1] += g[cell];
+      cell_values[cell * 3 + 2] += b[cell];
+    }
+  }
+  for (size_t i = 0; i != targets.size(); ++i) {
+    const size_t pixel = connection_pixels_[i];
+    const ControlValue &r = red_[pixel];
+    const ControlValue &g = green_[pixel];
+    const ControlValue &b = blue_[pixel];
+    switch (targets[i].type) {
+      case FunctionType::Red:
+        MixOutput(targets[i], r);
+        break;
+      case FunctionType::Green:
+        MixOutput(targets[i], g);
+        break;
+      case FunctionType::Blue:
+        MixOutput(targets[i], b);
+        break;
+      case FunctionType::White:
+        MixOutput(targets[i], DeduceWhite(r, g, b));
+        break;
+      case FunctionType::Amber:
+        MixOutput(targets[i], DeduceAmber(r, g, b));
+        break;
+      case FunctionType::UV:
+        MixOutput(targets[i], DeduceUv(r, g, b));
+        break;
+      case FunctionType::Lime:
+        MixOutput(targets[i], DeduceLime(r, g, b));
+        break;
+      case FunctionType::ColdWhite:
+        MixOutput(targets[i], DeduceColdWhite(r, g, b));
+        break;
+      case FunctionType::WarmWhite:
+        MixOutput(targets[i], DeduceWarmWhite(r, g, b));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+}  // namespace glight::theatre
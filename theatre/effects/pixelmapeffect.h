@@ -0,0 +1,110 @@
+#ifndef THEATRE_PIXEL_MAP_EFFECT_H_
+#define THEATRE_PIXEL_MAP_EFFECT_H_
+
+#include <vector>
+
+#include "../effect.h"
+
+namespace glight::theatre {
+
+class Fixture;
+class FixtureControl;
+
+/**
+ * Renders a moving 2D pattern onto the stage positions of the connected
+ * fixtures. Each connection samples the pattern at the position of the
+ * fixture it is connected to, and receives the colour component that
+ * corresponds with its input type. The pattern is stretched over the
+ * bounding box of the connected fixtures, so a single effect can drive
+ * thousands of pixels without one chase per pixel. Connections to
+ * something other than a fixture do not count for the bounding box, and
+ * are placed at the start of the pattern.
+ *
+ * A connection to a pixel block input is expanded into one pixel per
+ * cell. The cells are spread horizontally over one unit around the
+ * position of the fixture, and their colours are written directly into
+ * the cell values of the fixture control.
+ *
+ * The patterns are evaluated for all connections together, in branch-free
+ * loops over flat arrays of positions and colour components.
+ */
+class PixelMapEffect final : public Effect {
+ public:
+  enum class Pattern {
+    /** Hue changes with the horizontal position. */
+    HorizontalRainbow,
+    /** Hue changes with the vertical position. */
+    VerticalRainbow,
+    /** Hue changes with the distance from the centre. */
+    RadialRainbow,
+    /** Hue follows a sum of three sine waves. */
+    Plasma,
+    /** Hue follows smooth 2D value noise. */
+    Noise
+  };
+
+  PixelMapEffect() : Effect(1) {}
+
+  EffectType GetType() const override { return EffectType::PixelMap; }
+
+  void SetPattern(Pattern pattern) { pattern_ = pattern; }
+  Pattern GetPattern() const { return pattern_; }
+
+  /** Time in ms in which the pattern moves over one repetition. */
+  void SetPeriod(double period) {
+    period_ = std::clamp(period, 25.0, 24 * 60.0 * 60.0 * 1000.0);
+  }
+  double GetPeriod() const { return period_; }
+
+  /**
+   * Size of one repetition of the pattern, as percentage of the size of
+   * the rig. At 100%, the pattern covers all fixtures once.
+   */
+  void SetSize(int size) { size_ = std::max(size, 1); }
+  int GetSize() const { return size_; }
+
+ protected:
+  void MixImplementation(const ControlValue *values, const Timing &timing,
+                         bool primary) override;
+
+  void OnConnectionsChanged() override { pixels_are_valid_ = false; }
+
+ private:
+  void UpdatePixels();
+  void UpdatePositions();
+  void Render(double phase, const ControlValue &master);
+
+  Pattern pattern_ = Pattern::HorizontalRainbow;
+  double period_ = 5000.0;
+  int size_ = 100;
+
+  // Set to false when the connections change, after which the pixels are
+  // rebuilt before the next mix.
+  bool pixels_are_valid_ = false;
+  struct Block {
+    FixtureControl *control;
+    size_t function_index;
+    size_t first_pixel;
+    size_t n_cells;
+  };
+
+  // Indexed by connection index. Connections to a pixel block are not
+  // mixed through their target, and point to their first cell.
+  std::vector<size_t> connection_pixels_;
+  std::vector<Block> blocks_;
+  // All below vectors are indexed by pixel index. Connections to the same
+  // fixture share a pixel, except for connections to a pixel block.
+  std::vector<const Fixture *> fixtures_;
+  // Horizontal offset of a pixel from the position of its fixture
+  std::vector<double> offsets_;
+  std::vector<double> u_;
+  std::vector<double> v_;
+  std::vector<double> hue_;
+  std::vector<ControlValue> red_;
+  std::vector<ControlValue> green_;
+  std::vector<ControlValue> blue_;
+};
+
+}  // namespace glight::theatre
+
+#endif
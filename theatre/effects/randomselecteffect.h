@@ -3,7 +3,11 @@
 
 #include "../effect.h"
 #include "../timing.h"
+#include "../transition.h"
 
+#include <algorithm>
+#include <array>
+#include <random>
 #include <vector>
 
 namespace glight::theatre {
@@ -26,28 +30,23 @@ class RandomSelectEffect final : public Effect {
  private:
   virtual void MixImplementation(const ControlValue *values,
                                  const Timing &timing, bool primary) final {
-    size_t n_active = std::min(_count, Connections().size());
+    const size_t n_active = std::min(_count, Connections().size());
     if (values[0] && n_active != 0) {
       std::vector<size_t> &activeConnections = _activeConnections[primary];
       std::vector<size_t> &transition_connections =
           transition_connections_[primary];
-      if (Connections().size() != activeConnections.size()) {
-        activeConnections.resize(Connections().size());
-        for (size_t i = 0; i != activeConnections.size(); ++i) {
-          activeConnections[i] = i;
-        }
-        transition_connections = activeConnections;
-        Shuffle(activeConnections, timing, false);
-        active_transition_[primary] = false;
-      }
       const bool delay_expired =
           timing.TimeInMS() - _startTime[primary] >= _delay;
       if (!_active[primary] || delay_expired) {
+        // When the effect becomes active, any connection can be the first
+        // one, and there is nothing to transition from.
+        const bool is_restart = _active[primary];
         _active[primary] = true;
         _startTime[primary] = timing.TimeInMS();
-        transition_connections = activeConnections;
-        Shuffle(activeConnections, timing, true);
-        active_transition_[primary] = delay_expired;
+        std::copy_n(activeConnections.begin(), n_active,
+                    transition_connections.begin());
+        Select(activeConnections, n_active, timing, is_restart);
+        active_transition_[primary] = is_restart;
       }
       double transition_time;
       if (active_transition_[primary]) {
@@ -56,40 +55,60 @@ class RandomSelectEffect final : public Effect {
             transition_time < transition_.LengthInMs();
       }
       if (active_transition_[primary]) {
-        MixDirect(transition_connections,
+        MixDirect(transition_connections, n_active,
                   values[0] * transition_.OutValue(transition_time, timing));
-        MixDirect(activeConnections,
+        MixDirect(activeConnections, n_active,
                   values[0] * transition_.InValue(transition_time, timing));
       } else {
-        MixDirect(activeConnections, values[0]);
+        MixDirect(activeConnections, n_active, values[0]);
       }
     } else {
       _active[primary] = false;
     }
   }
 
-  void Shuffle(std::vector<size_t> &list, const Timing &timing,
-               bool is_restart) {
-    if (!list.empty()) {
-      // If only one output is active, require the output to change
-      // when reshuffling if it is a restart.
-      bool must_change = _count == 1 && list.size() > 1 && is_restart;
-      size_t first_active = list.front();
-      do {
-        std::shuffle(list.begin(), list.end(), timing.RNG());
-      } while (must_change && first_active == list.front());
+  void OnConnectionsChanged() final {
+    for (size_t primary = 0; primary != 2; ++primary) {
+      std::vector<size_t> &list = _activeConnections[primary];
+      list.resize(Connections().size());
+      for (size_t i = 0; i != list.size(); ++i) list[i] = i;
+      transition_connections_[primary] = list;
+      _active[primary] = false;
+      active_transition_[primary] = false;
+    }
+  }
+
+  /**
+   * Randomly selects @p n_active entries of the list and moves them to the
+   * front. This is the first part of a Fisher-Yates shuffle: it takes
+   * @p n_active steps, independent of the size of the list, and is done in
+   * place.
+   */
+  void Select(std::vector<size_t> &list, size_t n_active,
+              const Timing &timing, bool is_restart) {
+    const size_t n = list.size();
+    // If only one output is active, require the output to change
+    // when reselecting if it is a restart.
+    if (_count == 1 && n > 1 && is_restart) {
+      std::uniform_int_distribution<size_t> distribution(1, n - 1);
+      std::swap(list[0], list[distribution(timing.RNG())]);
+    } else {
+      for (size_t i = 0; i != n_active; ++i) {
+        std::uniform_int_distribution<size_t> distribution(i, n - 1);
+        std::swap(list[i], list[distribution(timing.RNG())]);
+      }
     }
   }
 
-  void MixDirect(const std::vector<size_t> &connections,
+  void MixDirect(const std::vector<size_t> &connections, size_t n_active,
                  const ControlValue value) {
-    size_t n_active = std::min(_count, Connections().size());
+    const std::span<const OutputTarget> targets = OutputTargets();
+    // The lists are resized by OnConnectionsChanged(); skip connections
+    // that no longer have a target.
+    n_active = std::min(n_active, connections.size());
     for (size_t i = 0; i != n_active; ++i) {
-      if (connections[i] < Connections().size()) {
-        const std::pair<Controllable *, size_t> &connection =
-            Connections()[connections[i]];
-        connection.first->MixInput(connection.second, value);
-      }
+      if (connections[i] < targets.size())
+        MixOutput(targets[connections[i]], value);
     }
   }
 
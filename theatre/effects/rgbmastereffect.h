@@ -42,18 +42,17 @@ class RgbMasterEffect final : public Effect {
  protected:
   virtual void MixImplementation(const ControlValue *values,
                                  const Timing &timing, bool primary) override {
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      const size_t input_index = connection.second;
+    for (const OutputTarget &target : OutputTargets()) {
       const ControlValue master = values[3];
-      switch (connection.first->InputType(input_index)) {
+      switch (target.type) {
         case FunctionType::Red:
-          connection.first->MixInput(input_index, values[0] * master);
+          MixOutput(target, values[0] * master);
           break;
         case FunctionType::Green:
-          connection.first->MixInput(input_index, values[1] * master);
+          MixOutput(target, values[1] * master);
           break;
         case FunctionType::Blue:
-          connection.first->MixInput(input_index, values[2] * master);
+          MixOutput(target, values[2] * master);
           break;
         default:
           break;
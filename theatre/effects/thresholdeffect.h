@@ -71,8 +71,8 @@ class ThresholdEffect final : public Effect {
         thresholded.Set(ControlValue::Max().UInt() - v * 65536);
       }
     }
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      connection.first->MixInput(connection.second, thresholded);
+    for (const OutputTarget &target : OutputTargets()) {
+      MixOutput(target, thresholded);
     }
   }
 
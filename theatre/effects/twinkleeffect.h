@@ -1,7 +1,10 @@
 #ifndef THEATRE_TWINKLE_EFFECT_H_
 #define THEATRE_TWINKLE_EFFECT_H_
 
+#include <algorithm>
 #include <random>
+#include <span>
+#include <vector>
 
 #include "../effect.h"
 #include "../transition.h"
@@ -36,25 +39,75 @@ class TwinkleEffect final : public Effect {
     if (values[0]) {
       if (previous_time_[primary] == -1.0)
         previous_time_[primary] = timing.TimeInMS();
-      inputs_[primary].resize(Connections().size());
-      for (size_t i = 0; i != Connections().size(); ++i) {
-        MixInput(Connections()[i], inputs_[primary][i], values[0], timing,
-                 primary);
+      in_batch_.Clear();
+      out_batch_.Clear();
+      const std::span<const OutputTarget> targets = OutputTargets();
+      // The state is resized by OnConnectionsChanged(); only the outputs
+      // that have both a target and a state are mixed.
+      const size_t n = std::min(targets.size(), inputs_[primary].size());
+      for (size_t i = 0; i != n; ++i) {
+        UpdateInput(i, inputs_[primary][i], values[0], timing, primary);
+      }
+      // The transitions of all inputs are evaluated in one batch per
+      // transition.
+      transition_in_.InValues(in_batch_.times, in_batch_.Values(), timing);
+      transition_out_.InValues(out_batch_.times, out_batch_.Values(), timing);
+      for (const TransitionBatch* batch : {&in_batch_, &out_batch_}) {
+        for (size_t i = 0; i != batch->indices.size(); ++i) {
+          MixOutput(targets[batch->indices[i]], batch->values[i] * values[0]);
+        }
       }
     }
     previous_time_[primary] = timing.TimeInMS();
   }
 
+  void OnConnectionsChanged() override {
+    for (std::vector<InputData>& inputs : inputs_)
+      inputs.resize(Connections().size());
+    in_batch_.Reserve(Connections().size());
+    out_batch_.Reserve(Connections().size());
+  }
+
  private:
   enum class State { Waiting, TransitionIn, Hold, TransitionOut };
   struct InputData {
     State state = State::TransitionOut;
     double state_timer = 0.0;
   };
+  /**
+   * Positions in a transition of the outputs that are transitioning. The
+   * storage is reserved when the connections change, so that filling it
+   * does not allocate.
+   */
+  struct TransitionBatch {
+    void Clear() {
+      indices.clear();
+      times.clear();
+    }
+    void Reserve(size_t n) {
+      indices.reserve(n);
+      times.reserve(n);
+      values.resize(n);
+    }
+    void Add(size_t index, double time) {
+      indices.emplace_back(index);
+      times.emplace_back(time);
+    }
+    std::span<ControlValue> Values() {
+      return std::span<ControlValue>(values.data(), times.size());
+    }
+
+    std::vector<size_t> indices;
+    std::vector<double> times;
+    std::vector<ControlValue> values;
+  };
 
-  void MixInput(const std::pair<Controllable*, size_t>& connection,
-                InputData& input, const ControlValue& value,
-                const Timing& timing, bool primary) {
+  /**
+   * Advances the state of one output. Outputs that are on are mixed
+   * directly, and outputs that are transitioning are added to a batch.
+   */
+  void UpdateInput(size_t index, InputData& input, const ControlValue& value,
+                   const Timing& timing, bool primary) {
     const double time_passed = timing.TimeInMS() - previous_time_[primary];
     input.state_timer -= time_passed;
     switch (input.state) {
@@ -68,18 +121,14 @@ class TwinkleEffect final : public Effect {
         if (input.state_timer <= 0.0) {
           input.state_timer = hold_time_;
           input.state = State::Hold;
-          connection.first->MixInput(connection.second, value);
+          MixOutput(OutputTargets()[index], value);
         } else {
-          const double transition_point =
-              transition_out_.LengthInMs() - input.state_timer;
-          const ControlValue transition_value =
-              transition_in_.InValue(transition_point, timing);
-          connection.first->MixInput(connection.second,
-                                     transition_value * value);
+          in_batch_.Add(index,
+                        transition_out_.LengthInMs() - input.state_timer);
         }
         break;
       case State::Hold:
-        connection.first->MixInput(connection.second, value);
+        MixOutput(OutputTargets()[index], value);
         if (input.state_timer <= 0.0) {
           input.state = State::TransitionOut;
           input.state_timer = transition_out_.LengthInMs();
@@ -92,10 +141,7 @@ class TwinkleEffect final : public Effect {
           input.state_timer = distribution(timing.RNG());
           input.state = State::Waiting;
         } else {
-          const ControlValue transition_value =
-              transition_out_.InValue(input.state_timer, timing);
-          connection.first->MixInput(connection.second,
-                                     transition_value * value);
+          out_batch_.Add(index, input.state_timer);
         }
         break;
     }
@@ -108,6 +154,8 @@ class TwinkleEffect final : public Effect {
   Transition transition_in_ = Transition(300, TransitionType::Fade);
   Transition transition_out_ = Transition(300, TransitionType::Fade);
   std::vector<InputData> inputs_[2];
+  TransitionBatch in_batch_;
+  TransitionBatch out_batch_;
 };
 
 }  // namespace glight::theatre
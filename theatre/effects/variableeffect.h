@@ -32,17 +32,16 @@ class VariableEffect final : public Effect {
  protected:
   virtual void MixImplementation(const ControlValue *values,
                                  const Timing &timing, bool primary) override {
-    for (const std::pair<Controllable *, size_t> &connection : Connections()) {
-      const size_t input_index = connection.second;
-      switch (connection.first->InputType(input_index)) {
+    for (const OutputTarget &target : OutputTargets()) {
+      switch (target.type) {
         case FunctionType::Red:
-          connection.first->MixInput(input_index, values[0]);
+          MixOutput(target, values[0]);
           break;
         case FunctionType::Green:
-          connection.first->MixInput(input_index, values[1]);
+          MixOutput(target, values[1]);
           break;
         case FunctionType::Blue:
-          connection.first->MixInput(input_index, values[2]);
+          MixOutput(target, values[2]);
           break;
         default:
           break;
@@ -23,6 +23,7 @@ enum class EffectType {
   HueSaturationLightness,
   Invert,
   MusicActivation,
+  PixelMap,
   Pulse,
   RandomSelect,
   RgbMaster,
@@ -63,6 +64,8 @@ inline std::string EffectTypeToName(EffectType type) {
       return "Invert";
     case ET::MusicActivation:
       return "Music activation";
+    case ET::PixelMap:
+      return "Pixel map";
     case ET::Pulse:
       return "Pulse";
     case ET::RandomSelect:
@@ -111,6 +114,8 @@ inline EffectType NameToEffectType(const std::string &name) {
     return ET::Invert;
   else if (name == "Music activation")
     return ET::MusicActivation;
+  else if (name == "Pixel map")
+    return ET::PixelMap;
   else if (name == "Pulse")
     return ET::Pulse;
   else if (name == "Random select")
@@ -145,6 +150,7 @@ inline std::vector<EffectType> GetEffectTypes() {
                          ET::HueSaturationLightness,
                          ET::Invert,
                          ET::MusicActivation,
+                         ET::PixelMap,
                          ET::Pulse,
                          ET::RandomSelect,
                          ET::RgbMaster,
@@ -0,0 +1,60 @@
+#include "fadeprocessor.h"
+
+#include "sourcevalue.h"
+
+#include <algorithm>
+
+namespace glight::theatre {
+
+void FadeProcessor::Process(double time_passed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t n = fading_.size();
+  values_.resize(n);
+  targets_.resize(n);
+  steps_.resize(n);
+  unsigned* values = values_.data();
+  unsigned* targets = targets_.data();
+  unsigned* steps = steps_.data();
+  for (size_t i = 0; i != n; ++i) {
+    const SingleSourceValue& value = *fading_[i];
+    values[i] = value.value_.UInt();
+    targets[i] = value.target_value_;
+    steps[i] = SingleSourceValue::FadeStep(value.fade_speed_, time_passed);
+  }
+
+  for (size_t i = 0; i != n; ++i) {
+    values[i] = SingleSourceValue::StepTowards(values[i], targets[i], steps[i]);
+  }
+
+  // Write the values back and remove the values that reached their target
+  size_t n_kept = 0;
+  for (size_t i = 0; i != n; ++i) {
+    SingleSourceValue& value = *fading_[i];
+    value.value_ = ControlValue(values[i]);
+    if (values[i] == targets[i]) {
+      value.is_fading_ = false;
+    } else {
+      fading_[n_kept] = &value;
+      ++n_kept;
+    }
+  }
+  fading_.resize(n_kept);
+}
+
+void FadeProcessor::Join(SingleSourceValue& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!value.is_fading_ && value.value_.UInt() != value.target_value_) {
+    value.is_fading_ = true;
+    fading_.emplace_back(&value);
+  }
+}
+
+void FadeProcessor::Leave(SingleSourceValue& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (value.is_fading_) {
+    value.is_fading_ = false;
+    fading_.erase(std::find(fading_.begin(), fading_.end(), &value));
+  }
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,53 @@
+#ifndef THEATRE_FADE_PROCESSOR_H_
+#define THEATRE_FADE_PROCESSOR_H_
+
+#include <mutex>
+#include <vector>
+
+namespace glight::theatre {
+
+class SingleSourceValue;
+
+/**
+ * Applies the fades of many source values at once. Single source values
+ * that are attached to the processor join its list of fading values when
+ * they are given a target that differs from their value, and leave the list
+ * once they reach it. The cost of @ref Process() is therefore proportional
+ * to the number of values that are fading, not to the number of source
+ * values. Stepping is done in 24-bit fixed point with branch-free loops over
+ * contiguous arrays, so that the compiler can vectorize them. The result is
+ * identical to calling @ref SingleSourceValue::ApplyFade() on every value: a
+ * fade speed of zero moves to the target immediately, and fades never
+ * overshoot the target.
+ *
+ * Values may be set from other threads than the one that calls
+ * @ref Process(), therefore the list is protected by its own mutex.
+ */
+class FadeProcessor {
+ public:
+  void Process(double time_passed);
+
+  /**
+   * Number of values that are still fading.
+   */
+  size_t NActiveFades() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fading_.size();
+  }
+
+ private:
+  friend class SingleSourceValue;
+
+  void Join(SingleSourceValue& value);
+  void Leave(SingleSourceValue& value);
+
+  mutable std::mutex mutex_;
+  std::vector<SingleSourceValue*> fading_;
+  std::vector<unsigned> values_;
+  std::vector<unsigned> targets_;
+  std::vector<unsigned> steps_;
+};
+
+}  // namespace glight::theatre
+
+#endif
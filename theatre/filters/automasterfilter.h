@@ -1,7 +1,9 @@
 #ifndef GLIGHT_THEATRE_AUTO_MASTER_FILTER_H_
 #define GLIGHT_THEATRE_AUTO_MASTER_FILTER_H_
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include "filter.h"
 
@@ -13,8 +15,10 @@ class AutoMasterFilter final : public Filter {
  public:
   FilterType GetType() const override { return FilterType::AutoMaster; }
 
-  void Apply(const std::vector<ControlValue>& input,
-             std::vector<ControlValue>& output) override {
+  using Filter::Apply;
+
+  void Apply(std::span<const ControlValue> input,
+             std::span<ControlValue> output) override {
     unsigned maximum;
     if (master_channel_index_) {
       maximum = 0;
@@ -47,6 +51,52 @@ class AutoMasterFilter final : public Filter {
     }
   }
 
+  /**
+   * Same as Apply(), but with loops over the fixtures for every function,
+   * which the compiler can vectorize.
+   */
+  void ApplyBatch(std::span<const ControlValue> input,
+                  std::span<ControlValue> output, size_t n) override {
+    maximum_.resize(n);
+    if (master_channel_index_) {
+      std::fill(maximum_.begin(), maximum_.end(), 0);
+      for (size_t i = 0; i != InputTypes().size(); ++i) {
+        const ControlValue* row = input.data() + i * n;
+        const FunctionType type = InputTypes()[i].Type();
+        if (IsColor(type)) {
+          for (size_t f = 0; f != n; ++f)
+            maximum_[f] = std::max(maximum_[f], row[f].UInt());
+        } else if (type == FunctionType::ColorMacro ||
+                   type == FunctionType::ColorTemperature) {
+          for (size_t f = 0; f != n; ++f)
+            maximum_[f] = row[f] ? ControlValue::MaxUInt() : maximum_[f];
+        }
+      }
+      const double sqrt_max = std::sqrt(ControlValue::MaxUInt());
+      for (size_t f = 0; f != n; ++f)
+        maximum_[f] = std::ceil(std::sqrt(maximum_[f]) * sqrt_max);
+    } else {
+      std::fill(maximum_.begin(), maximum_.end(), ControlValue::MaxUInt());
+    }
+    size_t input_index = 0;
+    for (size_t i = 0; i != OutputTypes().size(); ++i) {
+      ControlValue* output_row = output.data() + i * n;
+      const ControlValue* input_row = input.data() + input_index * n;
+      if (OutputTypes()[i].Type() == FunctionType::Master) {
+        for (size_t f = 0; f != n; ++f)
+          output_row[f] = ControlValue(maximum_[f]);
+      } else if (IsColor(OutputTypes()[i].Type())) {
+        for (size_t f = 0; f != n; ++f)
+          output_row[f] = ControlValue(
+              ControlValue::Fraction(input_row[f].UInt(), maximum_[f]));
+        ++input_index;
+      } else {
+        std::copy_n(input_row, n, output_row);
+        ++input_index;
+      }
+    }
+  }
+
  protected:
   void DetermineInputTypes() override {
     master_channel_index_.Reset();
@@ -64,6 +114,7 @@ class AutoMasterFilter final : public Filter {
 
  private:
   system::OptionalNumber<size_t> master_channel_index_;
+  std::vector<unsigned> maximum_;
 };
 
 }  // namespace glight::theatre
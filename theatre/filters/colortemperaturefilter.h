@@ -13,8 +13,10 @@ class ColorTemperatureFilter final : public Filter {
  public:
   FilterType GetType() const override { return FilterType::ColorTemperature; }
 
-  void Apply(const std::vector<ControlValue>& input,
-             std::vector<ControlValue>& output) override {
+  using Filter::Apply;
+
+  void Apply(std::span<const ControlValue> input,
+             std::span<ControlValue> output) override {
     if (enabled_) {
       const ControlValue red = input[0];
       const ControlValue green = input[1];
@@ -32,6 +32,23 @@ FilterType GetFilterType(const std::string& filter_type_string) {
     return FilterType::RgbColorspace;
 }
 
+void Filter::ApplyBatch(std::span<const ControlValue> input,
+                        std::span<ControlValue> output, size_t n_fixtures) {
+  const size_t n_inputs = InputTypes().size();
+  const size_t n_outputs = OutputTypes().size();
+  // These only allocate the first time
+  batch_input_.resize(n_inputs);
+  batch_output_.resize(n_outputs);
+  for (size_t fixture = 0; fixture != n_fixtures; ++fixture) {
+    for (size_t i = 0; i != n_inputs; ++i)
+      batch_input_[i] = input[i * n_fixtures + fixture];
+    Apply(std::span<const ControlValue>(batch_input_),
+          std::span<ControlValue>(batch_output_));
+    for (size_t i = 0; i != n_outputs; ++i)
+      output[i * n_fixtures + fixture] = batch_output_[i];
+  }
+}
+
 std::unique_ptr<Filter> Filter::Make(FilterType type) {
   switch (type) {
     case FilterType::AutoMaster:
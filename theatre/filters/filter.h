@@ -1,7 +1,9 @@
 #ifndef THEATRE_FILTER_H_
 #define THEATRE_FILTER_H_
 
+#include <span>
 #include <string>
+#include <vector>
 
 #include "../controlvalue.h"
 #include "../folderobject.h"
@@ -59,12 +61,41 @@ class Filter {
 
   /**
    * Applies the filter to the input and sets the output accordingly.
+   * Implementations should not allocate, as this is called for every
+   * fixture in every frame.
    * @param input should have a size of InputTypes().size().
-   * @param output Output parameter. On input, should have a size equal to
-   * OutputTypes().size().
+   * @param output Output parameter. Should have a size equal to
+   * OutputTypes().size(), and should not overlap with the input.
    */
-  virtual void Apply(const std::vector<ControlValue>& input,
-                     std::vector<ControlValue>& output) = 0;
+  virtual void Apply(std::span<const ControlValue> input,
+                     std::span<ControlValue> output) = 0;
+
+  void Apply(const std::vector<ControlValue>& input,
+             std::vector<ControlValue>& output) {
+    Apply(std::span<const ControlValue>(input),
+          std::span<ControlValue>(output));
+  }
+
+  /**
+   * Applies the filter to a batch of fixtures that all have the same
+   * output types. Values are stored per function (as a structure of
+   * arrays): value i of fixture f is at index i * n_fixtures + f. The
+   * default implementation applies the filter to one fixture at a time;
+   * filters can override it to process a function of all fixtures in one
+   * loop.
+   */
+  virtual void ApplyBatch(std::span<const ControlValue> input,
+                          std::span<ControlValue> output, size_t n_fixtures);
+
+  /**
+   * True if this filter behaves the same as the other filter when they
+   * have the same output types. Filters for which this is true can be
+   * applied in one batch. Filters with settings should call
+   * @ref Controllable::NotifyShowChange() when a setting changes.
+   */
+  virtual bool HasSameSettings(const Filter& other) const {
+    return GetType() == other.GetType();
+  }
 
  protected:
   void SetInputTypes(std::vector<FixtureModeFunction> input_types) {
@@ -74,6 +105,9 @@ class Filter {
  private:
   std::vector<FixtureModeFunction> input_types_;
   std::vector<FixtureModeFunction> output_types_;
+  // Values of a single fixture, used by the default ApplyBatch()
+  std::vector<ControlValue> batch_input_;
+  std::vector<ControlValue> batch_output_;
 };
 
 }  // namespace glight::theatre
@@ -0,0 +1,136 @@
+#include "filterbatcher.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "filter.h"
+
+#include "../fixturecontrol.h"
+
+namespace glight::theatre {
+
+namespace {
+bool HasSameSettings(const std::vector<Filter *> &filters,
+                     const FixtureControl &control) {
+  const std::vector<std::unique_ptr<Filter>> &other = control.Filters();
+  for (size_t i = 0; i != filters.size(); ++i) {
+    // The filters of a control are stored in backward order
+    if (!filters[i]->HasSameSettings(*other[other.size() - 1 - i]))
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+void FilterBatcher::Compile(
+    const std::vector<FixtureControl *> &fixture_controls) {
+  show_generation_ = Controllable::ShowGeneration();
+  using Key = std::pair<const FixtureMode *, std::vector<FilterType>>;
+  std::map<Key, std::vector<size_t>> candidates;
+  std::vector<Group> groups;
+  for (FixtureControl *control : fixture_controls) {
+    control->SetBatched(false);
+    const std::vector<std::unique_ptr<Filter>> &filters = control->Filters();
+    if (filters.empty()) continue;
+    Key key(&control->GetFixture().Mode(), {});
+    for (auto iter = filters.rbegin(); iter != filters.rend(); ++iter)
+      key.second.emplace_back((*iter)->GetType());
+    std::vector<size_t> &group_indices = candidates[std::move(key)];
+    const auto group_index = std::find_if(
+        group_indices.begin(), group_indices.end(), [&](size_t index) {
+          return HasSameSettings(groups[index].filters, *control);
+        });
+    if (group_index == group_indices.end()) {
+      group_indices.emplace_back(groups.size());
+      Group &group = groups.emplace_back();
+      group.controls.emplace_back(control);
+      for (auto iter = filters.rbegin(); iter != filters.rend(); ++iter)
+        group.filters.emplace_back(iter->get());
+    } else {
+      groups[*group_index].controls.emplace_back(control);
+    }
+  }
+
+  groups_.clear();
+  for (Group &group : groups) {
+    if (group.controls.size() > 1) {
+      for (FixtureControl *control : group.controls) control->SetBatched(true);
+      group.stage_width =
+          group.controls.front()->GetFixture().Functions().size();
+      for (const Filter *filter : group.filters)
+        group.stage_width =
+            std::max(group.stage_width, filter->InputTypes().size());
+      group.buffer.resize(group.stage_width * group.controls.size() * 2);
+      groups_.emplace_back(std::move(group));
+    }
+  }
+  is_dirty_ = false;
+}
+
+bool FilterBatcher::IsValid(const Group &group, bool check_settings) {
+  // The filters of the group are owned by the first control, so they must
+  // still be its filters before their settings can be compared.
+  const std::vector<std::unique_ptr<Filter>> &first =
+      group.controls.front()->Filters();
+  if (first.size() != group.filters.size()) return false;
+  for (size_t i = 0; i != first.size(); ++i) {
+    if (first[first.size() - 1 - i].get() != group.filters[i]) return false;
+  }
+  for (size_t i = 1; i != group.controls.size(); ++i) {
+    const FixtureControl &control = *group.controls[i];
+    if (control.Filters().size() != group.filters.size() ||
+        (check_settings && !HasSameSettings(group.filters, control)))
+      return false;
+  }
+  return true;
+}
+
+void FilterBatcher::Mix() {
+  // Read before comparing, so that a change during the comparison is seen
+  // in the next mix
+  const size_t show_generation = Controllable::ShowGeneration();
+  const bool check_settings = show_generation != show_generation_;
+  bool is_valid = true;
+  for (Group &group : groups_) {
+    if (!IsValid(group, check_settings)) {
+      is_valid = false;
+      // A filter was added to one of the controls, or its settings changed
+      is_dirty_ = true;
+      for (FixtureControl *control : group.controls) control->MixFilters();
+      continue;
+    }
+    const size_t n = group.controls.size();
+    const size_t half_size = group.stage_width * n;
+    ControlValue *buffer = group.buffer.data();
+
+    const size_t n_inputs = group.filters.front()->InputTypes().size();
+    for (size_t f = 0; f != n; ++f) {
+      FixtureControl &control = *group.controls[f];
+      for (size_t i = 0; i != n_inputs; ++i)
+        buffer[i * n + f] = control.InputValue(i);
+    }
+
+    size_t input_offset = 0;
+    for (Filter *filter : group.filters) {
+      const size_t output_offset = half_size - input_offset;
+      filter->ApplyBatch(
+          std::span<const ControlValue>(buffer + input_offset,
+                                        filter->InputTypes().size() * n),
+          std::span<ControlValue>(buffer + output_offset,
+                                  filter->OutputTypes().size() * n),
+          n);
+      input_offset = output_offset;
+    }
+
+    const size_t n_outputs = group.filters.back()->OutputTypes().size();
+    const ControlValue *result = buffer + input_offset;
+    for (size_t f = 0; f != n; ++f) {
+      ControlValue *values = group.controls[f]->FunctionValues();
+      for (size_t i = 0; i != n_outputs; ++i) values[i] = result[i * n + f];
+    }
+  }
+  if (is_valid) show_generation_ = show_generation;
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,66 @@
+#ifndef THEATRE_FILTER_BATCHER_H_
+#define THEATRE_FILTER_BATCHER_H_
+
+#include <vector>
+
+#include "../controlvalue.h"
+
+namespace glight::theatre {
+
+class Filter;
+class FixtureControl;
+
+/**
+ * Applies the filters of many fixture controls at once. Fixture controls
+ * are grouped by their fixture mode and the types and settings of their
+ * filters. The values of a group are stored as a structure of arrays, and
+ * every filter of the chain is applied to the whole group with one call to
+ * @ref Filter::ApplyBatch(), using the filters of the first control in the
+ * group. This replaces a virtual call per filter per fixture by one per
+ * filter per group, and lets filters loop over fixtures.
+ *
+ * Controls without filters and controls that are the only one in their
+ * group are not batched, and apply their filters in
+ * @ref FixtureControl::Mix() as usual.
+ */
+class FilterBatcher {
+ public:
+  void Compile(const std::vector<FixtureControl *> &fixture_controls);
+
+  /**
+   * Applies the filters of all batched controls. Must be called after the
+   * inputs of the controls have been mixed.
+   */
+  void Mix();
+
+  /**
+   * True when the filters of a batched control or their settings have
+   * changed since @ref Compile() was called. Such controls are still mixed
+   * correctly, but without batching. The settings are only compared again
+   * after @ref Controllable::ShowGeneration() has changed.
+   */
+  bool IsDirty() const { return is_dirty_; }
+
+  size_t GroupCount() const { return groups_.size(); }
+
+ private:
+  struct Group {
+    std::vector<FixtureControl *> controls;
+    // Filters of the first control, in the order in which they are applied
+    std::vector<Filter *> filters;
+    size_t stage_width = 0;
+    // Two halves of stage_width * controls.size() values
+    std::vector<ControlValue> buffer;
+  };
+
+  static bool IsValid(const Group &group, bool check_settings);
+
+  std::vector<Group> groups_;
+  bool is_dirty_ = false;
+  // Show generation for which the settings of all groups were found equal
+  size_t show_generation_ = 0;
+};
+
+}  // namespace glight::theatre
+
+#endif
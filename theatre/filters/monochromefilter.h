@@ -13,8 +13,10 @@ class MonochromeFilter final : public Filter {
  public:
   FilterType GetType() const override { return FilterType::Monochrome; }
 
-  void Apply(const std::vector<ControlValue>& input,
-             std::vector<ControlValue>& output) override {
+  using Filter::Apply;
+
+  void Apply(std::span<const ControlValue> input,
+             std::span<ControlValue> output) override {
     assert(input.size() == InputTypes().size());
     assert(output.size() == OutputTypes().size());
     size_t input_index = 1;
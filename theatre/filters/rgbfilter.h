@@ -3,6 +3,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "filter.h"
 
@@ -10,6 +13,7 @@
 #include "system/optionalnumber.h"
 
 #include "theatre/colordeduction.h"
+#include "theatre/controllable.h"
 
 namespace glight::theatre {
 
@@ -23,44 +27,60 @@ class RgbFilter : public Filter {
  public:
   FilterType GetType() const override { return FilterType::RgbColorspace; }
 
-  void SetMode(RgbFilterMode mode) { mode_ = mode; }
+  void SetMode(RgbFilterMode mode) {
+    mode_ = mode;
+    Controllable::NotifyShowChange();
+  }
+
+  using Filter::Apply;
+
+  void Apply(std::span<const ControlValue> input,
+             std::span<ControlValue> output) override {
+    ApplyTo([input](size_t i) { return input[i]; },
+            [output](size_t i) -> ControlValue& { return output[i]; });
+  }
+
+  /**
+   * Applies the filter to all fixtures of the batch. Which of the branches
+   * below is taken only depends on the output types, so it is the same
+   * for all fixtures, and the per-fixture work is reduced to arithmetic on
+   * strided values.
+   */
+  void ApplyBatch(std::span<const ControlValue> input,
+                  std::span<ControlValue> output, size_t n) override {
+    for (size_t f = 0; f != n; ++f) {
+      ApplyTo([input, n, f](size_t i) { return input[i * n + f]; },
+              [output, n, f](size_t i) -> ControlValue& {
+                return output[i * n + f];
+              });
+    }
+  }
+
+  bool HasSameSettings(const Filter& other) const override {
+    return other.GetType() == GetType() &&
+           static_cast<const RgbFilter&>(other).mode_ == mode_;
+  }
 
-  void Apply(const std::vector<ControlValue>& input,
-             std::vector<ControlValue>& output) override {
-    unsigned red = input[0].UInt();
-    unsigned green = input[1].UInt();
-    unsigned blue = input[2].UInt();
+ private:
+  /**
+   * @param input Function that returns the input value with a given index.
+   * @param output Function that returns a reference to the output value
+   * with a given index.
+   */
+  template <typename Input, typename Output>
+  void ApplyTo(Input input, Output output) {
+    if (decomposition_ == Decomposition::Macro) {
+      ApplyMacro(input, output);
+      return;
+    }
+    unsigned red = input(0).UInt();
+    unsigned green = input(1).UInt();
+    unsigned blue = input(2).UInt();
     // composed colour factor
     // The is for if there are more channels apart from composed
     // channels (like lime and amber), to leave some power in.
     constexpr unsigned ccf = 2;
-    if (macro_index_ && master_index_) {
-      const unsigned m = std::max({red, green, blue});
-      if (m != 0) {
-        red = ControlValue::Fraction(red, m);
-        green = ControlValue::Fraction(green, m);
-        blue = ControlValue::Fraction(blue, m);
-      }
-      const Color color(ControlValue(red).ToUChar(),
-                        ControlValue(green).ToUChar(),
-                        ControlValue(blue).ToUChar());
-      const unsigned short index = color_map_.GetIndex(color);
-      const std::vector<theatre::ColorRangeParameters::Range>& ranges =
-          OutputTypes()[*macro_index_].GetColorRangeParameters().GetRanges();
-      assert(index < ranges.size());
-      output[*macro_index_] = ControlValue::FromUChar(
-          (ranges[index].input_min + ranges[index].input_max) / 2);
-      output[*master_index_] = ControlValue(m);
-    } else if (macro_index_) {
-      const Color color(input[0].ToUChar(), input[1].ToUChar(),
-                        input[2].ToUChar());
-      const unsigned short index = color_map_.GetIndex(color);
-      const std::vector<theatre::ColorRangeParameters::Range>& ranges =
-          OutputTypes()[*macro_index_].GetColorRangeParameters().GetRanges();
-      assert(index < ranges.size());
-      output[*macro_index_] = ControlValue::FromUChar(
-          (ranges[index].input_min + ranges[index].input_max) / 2);
-    } else if (cw_index_ && ww_index_ && amber_index_) {
+    if (decomposition_ == Decomposition::ColdWarmAmber) {
       unsigned ww;
       unsigned cw;
       unsigned amber;
@@ -75,13 +95,13 @@ class RgbFilter : public Filter {
         ww = std::max(cw, difference) - difference;
         amber = std::max(cw, difference * 2) - difference * 2;
       }
-      output[*cw_index_] = ControlValue(cw);
-      output[*ww_index_] = ControlValue(ww);
-      output[*amber_index_] = ControlValue(amber);
+      output(*cw_index_) = ControlValue(cw);
+      output(*ww_index_) = ControlValue(ww);
+      output(*amber_index_) = ControlValue(amber);
       red -= (ww + cw * 57 / 64 + amber) / (3 * ccf);
       green -= ((ww + cw) * 57 / 64 + amber / 2) / (3 * ccf);
       blue -= (cw + ww * 57 / 64) / (3 * ccf);
-    } else if (ww_index_ && cw_index_) {
+    } else if (decomposition_ == Decomposition::ColdWarm) {
       // These equations will mix the cold and warm whites such
       // that they match the requested warmth of the light. This has the
       // consequence that the brightness is much higher when a neutral
@@ -98,8 +118,8 @@ class RgbFilter : public Filter {
         cw = std::min(std::min(red, green) * 64, blue * 57) / 57;
         ww = std::max(cw, difference) - difference;
       }
-      output[*ww_index_] = ControlValue(ww);
-      output[*cw_index_] = ControlValue(cw);
+      output(*ww_index_) = ControlValue(ww);
+      output(*cw_index_) = ControlValue(cw);
       red -= (ww + cw * 57 / 64) / (2 * ccf);
       green -= ((ww + cw) * 57 / 64) / (2 * ccf);
       blue -= (cw + ww * 57 / 64) / (2 * ccf);
@@ -107,7 +127,7 @@ class RgbFilter : public Filter {
       if (cw_index_) {
         const unsigned rg = std::min(red, green);
         const unsigned cw = std::min(rg * 64, blue * 57) / 64;
-        output[*cw_index_] = ControlValue(cw);
+        output(*cw_index_) = ControlValue(cw);
         red -= cw * 57 / (64 * ccf);
         green -= cw * 57 / (64 * ccf);
         blue -= cw / ccf;
@@ -115,68 +135,96 @@ class RgbFilter : public Filter {
       if (ww_index_) {
         const unsigned gb = std::min(green, blue);
         const unsigned ww = std::min(gb * 64, red * 57) / 64;
-        output[*ww_index_] = ControlValue(ww);
+        output(*ww_index_) = ControlValue(ww);
         red -= ww / ccf;
         green -= ww * 57 / (64 * ccf);
         blue -= ww * 57 / (64 * ccf);
       }
       if (amber_index_) {
         const unsigned amber = std::min(green * 2, red);
-        output[*amber_index_] = ControlValue(amber);
+        output(*amber_index_) = ControlValue(amber);
         red -= amber / ccf;
         green -= amber / (2 * ccf);
       }
     }
     if (lime_index_) {
       const unsigned lime = std::min(green, red * 2);
-      output[*lime_index_] = ControlValue(lime);
+      output(*lime_index_) = ControlValue(lime);
       red -= lime / (2 * ccf);
       green -= lime / ccf;
     }
     if (white_index_) {
       const unsigned white = std::min({green, red, blue});
-      output[*white_index_] = ControlValue(white);
+      output(*white_index_) = ControlValue(white);
       green -= white / ccf;
       red -= white / ccf;
       blue -= white / ccf;
     }
     if (red_index_) {
-      output[*red_index_] = ControlValue(red);
+      output(*red_index_) = ControlValue(red);
     }
     if (green_index_) {
-      output[*green_index_] = ControlValue(green);
+      output(*green_index_) = ControlValue(green);
     }
     if (blue_index_) {
-      output[*blue_index_] = ControlValue(blue);
+      output(*blue_index_) = ControlValue(blue);
     }
-    size_t input_index = 3;
-    for (size_t i = 0; i != OutputTypes().size(); ++i) {
-      const FunctionType type = OutputTypes()[i].Type();
-      switch (type) {
-        case FunctionType::Red:
-        case FunctionType::Green:
-        case FunctionType::Blue:
-        case FunctionType::Lime:
-        case FunctionType::Amber:
-        case FunctionType::White:
-        case FunctionType::ColdWhite:
-        case FunctionType::WarmWhite:
-        case FunctionType::ColorMacro:
-        case FunctionType::ColorWheel:
-          // Do nothing
-          break;
-        case FunctionType::Master:
-          if (!macro_index_) {
-            output[i] = input[input_index];
-            ++input_index;
-          }
-          break;
-        default:
-          output[i] = input[input_index];
-          ++input_index;
-          break;
+    ApplyPassthrough(input, output);
+  }
+
+  template <typename Input, typename Output>
+  void ApplyMacro(Input input, Output output) {
+    unsigned char red;
+    unsigned char green;
+    unsigned char blue;
+    if (master_index_) {
+      // Put the brightness in the master channel and select the macro
+      // with the normalized colour.
+      const unsigned m =
+          std::max({input(0).UInt(), input(1).UInt(), input(2).UInt()});
+      if (m != 0) {
+        const uint64_t reciprocal = (uint64_t(1) << 32) / m;
+        red = NormalizeToUChar(input(0).UInt(), m, reciprocal);
+        green = NormalizeToUChar(input(1).UInt(), m, reciprocal);
+        blue = NormalizeToUChar(input(2).UInt(), m, reciprocal);
+      } else {
+        red = 0;
+        green = 0;
+        blue = 0;
       }
+      output(*master_index_) = ControlValue(m);
+    } else {
+      red = input(0).ToUChar();
+      green = input(1).ToUChar();
+      blue = input(2).ToUChar();
     }
+    output(*macro_index_) = ControlValue::FromUChar(
+        macro_table_[color_map_->GetPosition(red, green, blue)]);
+    ApplyPassthrough(input, output);
+  }
+
+  /**
+   * Copies the inputs that are not colours to their outputs.
+   */
+  template <typename Input, typename Output>
+  void ApplyPassthrough(Input input, Output output) {
+    for (const std::pair<size_t, size_t>& indices : passthrough_) {
+      output(indices.first) = input(indices.second);
+    }
+  }
+
+  /**
+   * Returns the same as ControlValue(ControlValue::Fraction(value,
+   * maximum)).ToUChar(), for value <= maximum, but replaces the division
+   * by a multiplication with the reciprocal 2^32 / maximum. The estimate
+   * is at most one too low, which is corrected.
+   */
+  static unsigned char NormalizeToUChar(unsigned value, unsigned maximum,
+                                        uint64_t reciprocal) {
+    const uint64_t scaled = uint64_t(value) << 8;
+    uint64_t result = (scaled * reciprocal) >> 32;
+    if ((result + 1) * maximum <= scaled) ++result;
+    return std::min<uint64_t>(result, 255);
   }
 
  protected:
@@ -191,6 +239,8 @@ class RgbFilter : public Filter {
     ww_index_.Reset();
     macro_index_.Reset();
     master_index_.Reset();
+    passthrough_.clear();
+    macro_table_.clear();
 
     std::vector<FixtureModeFunction> input_types{
         FixtureModeFunction(FunctionType::Red, 0, {}, 0),
@@ -252,7 +302,14 @@ class RgbFilter : public Filter {
           else
             colors.emplace_back(Color::Black());
         }
-        color_map_ = system::ColorMap(colors, 8);
+        color_map_ = system::ColorMap::GetShared(colors, 8);
+        // Map every quantized colour directly to the DMX value of its macro
+        macro_table_.resize(color_map_->Size());
+        for (size_t i = 0; i != color_map_->Size(); ++i) {
+          const ColorRangeParameters::Range& range =
+              ranges[color_map_->GetIndexAt(i)];
+          macro_table_[i] = (range.input_min + range.input_max) / 2;
+        }
         if (master_index_) {
           for (auto iter = input_types.begin(); iter != input_types.end();
                ++iter) {
@@ -266,10 +323,57 @@ class RgbFilter : public Filter {
     } else {
       master_index_.Reset();
     }
+
+    if (macro_index_)
+      decomposition_ = Decomposition::Macro;
+    else if (cw_index_ && ww_index_ && amber_index_)
+      decomposition_ = Decomposition::ColdWarmAmber;
+    else if (cw_index_ && ww_index_)
+      decomposition_ = Decomposition::ColdWarm;
+    else
+      decomposition_ = Decomposition::Separate;
+
+    // Inputs after red, green and blue map to the outputs that are not
+    // colours, in the same order
+    size_t input_index = 3;
+    for (size_t i = 0; i != OutputTypes().size(); ++i) {
+      switch (OutputTypes()[i].Type()) {
+        case FunctionType::Red:
+        case FunctionType::Green:
+        case FunctionType::Blue:
+        case FunctionType::Lime:
+        case FunctionType::Amber:
+        case FunctionType::White:
+        case FunctionType::ColdWhite:
+        case FunctionType::WarmWhite:
+        case FunctionType::ColorMacro:
+        case FunctionType::ColorWheel:
+          break;
+        case FunctionType::Master:
+          if (!macro_index_) {
+            passthrough_.emplace_back(i, input_index);
+            ++input_index;
+          }
+          break;
+        default:
+          passthrough_.emplace_back(i, input_index);
+          ++input_index;
+          break;
+      }
+    }
+    assert(input_index == input_types.size());
     SetInputTypes(std::move(input_types));
   }
 
+  /**
+   * How the colour is decomposed into the outputs. This only depends on
+   * the output types, so it is determined once in
+   * @ref DetermineInputTypes().
+   */
+  enum class Decomposition { Macro, ColdWarmAmber, ColdWarm, Separate };
+
   RgbFilterMode mode_ = RgbFilterMode::Balanced;
+  Decomposition decomposition_ = Decomposition::Separate;
 
   system::OptionalNumber<size_t> red_index_;
   system::OptionalNumber<size_t> green_index_;
@@ -281,7 +385,11 @@ class RgbFilter : public Filter {
   system::OptionalNumber<size_t> ww_index_;
   system::OptionalNumber<size_t> macro_index_;
   system::OptionalNumber<size_t> master_index_;
-  system::ColorMap color_map_;
+  std::shared_ptr<const system::ColorMap> color_map_;
+  // DMX value of the colour macro for every position in color_map_
+  std::vector<unsigned char> macro_table_;
+  // Pairs of output and input indices of values that are copied
+  std::vector<std::pair<size_t, size_t>> passthrough_;
 };
 
 }  // namespace glight::theatre
@@ -8,7 +8,8 @@ namespace glight::theatre {
 Fixture::Fixture(Theatre &theatre, const FixtureMode &type,
                  const std::string &name)
     : NamedObject(name), theatre_(theatre), mode_(type) {
-  DmxChannel base_channel = theatre.FirstFreeChannel();
+  const DmxChannel base_channel =
+      theatre.FirstFreeChannel(0, type.ChannelCount());
   for (size_t ci = 0; ci != type.Functions().size(); ++ci) {
     const FixtureModeFunction function = type.Functions()[ci];
     const std::string name(AbbreviatedFunctionType(function.Type()));
@@ -19,19 +20,20 @@ Fixture::Fixture(Theatre &theatre, const FixtureMode &type,
       fine_channel = base_channel + *function.FineChannelOffset();
 
     functions_[ci]->SetChannel(main_channel, fine_channel);
+    functions_[ci]->SetPixelCount(function.PixelCount());
   }
 }
 
 void Fixture::IncChannel() {
   for (std::unique_ptr<FixtureFunction> &ff : functions_) ff->IncChannel();
 
-  theatre_.NotifyDmxChange();
+  theatre_.NotifyDmxChange(*this);
 }
 
 void Fixture::DecChannel() {
   for (std::unique_ptr<FixtureFunction> &ff : functions_) ff->DecChannel();
 
-  theatre_.NotifyDmxChange();
+  theatre_.NotifyDmxChange(*this);
 }
 
 DmxChannel Fixture::GetFirstChannel() const {
@@ -50,7 +52,7 @@ void Fixture::SetChannel(DmxChannel dmx_channel) {
     }
   }
 
-  theatre_.NotifyDmxChange();
+  theatre_.NotifyDmxChange(*this);
 }
 
 void Fixture::SetUniverse(unsigned universe) {
@@ -58,7 +60,7 @@ void Fixture::SetUniverse(unsigned universe) {
     ff->SetUniverse(universe);
   }
 
-  theatre_.NotifyDmxChange();
+  theatre_.NotifyDmxChange(*this);
 }
 
 double Fixture::GetBeamDirection(const ValueSnapshot &snapshot,
@@ -35,11 +35,12 @@ class Fixture : public NamedObject {
 
   std::vector<unsigned> GetChannels() const {
     std::vector<unsigned> channels;
+    std::vector<DmxChannel> dmx_channels;
     for (const std::unique_ptr<FixtureFunction> &ff : functions_) {
-      channels.emplace_back(ff->MainChannel().Channel());
-      if (ff->FineChannel())
-        channels.emplace_back(ff->FineChannel()->Channel());
+      ff->GetChannels(dmx_channels);
     }
+    for (const DmxChannel &channel : dmx_channels)
+      channels.emplace_back(channel.Channel());
     return channels;
   }
 
@@ -1,8 +1,10 @@
 #ifndef THEATRE_FIXTURE_CONTROL_H_
 #define THEATRE_FIXTURE_CONTROL_H_
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "controllable.h"
@@ -17,7 +19,10 @@ class FixtureControl final : public Controllable {
   FixtureControl(Fixture &fixture)
       : Controllable(fixture.Name()),
         fixture_(&fixture),
-        values_(fixture.Functions().size()) {}
+        stage_width_(fixture.Functions().size()),
+        values_(stage_width_) {
+    UpdatePixelLayout();
+  }
 
   Fixture &GetFixture() const { return *fixture_; }
 
@@ -53,24 +58,132 @@ class FixtureControl final : public Controllable {
   }
 
   void Mix(const Timing &, bool is_primary) override {
-    // Propagate control values through the filters
+    if (!is_batched_) MixFilters();
+  }
+
+  /**
+   * Applies the filters to the input values. This is normally done by
+   * @ref Mix(), except when the control is part of a @ref FilterBatcher.
+   */
+  void MixFilters() {
+    // Propagate control values through the filters. Each filter reads
+    // from one half of values_ and writes to the other half.
+    size_t input_offset = 0;
     for (auto iterator = filters_.rbegin(); iterator != filters_.rend();
          ++iterator) {
-      std::unique_ptr<Filter> &filter = *iterator;
-      scratch_.resize(filter->OutputTypes().size());
-      values_.resize(filter->InputTypes().size());
-      filter->Apply(values_, scratch_);
-      std::swap(scratch_, values_);
+      Filter &filter = **iterator;
+      const size_t output_offset = stage_width_ - input_offset;
+      filter.Apply(std::span<const ControlValue>(values_.data() + input_offset,
+                                                 filter.InputTypes().size()),
+                   std::span<ControlValue>(values_.data() + output_offset,
+                                           filter.OutputTypes().size()));
+      input_offset = output_offset;
     }
-    values_.resize(NInputs());
   }
 
+  /**
+   * The values for the fixture functions, as calculated by the last call
+   * to @ref Mix(). The list has one value per fixture function.
+   */
+  const ControlValue *FunctionValues() const {
+    return values_.data() + output_offset_;
+  }
+  ControlValue *FunctionValues() { return values_.data() + output_offset_; }
+
+  /**
+   * When batched, @ref Mix() does not apply the filters, because a
+   * @ref FilterBatcher does this for many controls at once.
+   */
+  void SetBatched(bool is_batched) { is_batched_ = is_batched; }
+  bool IsBatched() const { return is_batched_; }
+
   void GetChannelValues(unsigned *channelValues, unsigned universe) const {
+    const std::vector<FixtureModeFunction> &mode_functions =
+        fixture_->Mode().Functions();
     for (size_t i = 0; i != fixture_->Functions().size(); ++i) {
       const std::unique_ptr<FixtureFunction> &ff = fixture_->Functions()[i];
-      ff->MixChannels(values_[i].UInt(), MixStyle::Default, channelValues,
-                      universe);
+      const ResponseCurve &curve = mode_functions[i].Curve();
+      if (ff->PixelCount() != 0) {
+        if (ff->MainChannel().Universe() != universe) continue;
+        // The value of the function itself sets all cells, and the cell
+        // values are added on top.
+        const unsigned flood = FunctionValues()[i].UInt();
+        const std::span<const ControlValue> cells = PixelValues(i);
+        const unsigned first = ff->MainChannel().Channel();
+        for (size_t j = 0; j != cells.size(); ++j) {
+          channelValues[(first + j) % 512] +=
+              curve.Apply(flood + cells[j].UInt());
+        }
+      } else {
+        const unsigned value = curve.Apply(FunctionValues()[i].UInt());
+        ff->MixChannels(value, MixStyle::Default, channelValues, universe);
+      }
+    }
+  }
+
+  /**
+   * The red, green and blue values of the cells of the pixel block
+   * function with the given index, in channel order. These are added to the
+   * value of the function, which sets all cells at once. Effects may write
+   * them directly; they are cleared by @ref ClearPixelValues() at the start
+   * of every mix. The span is empty for functions that are not pixel
+   * blocks.
+   */
+  std::span<ControlValue> PixelValues(size_t function_index) {
+    return std::span<ControlValue>(
+        pixel_values_.data() + pixel_offsets_[function_index],
+        pixel_offsets_[function_index + 1] - pixel_offsets_[function_index]);
+  }
+  std::span<const ControlValue> PixelValues(size_t function_index) const {
+    return std::span<const ControlValue>(
+        pixel_values_.data() + pixel_offsets_[function_index],
+        pixel_offsets_[function_index + 1] - pixel_offsets_[function_index]);
+  }
+
+  /**
+   * The function index of the pixel block that is controlled by the given
+   * input, or the number of functions if the input does not control a
+   * pixel block. Filters pass pixel blocks through, so the n-th pixel block
+   * input controls the n-th pixel block function.
+   */
+  size_t PixelBlockFunction(size_t input_index) const {
+    const std::vector<std::unique_ptr<FixtureFunction>> &functions =
+        fixture_->Functions();
+    if (InputType(input_index) != FunctionType::PixelBlock)
+      return functions.size();
+    size_t n_before = 0;
+    for (size_t i = 0; i != input_index; ++i) {
+      if (InputType(i) == FunctionType::PixelBlock) ++n_before;
+    }
+    for (size_t i = 0; i != functions.size(); ++i) {
+      if (functions[i]->PixelCount() != 0) {
+        if (n_before == 0) return i;
+        --n_before;
+      }
+    }
+    return functions.size();
+  }
+
+  void ClearPixelValues() {
+    std::fill(pixel_values_.begin(), pixel_values_.end(), ControlValue(0));
+  }
+
+  /**
+   * Sizes the pixel values to the pixel counts of the fixture functions.
+   * Should be called after the pixel count of a function is changed;
+   * the values of all cells are cleared.
+   */
+  void UpdatePixelLayout() {
+    const std::vector<std::unique_ptr<FixtureFunction>> &functions =
+        fixture_->Functions();
+    pixel_offsets_.resize(functions.size() + 1);
+    size_t offset = 0;
+    for (size_t i = 0; i != functions.size(); ++i) {
+      pixel_offsets_[i] = offset;
+      offset += functions[i]->PixelCount() * 3;
     }
+    pixel_offsets_[functions.size()] = offset;
+    pixel_values_.assign(offset, ControlValue(0));
   }
 
   /**
@@ -86,7 +199,14 @@ class FixtureControl final : public Controllable {
       filters_.emplace_back(std::move(filter));
       filters_.back()->SetOutputTypes(previous_last->InputTypes());
     }
-    values_.resize(NInputs());
+    // Reserve two halves that can each hold the widest stage of the chain,
+    // so that Mix() never needs to allocate.
+    stage_width_ = fixture_->Functions().size();
+    for (const std::unique_ptr<Filter> &f : filters_)
+      stage_width_ = std::max(stage_width_, f->InputTypes().size());
+    values_.assign(stage_width_ * 2, ControlValue());
+    output_offset_ = filters_.size() % 2 == 0 ? 0 : stage_width_;
+    InvalidateInputReferences();
   }
 
   const std::vector<std::unique_ptr<Filter>> &Filters() const {
@@ -95,8 +215,17 @@ class FixtureControl final : public Controllable {
 
  private:
   Fixture *fixture_;
+  size_t stage_width_;
+  // The inputs start at the beginning of values_, and the result of the
+  // filters, which are the values for the fixture functions, starts at
+  // output_offset_.
+  size_t output_offset_ = 0;
+  bool is_batched_ = false;
   std::vector<ControlValue> values_;
-  std::vector<ControlValue> scratch_;
+  // The cell values of all pixel blocks. The cells of function i start at
+  // pixel_offsets_[i] and end at pixel_offsets_[i + 1].
+  std::vector<size_t> pixel_offsets_;
+  std::vector<ControlValue> pixel_values_;
   // The filters, in backward order. Therefore, filters_.back()
   // defines the inputs of this fixture, and the result of filters_.back()
   // is sent to the previous filter, unless filters_.front() is reached.
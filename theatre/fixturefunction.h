@@ -1,6 +1,7 @@
 #ifndef THEATRE_FIXTUREFUNCTION_H_
 #define THEATRE_FIXTUREFUNCTION_H_
 
+#include <algorithm>
 #include <optional>
 #include <string>
 #include <vector>
@@ -39,8 +40,11 @@ class FixtureFunction final : public NamedObject {
       } else {  // 16 bit
         const unsigned currentValue = (channels[main_channel_.Channel()]) +
                                       (channels[fine_channel_->Channel()] >> 8);
-        const unsigned mixedValue =
-            ControlValue::Mix(currentValue, value, mixStyle);
+        // Clip before splitting, so that an overflow saturates both
+        // channels instead of wrapping the fine channel.
+        const unsigned mixedValue = std::min(
+            ControlValue::Mix(currentValue, value, mixStyle),
+            ControlValue::MaxUInt());
         // Set to the first 8 of 24 bits.
         channels[main_channel_.Channel()] = (mixedValue & (~0xFFFF));
         // Set to bits 9-16.
@@ -52,14 +56,35 @@ class FixtureFunction final : public NamedObject {
   const std::optional<DmxChannel> &FineChannel() const { return fine_channel_; }
   const DmxChannel &MainChannel() const { return main_channel_; }
 
-  /** The caller must call theatre.NotifyDmxChange(); afterward. */
+  /**
+   * Number of RGB cells if this is a pixel block, or zero otherwise. The
+   * cells use three consecutive channels each, starting at the main
+   * channel.
+   */
+  unsigned PixelCount() const { return pixel_count_; }
+  /** The caller must call theatre.NotifyDmxChange(fixture); afterward. */
+  void SetPixelCount(unsigned pixel_count) { pixel_count_ = pixel_count; }
+
+  /**
+   * Adds all channels that this function uses to @p channels: the main
+   * channel, the fine channel if any and the other channels of a pixel
+   * block.
+   */
+  void GetChannels(std::vector<DmxChannel> &channels) const {
+    channels.emplace_back(main_channel_);
+    if (fine_channel_) channels.emplace_back(*fine_channel_);
+    for (unsigned i = 1; i < pixel_count_ * 3; ++i)
+      channels.emplace_back(main_channel_ + i);
+  }
+
+  /** The caller must call theatre.NotifyDmxChange(fixture); afterward. */
   void SetChannel(const DmxChannel &channel,
                   const std::optional<DmxChannel> &fine_channel = {});
-  /** The caller must call theatre.NotifyDmxChange(); afterward. */
+  /** The caller must call theatre.NotifyDmxChange(fixture); afterward. */
   void IncChannel();
-  /** The caller must call theatre.NotifyDmxChange(); afterward. */
+  /** The caller must call theatre.NotifyDmxChange(fixture); afterward. */
   void DecChannel();
-  /** The caller must call theatre.NotifyDmxChange(); afterward. */
+  /** The caller must call theatre.NotifyDmxChange(fixture); afterward. */
   void SetUniverse(unsigned universe) {
     main_channel_.SetUniverse(universe);
     if (fine_channel_) fine_channel_->SetUniverse(universe);
@@ -79,6 +104,7 @@ class FixtureFunction final : public NamedObject {
  private:
   DmxChannel main_channel_{0, 0};
   std::optional<DmxChannel> fine_channel_{};
+  unsigned pixel_count_ = 0;
 };
 
 }  // namespace glight::theatre
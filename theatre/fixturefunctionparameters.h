@@ -88,6 +88,17 @@ struct RotationSpeedParameters {
   std::vector<Range> ranges_;
 };
 
+struct PixelBlockParameters {
+  /** Number of RGB cells of the block. */
+  unsigned PixelCount() const { return pixel_count_; }
+  void SetPixelCount(unsigned pixel_count) {
+    pixel_count_ = std::max(pixel_count, 1u);
+  }
+
+ private:
+  unsigned pixel_count_ = 1;
+};
+
 struct FixtureFunctionParameters {
   void SetRotationSpeedParameters(
       const RotationSpeedParameters& rotation_parameters) {
@@ -103,6 +114,11 @@ struct FixtureFunctionParameters {
   }
   void UnsetColorRangeParameters() { parameters.Reset<ColorRangeParameters>(); }
 
+  void SetPixelBlockParameters(const PixelBlockParameters& pixel_block) {
+    parameters = system::MakeIndifferent<PixelBlockParameters>(pixel_block);
+  }
+  void UnsetPixelBlockParameters() { parameters.Reset<PixelBlockParameters>(); }
+
   system::IndifferentPtr parameters;
 };
 
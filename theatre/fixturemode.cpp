@@ -1,5 +1,6 @@
 #include "fixturemode.h"
 
+#include <algorithm>
 #include <array>
 
 #include "fixture.h"
@@ -14,7 +15,42 @@ void FixtureMode::UpdateFunctions() {
   max_values[0] = 0;
   max_values[1] = 0;
   max_values[2] = 0;
-  for (const FixtureModeFunction &f : functions_) {
+  channel_count_ = 0;
+  shapes_.clear();
+  for (size_t i = 0; i != functions_.size(); ++i) {
+    const FixtureModeFunction &f = functions_[i];
+    channel_count_ =
+        std::max(channel_count_, f.DmxOffset() + f.ChannelCount());
+    if (f.FineChannelOffset())
+      channel_count_ = std::max(channel_count_, *f.FineChannelOffset() + 1);
+    if (f.Shape() >= shapes_.size()) shapes_.resize(f.Shape() + 1);
+    ShapeFunctions &shape = shapes_[f.Shape()];
+    switch (f.Type()) {
+      case FunctionType::Master:
+        shape.master = i;
+        break;
+      case FunctionType::ColorMacro:
+      case FunctionType::ColorWheel:
+      case FunctionType::ColorTemperature:
+        shape.macro = i;
+        break;
+      case FunctionType::RotationSpeed:
+        if (!shape.rotation_speed) shape.rotation_speed = i;
+        break;
+      case FunctionType::Pan:
+        if (!shape.pan) shape.pan = i;
+        break;
+      case FunctionType::Tilt:
+        if (!shape.tilt) shape.tilt = i;
+        break;
+      case FunctionType::Zoom:
+        if (!shape.zoom) shape.zoom = i;
+        break;
+      default:
+        if (IsColor(f.Type()))
+          shape.colors.emplace_back(i, GetFunctionColor(f.Type()));
+        break;
+    }
     if (IsColor(f.Type())) {
       const Color c = GetFunctionColor(f.Type());
       max_values[0] += c.Red();
@@ -27,47 +63,46 @@ void FixtureMode::UpdateFunctions() {
 
 Color FixtureMode::GetColor(const Fixture &fixture,
                             const ValueSnapshot &snapshot,
-                            size_t shapeIndex) const {
-  unsigned red = 0;
-  unsigned green = 0;
-  unsigned blue = 0;
-  unsigned master = 255;
+                            size_t shape_index) const {
+  if (shape_index >= shapes_.size()) return Color::Black();
+  const ShapeFunctions &shape = shapes_[shape_index];
+  // Fine channels are ignored if they are present, because we can't
+  // visualize 16-bit rgb values anyway...
+  const unsigned master =
+      shape.master ? fixture.Functions()[*shape.master]->GetCharValue(snapshot)
+                   : 255;
   std::optional<Color> macro_color;
-  for (size_t i = 0; i != functions_.size(); ++i) {
-    const FixtureModeFunction &function = functions_[i];
-    if (function.Shape() == shapeIndex) {
-      const FixtureFunction &ff = *fixture.Functions()[i];
-      // Fine channel is ignored if it is present, because we can't
-      // visualize 16-bit rgb values anyway...
-      const unsigned channel_value = ff.GetCharValue(snapshot);
-      const FunctionType type = function.Type();
-      if (type == FunctionType::Master) {
-        master = channel_value;
-      } else if (type == FunctionType::ColorMacro ||
-                 type == FunctionType::ColorWheel) {
-        macro_color =
-            function.GetColorRangeParameters().GetColor(channel_value);
-      } else if (type == FunctionType::ColorTemperature) {
-        constexpr unsigned min_temperature = 2800;
-        constexpr unsigned max_temperature = 8000;
-        const unsigned temperature =
-            channel_value * (max_temperature - min_temperature) / 255 +
-            min_temperature;
-        macro_color = system::TemperatureToRgb(temperature);
-      } else if (IsColor(type)) {
-        const Color c = GetFunctionColor(function.Type()) * channel_value;
-        red += c.Red();
-        green += c.Green();
-        blue += c.Blue();
-      }
+  if (shape.macro) {
+    const FixtureModeFunction &function = functions_[*shape.macro];
+    const unsigned channel_value =
+        fixture.Functions()[*shape.macro]->GetCharValue(snapshot);
+    if (function.Type() == FunctionType::ColorTemperature) {
+      constexpr unsigned min_temperature = 2800;
+      constexpr unsigned max_temperature = 8000;
+      const unsigned temperature =
+          channel_value * (max_temperature - min_temperature) / 255 +
+          min_temperature;
+      macro_color = system::TemperatureToRgb(temperature);
+    } else {
+      macro_color = function.GetColorRangeParameters().GetColor(channel_value);
     }
   }
   if (macro_color) {
-    red = macro_color->Red();
-    green = macro_color->Green();
-    blue = macro_color->Blue();
-    return Color(red * master / 256, green * master / 256, blue * master / 256);
+    return Color(macro_color->Red() * master / 256,
+                 macro_color->Green() * master / 256,
+                 macro_color->Blue() * master / 256);
   } else {
+    unsigned red = 0;
+    unsigned green = 0;
+    unsigned blue = 0;
+    for (const std::pair<size_t, Color> &color : shape.colors) {
+      const unsigned channel_value =
+          fixture.Functions()[color.first]->GetCharValue(snapshot);
+      const Color c = color.second * channel_value;
+      red += c.Red();
+      green += c.Green();
+      blue += c.Blue();
+    }
     return Color(red * master / scaling_value_, green * master / scaling_value_,
                  blue * master / scaling_value_);
   }
@@ -76,67 +111,57 @@ Color FixtureMode::GetColor(const Fixture &fixture,
 int FixtureMode::GetRotationSpeed(const Fixture &fixture,
                                   const ValueSnapshot &snapshot,
                                   size_t shape_index) const {
-  for (size_t i = 0; i != functions_.size(); ++i) {
-    if (functions_[i].Shape() == shape_index &&
-        functions_[i].Type() == FunctionType::RotationSpeed) {
-      const unsigned channel_value =
-          fixture.Functions()[i]->GetCharValue(snapshot);
-      return functions_[i].GetRotationSpeedParameters().GetSpeed(channel_value);
-    }
-  }
-  return 0;
+  if (shape_index >= shapes_.size()) return 0;
+  const std::optional<size_t> index = shapes_[shape_index].rotation_speed;
+  if (!index) return 0;
+  const unsigned channel_value =
+      fixture.Functions()[*index]->GetCharValue(snapshot);
+  return functions_[*index].GetRotationSpeedParameters().GetSpeed(
+      channel_value);
 }
 
 double FixtureMode::GetPan(const Fixture &fixture,
                            const ValueSnapshot &snapshot,
                            size_t shape_index) const {
-  for (size_t i = 0; i != functions_.size(); ++i) {
-    if (functions_[i].Shape() == shape_index &&
-        functions_[i].Type() == FunctionType::Pan) {
-      const unsigned channel_value =
-          fixture.Functions()[i]->GetControlValue(snapshot);
-      const double max_pan = Type().MaxPan();
-      const double min_pan = Type().MinPan();
-      return (max_pan - min_pan) * channel_value / ControlValue::MaxUInt() +
-             min_pan;
-    }
-  }
-  return 0.0;
+  if (shape_index >= shapes_.size()) return 0.0;
+  const std::optional<size_t> index = shapes_[shape_index].pan;
+  if (!index) return 0.0;
+  const unsigned channel_value =
+      fixture.Functions()[*index]->GetControlValue(snapshot);
+  const double max_pan = Type().MaxPan();
+  const double min_pan = Type().MinPan();
+  return (max_pan - min_pan) * channel_value / ControlValue::MaxUInt() +
+         min_pan;
 }
 
 double FixtureMode::GetTilt(const Fixture &fixture,
                             const ValueSnapshot &snapshot,
                             size_t shape_index) const {
-  for (size_t i = 0; i != functions_.size(); ++i) {
-    if (functions_[i].Shape() == shape_index &&
-        functions_[i].Type() == FunctionType::Tilt) {
-      const unsigned channel_value =
-          fixture.Functions()[i]->GetControlValue(snapshot);
-      const double max_tilt = Type().MaxTilt();
-      const double min_tilt = Type().MinTilt();
-      return (max_tilt - min_tilt) * channel_value / ControlValue::MaxUInt() +
-             min_tilt;
-    }
-  }
-  return 0.0;
+  if (shape_index >= shapes_.size()) return 0.0;
+  const std::optional<size_t> index = shapes_[shape_index].tilt;
+  if (!index) return 0.0;
+  const unsigned channel_value =
+      fixture.Functions()[*index]->GetControlValue(snapshot);
+  const double max_tilt = Type().MaxTilt();
+  const double min_tilt = Type().MinTilt();
+  return (max_tilt - min_tilt) * channel_value / ControlValue::MaxUInt() +
+         min_tilt;
 }
 
 double FixtureMode::GetZoom(const Fixture &fixture,
                             const ValueSnapshot &snapshot,
                             size_t shape_index) const {
-  for (size_t i = 0; i != functions_.size(); ++i) {
-    if (functions_[i].Shape() == shape_index &&
-        functions_[i].Type() == FunctionType::Zoom) {
-      const unsigned channel_value =
-          fixture.Functions()[i]->GetControlValue(snapshot);
-      const double max_beam_angle = Type().MaxBeamAngle();
-      const double min_beam_angle = Type().MinBeamAngle();
-      return (max_beam_angle - min_beam_angle) * channel_value /
-                 ControlValue::MaxUInt() +
-             min_beam_angle;
-    }
-  }
-  return Type().MinBeamAngle();
+  const std::optional<size_t> index =
+      shape_index < shapes_.size() ? shapes_[shape_index].zoom
+                                   : std::optional<size_t>();
+  if (!index) return Type().MinBeamAngle();
+  const unsigned channel_value =
+      fixture.Functions()[*index]->GetControlValue(snapshot);
+  const double max_beam_angle = Type().MaxBeamAngle();
+  const double min_beam_angle = Type().MinBeamAngle();
+  return (max_beam_angle - min_beam_angle) * channel_value /
+             ControlValue::MaxUInt() +
+         min_beam_angle;
 }
 
 double FixtureMode::GetPower(const Fixture &fixture,
@@ -2,6 +2,7 @@
 #define THEATRE_FIXTURE_MODE_H_
 
 #include <map>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -65,13 +66,36 @@ class FixtureMode : public NamedObject {
     UpdateFunctions();
   }
   unsigned ColorScalingValue() const { return scaling_value_; }
+  /**
+   * Number of consecutive DMX channels occupied by a fixture in this mode,
+   * i.e. one more than the highest channel offset of its functions.
+   */
+  size_t ChannelCount() const { return channel_count_; }
 
  private:
+  /**
+   * Indices of the functions that determine the visual state of one shape,
+   * such that decoding a shape does not need to scan all functions.
+   */
+  struct ShapeFunctions {
+    // Colour functions (excluding macros) and the colour they represent
+    std::vector<std::pair<size_t, Color>> colors;
+    std::optional<size_t> master;
+    // Colour macro, colour wheel or colour temperature function
+    std::optional<size_t> macro;
+    std::optional<size_t> rotation_speed;
+    std::optional<size_t> pan;
+    std::optional<size_t> tilt;
+    std::optional<size_t> zoom;
+  };
+
   void UpdateFunctions();
 
   std::vector<FixtureModeFunction> functions_;
+  std::vector<ShapeFunctions> shapes_;
   FixtureType *type_;
   unsigned scaling_value_ = 0;
+  size_t channel_count_ = 0;
 };
 
 inline std::string FunctionSummary(const FixtureMode &fixture_mode) {
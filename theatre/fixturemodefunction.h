@@ -3,6 +3,7 @@
 
 #include "functiontype.h"
 #include "fixturefunctionparameters.h"
+#include "responsecurve.h"
 
 #include "system/optionalnumber.h"
 
@@ -36,7 +37,8 @@ class FixtureModeFunction {
         dmx_offset_(source.dmx_offset_),
         fine_channel_(source.fine_channel_),
         shape_(source.shape_),
-        power_(source.power_) {
+        power_(source.power_),
+        curve_(source.curve_) {
     CopyParameters(source);
   }
 
@@ -47,6 +49,7 @@ class FixtureModeFunction {
     fine_channel_ = source.fine_channel_;
     shape_ = source.shape_;
     power_ = source.power_;
+    curve_ = source.curve_;
     CopyParameters(source);
     return *this;
   }
@@ -63,6 +66,13 @@ class FixtureModeFunction {
   unsigned Power() const { return power_; }
   void SetPower(unsigned power) { power_ = power; }
 
+  /**
+   * Response curve that is applied to the value of this function when it
+   * is written to the DMX channels. By default, the curve is linear.
+   */
+  const ResponseCurve& Curve() const { return curve_; }
+  void SetCurve(ResponseCurve curve) { curve_ = std::move(curve); }
+
   /**
    * Optional dmx channel offset from fixture starting channel, of the
    * fine channel that corresponds to this function. If set, it implies 16 bits
@@ -91,6 +101,32 @@ class FixtureModeFunction {
     return parameters_.parameters.Get<ColorRangeParameters>();
   }
 
+  PixelBlockParameters& GetPixelBlockParameters() {
+    return parameters_.parameters.Get<PixelBlockParameters>();
+  }
+  const PixelBlockParameters& GetPixelBlockParameters() const {
+    return parameters_.parameters.Get<PixelBlockParameters>();
+  }
+
+  /**
+   * Number of RGB cells of a pixel block function, or zero for other
+   * functions.
+   */
+  unsigned PixelCount() const {
+    return type_ == FunctionType::PixelBlock
+               ? GetPixelBlockParameters().PixelCount()
+               : 0;
+  }
+
+  /**
+   * Number of channels used by this function, counted from its
+   * @ref DmxOffset(), not including the fine channel. This is three per
+   * cell for a pixel block, and one for other functions.
+   */
+  size_t ChannelCount() const {
+    return type_ == FunctionType::PixelBlock ? PixelCount() * 3 : 1;
+  }
+
  private:
   void ConstructParameters() {
     switch (type_) {
@@ -101,6 +137,9 @@ class FixtureModeFunction {
       case FunctionType::RotationSpeed:
         parameters_.SetRotationSpeedParameters(RotationSpeedParameters());
         break;
+      case FunctionType::PixelBlock:
+        parameters_.SetPixelBlockParameters(PixelBlockParameters());
+        break;
       default:
         break;
     }
@@ -115,6 +154,9 @@ class FixtureModeFunction {
       case FunctionType::RotationSpeed:
         parameters_.UnsetRotationParameters();
         break;
+      case FunctionType::PixelBlock:
+        parameters_.UnsetPixelBlockParameters();
+        break;
       default:
         break;
     }
@@ -131,6 +173,10 @@ class FixtureModeFunction {
         parameters_.SetRotationSpeedParameters(
             source.parameters_.parameters.Get<RotationSpeedParameters>());
         break;
+      case FunctionType::PixelBlock:
+        parameters_.SetPixelBlockParameters(
+            source.parameters_.parameters.Get<PixelBlockParameters>());
+        break;
       default:
         break;
     }
@@ -141,6 +187,7 @@ class FixtureModeFunction {
   system::OptionalNumber<size_t> fine_channel_;
   unsigned shape_;
   unsigned power_ = 0;
+  ResponseCurve curve_;
   FixtureFunctionParameters parameters_;
 };
 
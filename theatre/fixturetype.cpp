@@ -248,11 +248,19 @@ FixtureType::FixtureType(StockFixture stock_fixture)
       data_.max_beam_angle_ = 50.0 * M_PI / 180.0;
       data_.short_name_ = "Move+Zoom";
       break;
+    case StockFixture::RgbPixelBar: {
+      FixtureModeFunction &block =
+          functions.emplace_back(FunctionType::PixelBlock, 0, empty_channel, 0);
+      block.GetPixelBlockParameters().SetPixelCount(32);
+      data_.short_name_ = "Bar";
+    } break;
   }
   data_.max_power_ = 0;
   for (FixtureModeFunction &function : functions) {
     if (IsColor(function.Type())) {
       function.SetPower(10);
+    } else if (function.Type() == FunctionType::PixelBlock) {
+      function.SetPower(function.PixelCount());
     }
     data_.max_power_ += function.Power();
   }
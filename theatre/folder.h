@@ -2,7 +2,11 @@
 #define THEATRE_FOLDER_H_
 
 #include <algorithm>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "folderobject.h"
@@ -42,12 +46,14 @@ class Folder : public FolderObject {
           ", but an object with that name already exists in this folder");
     _objects.emplace_back(std::move(object));
     ptr->SetParent(*this);
+    AddToIndex(*ptr);
   }
 
   void Remove(FolderObject &object) {
     std::vector<system::ObservingPtr<FolderObject>>::iterator srciter =
         std::find(_objects.begin(), _objects.end(), &object);
     _objects.erase(srciter);
+    RemoveFromIndex(object, object.Name());
   }
 
   void MoveUp(FolderObject &object) {
@@ -93,37 +99,48 @@ class Folder : public FolderObject {
   FolderObject *FollowRelPath(std::string &&path);
 
   FolderObject &GetChild(const std::string &name) {
-    return *FindNamedObject(_objects, name);
+    return const_cast<FolderObject &>(std::as_const(*this).GetChild(name));
   }
 
   FolderObject *GetChildIfExists(std::string_view name) {
-    return FindNamedObjectIfExists(_objects, name).Get();
+    return const_cast<FolderObject *>(
+        std::as_const(*this).GetChildIfExists(name));
   }
 
   const FolderObject &GetChild(std::string_view name) const {
-    return *FindNamedObject(_objects, name);
+    const FolderObject *child = GetChildIfExists(name);
+    if (!child)
+      throw std::runtime_error("Could not find named object " +
+                               std::string(name) + " in container.");
+    return *child;
   }
 
   const FolderObject *GetChildIfExists(std::string_view name) const {
-    return FindNamedObjectIfExists(_objects, name).Get();
+    if (is_indexed_) {
+      const auto iter = name_index_.find(name);
+      return iter == name_index_.end() ? nullptr : iter->second;
+    } else {
+      return FindNamedObjectIfExists(_objects, name).Get();
+    }
   }
 
+  /**
+   * Returns the first name of the form prefix + number that is not yet
+   * used in this folder, where numbering starts at 1. To avoid rechecking
+   * the same names when many objects with the same prefix are added, the
+   * last returned number is remembered per prefix until a child is removed
+   * or renamed.
+   */
   std::string GetAvailableName(const std::string &prefix) const {
-    bool nameAvailable;
-    size_t nameNumber = 0;
+    size_t &nameNumber = available_name_hints_[prefix];
     std::string proposed_name;
     do {
-      nameAvailable = true;
       ++nameNumber;
       proposed_name = prefix + std::to_string(nameNumber);
-      for (const system::ObservingPtr<FolderObject> &object : _objects) {
-        if (object->Name() == proposed_name) {
-          nameAvailable = false;
-          break;
-        }
-      }
-    } while (!nameAvailable);
-    return prefix + std::to_string(nameNumber);
+    } while (GetChildIfExists(proposed_name));
+    // The proposed name is not yet taken, so it might be returned again
+    --nameNumber;
+    return proposed_name;
   }
 
   std::string GetAvailableName(std::string_view prefix) const {
@@ -146,23 +163,79 @@ class Folder : public FolderObject {
 
       destination._objects.emplace_back(std::move(object));
       ptr->_parent = &destination;
+      destination.AddToIndex(*ptr);
     }
   }
 
+  /**
+   * Folders with at least this many children keep a hash index from name to
+   * child. Smaller folders use a linear search over their children.
+   */
+  static constexpr size_t kIndexThreshold = 16;
+
+  bool IsIndexed() const { return is_indexed_; }
+
  private:
+  friend class FolderObject;
+
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+      return std::hash<std::string_view>()(name);
+    }
+  };
+
+  void AddToIndex(FolderObject &object) {
+    if (is_indexed_) {
+      name_index_.emplace(object.Name(), &object);
+    } else if (_objects.size() >= kIndexThreshold) {
+      is_indexed_ = true;
+      name_index_.reserve(_objects.size() * 2);
+      for (const system::ObservingPtr<FolderObject> &child : _objects) {
+        name_index_.emplace(child->Name(), child.Get());
+      }
+    }
+  }
+
+  /**
+   * Removes the index entry of @p name if it refers to @p object. Renaming
+   * can give two children the same name. In that case the index holds the
+   * first of them, and when that child is removed from the index, the
+   * next child with the name takes its place, as a linear search would
+   * find it.
+   */
+  void RemoveFromIndex(const FolderObject &object, std::string_view name) {
+    available_name_hints_.clear();
+    if (is_indexed_) {
+      const auto iter = name_index_.find(name);
+      if (iter != name_index_.end() && iter->second == &object) {
+        name_index_.erase(iter);
+        for (const system::ObservingPtr<FolderObject> &child : _objects) {
+          if (child.Get() != &object && child->Name() == name) {
+            name_index_.emplace(child->Name(), child.Get());
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  void OnChildRenamed(FolderObject &child, const std::string &old_name) {
+    RemoveFromIndex(child, old_name);
+    if (is_indexed_) name_index_.emplace(child.Name(), &child);
+  }
+
   Folder *followDown(const std::string &path, size_t strPos) const {
     auto sep = std::find(path.begin() + strPos, path.end(), '/');
     std::string subpath;
+    const std::string_view view(path);
     if (sep == path.end()) {
-      FolderObject *obj =
-          FindNamedObjectIfExists(_objects, path.substr(strPos)).Get();
-      return dynamic_cast<Folder *>(obj);
+      const FolderObject *obj = GetChildIfExists(view.substr(strPos));
+      return const_cast<Folder *>(dynamic_cast<const Folder *>(obj));
     } else {
-      FolderObject *obj =
-          FindNamedObjectIfExists(
-              _objects, path.substr(strPos, sep - path.begin() - strPos))
-              .Get();
-      Folder *folder = dynamic_cast<Folder *>(obj);
+      const FolderObject *obj = GetChildIfExists(
+          view.substr(strPos, sep - path.begin() - strPos));
+      const Folder *folder = dynamic_cast<const Folder *>(obj);
       if (folder)
         return folder->followDown(path, sep + 1 - path.begin());
       else
@@ -173,17 +246,14 @@ class Folder : public FolderObject {
   Folder *followDown(std::string &&path, size_t strPos) const {
     auto sep = std::find(path.begin() + strPos, path.end(), '/');
     std::string subpath;
+    const std::string_view view(path);
     if (sep == path.end()) {
-      FolderObject *obj =
-          FindNamedObjectIfExists(_objects, std::move(path).substr(strPos))
-              .Get();
-      return dynamic_cast<Folder *>(obj);
+      const FolderObject *obj = GetChildIfExists(view.substr(strPos));
+      return const_cast<Folder *>(dynamic_cast<const Folder *>(obj));
     } else {
-      FolderObject *obj =
-          FindNamedObjectIfExists(
-              _objects, path.substr(strPos, sep - path.begin() - strPos))
-              .Get();
-      Folder *folder = dynamic_cast<Folder *>(obj);
+      const FolderObject *obj = GetChildIfExists(
+          view.substr(strPos, sep - path.begin() - strPos));
+      const Folder *folder = dynamic_cast<const Folder *>(obj);
       if (folder)
         return folder->followDown(std::move(path), sep + 1 - path.begin());
       else
@@ -192,6 +262,10 @@ class Folder : public FolderObject {
   }
 
   std::vector<system::ObservingPtr<FolderObject>> _objects;
+  bool is_indexed_ = false;
+  std::unordered_map<std::string, FolderObject *, NameHash, std::equal_to<>>
+      name_index_;
+  mutable std::unordered_map<std::string, size_t> available_name_hints_;
 };
 
 }  // namespace glight::theatre
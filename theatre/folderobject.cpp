@@ -29,4 +29,8 @@ std::string FolderObject::FullPath() const {
   return str.str();
 }
 
+void FolderObject::OnRename(const std::string &old_name) {
+  if (_parent) _parent->OnChildRenamed(*this, old_name);
+}
+
 }  // namespace glight::theatre
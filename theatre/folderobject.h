@@ -34,6 +34,9 @@ class FolderObject : public NamedObject {
   const Folder &Parent() const { return *_parent; }
   Folder &Parent() { return *_parent; }
 
+ protected:
+  void OnRename(const std::string &old_name) override;
+
  private:
   void SetParent(Folder &parent) { _parent = &parent; }
 
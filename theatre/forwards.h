@@ -5,6 +5,7 @@ namespace glight::theatre {
 
 class BeatFinder;
 class Chase;
+class ChaseGroup;
 class Color;
 class Controllable;
 class ControlSceneItem;
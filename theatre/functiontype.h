@@ -37,6 +37,11 @@ enum class FunctionType {
   Saturation,
   Lightness,
   Combined,
+  /**
+   * A row of RGB cells, such as the cells of a pixel bar. One pixel block
+   * function occupies three consecutive channels per cell.
+   */
+  PixelBlock,
   Unknown
 };
 
@@ -49,7 +54,8 @@ inline std::vector<FunctionType> GetFunctionTypes() {
       FT::Pan,        FT::Tilt,      FT::Zoom,      FT::Focus,
       FT::Effect,     FT::ColdWhite, FT::WarmWhite, FT::ColorTemperature,
       FT::ColorWheel, FT::GoboWheel, FT::Prism,     FT::Hue,
-      FT::Saturation, FT::Lightness, FT::Combined,  FT::Unknown};
+      FT::Saturation, FT::Lightness, FT::Combined,  FT::PixelBlock,
+      FT::Unknown};
 }
 
 inline const char* AbbreviatedFunctionType(FunctionType functionType) {
@@ -86,6 +92,8 @@ inline const char* AbbreviatedFunctionType(FunctionType functionType) {
       return "M";
     case FunctionType::Pan:
       return "Pn";
+    case FunctionType::PixelBlock:
+      return "Px";
     case FunctionType::Prism:
       return "Pr";
     case FunctionType::Pulse:
@@ -164,6 +172,8 @@ inline FunctionType GetFunctionType(const std::string& name) {
         return FunctionType::Prism;
       else if (name == "Pulse")
         return FunctionType::Pulse;
+      else if (name == "Pixel block")
+        return FunctionType::PixelBlock;
       break;
     case 'R':
       if (name == "Red") return FunctionType::Red;
@@ -229,6 +239,8 @@ inline std::string ToString(FunctionType functionType) {
       return "Master";
     case FunctionType::Pan:
       return "Pan";
+    case FunctionType::PixelBlock:
+      return "Pixel block";
     case FunctionType::Prism:
       return "Prism";
     case FunctionType::Pulse:
@@ -278,6 +290,7 @@ inline constexpr bool IsColor(FunctionType type) {
     case FunctionType::Zoom:
     case FunctionType::Unknown:
     case FunctionType::Hue:
+    case FunctionType::PixelBlock:
       return false;
     case FunctionType::Red:
     case FunctionType::Green:
@@ -314,6 +327,7 @@ inline constexpr Color GetFunctionColor(FunctionType type) {
     case FunctionType::Strobe:
     case FunctionType::Tilt:
     case FunctionType::Zoom:
+    case FunctionType::PixelBlock:
     case FunctionType::Unknown:
       return Color::White();
     case FunctionType::Red:
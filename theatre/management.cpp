@@ -4,7 +4,9 @@
 
 #include <ranges>
 
+#include "beatclock.h"
 #include "chase.h"
+#include "chasegroup.h"
 #include "controllable.h"
 #include "effect.h"
 #include "fixturecontrol.h"
@@ -35,7 +37,8 @@ using system::TrackablePtr;
 Management::Management(const system::Settings &settings)
     : settings_(settings),
       _randomGenerator(std::random_device()()),
-      _theatre(std::make_unique<Theatre>()) {
+      _theatre(std::make_unique<Theatre>()),
+      output_dithering_(settings.output_dithering) {
   _rootFolder = _folders.emplace_back(MakeTrackable<Folder>()).Get();
   _rootFolder->SetName("Root");
 }
@@ -54,19 +57,57 @@ void Management::StartBeatFinder() {
   // In case the beat finder is already running, it is better to stop it first
   // so the audio device is not used twice.
   _beatFinder.reset();
-  _beatFinder = std::make_unique<BeatFinder>(settings_.audio_input);
+  _beatFinder =
+      std::make_unique<BeatFinder>(settings_.audio_input, _createTime);
   _beatFinder->Start();
 }
 
 void Management::Clear() {
   _controllables.clear();
   _groups.clear();
+  chase_groups_.clear();
   _sourceValues.clear();
   _folders.clear();
   _rootFolder = _folders.emplace_back(std::make_unique<Folder>()).Get();
   _rootFolder->SetName("Root");
 
   _theatre->Clear();
+  InvalidatePlan();
+}
+
+void Management::BeginBatch() {
+  if (batch_depth_ == 0) _theatre->SetDmxChangesDeferred(true);
+  ++batch_depth_;
+}
+
+void Management::EndBatch() {
+  assert(batch_depth_ != 0);
+  --batch_depth_;
+  if (batch_depth_ == 0) {
+    _theatre->SetDmxChangesDeferred(false);
+    if (plan_is_dirty_) UpdatePlan();
+  }
+}
+
+void Management::InvalidatePlan() {
+  if (batch_depth_ == 0)
+    UpdatePlan();
+  else
+    plan_is_dirty_ = true;
+}
+
+void Management::UpdatePlan() {
+  fixture_controls_.clear();
+  fixture_control_indices_.clear();
+  for (size_t i = 0; i != _controllables.size(); ++i) {
+    if (FixtureControl *fc =
+            dynamic_cast<FixtureControl *>(_controllables[i].Get())) {
+      fixture_controls_.emplace_back(fc);
+      fixture_control_indices_.emplace(&fc->GetFixture(), i);
+    }
+  }
+  plan_is_dirty_ = false;
+  channel_writer_is_dirty_ = true;
 }
 
 void Management::UpdateUniverses() {
@@ -85,29 +126,29 @@ void Management::Run() {
     throw std::runtime_error("Invalid call to Run(): already running");
 }
 
-void Management::InferInputUniverse(unsigned universe, ValueSnapshot &snapshot,
-                                    bool is_primary) {
-  unsigned values[kChannelsPerUniverse];
+void Management::WriteUniverse(unsigned universe) {
+  // Only channels up to the highest patched channel of this universe can be
+  // set by fixtures, so the rest is left zero.
+  const std::optional<unsigned> highest = _theatre->HighestChannel(universe);
+  const size_t n_channels = highest ? *highest + 1 : 0;
+  unsigned *values = channel_values_[universe].data();
+  std::fill_n(values, n_channels, 0);
 
-  std::fill_n(values, kChannelsPerUniverse, 0);
-
-  for (const TrackablePtr<Controllable> &controllable : _controllables) {
-    if (FixtureControl *fc =
-            dynamic_cast<FixtureControl *>(controllable.Get())) {
-      fc->GetChannelValues(values, universe);
-    }
-  }
+  channel_writer_.Write(universe, values);
+}
 
-  unsigned char values_char[kChannelsPerUniverse];
-  for (unsigned i = 0; i < kChannelsPerUniverse; ++i) {
-    unsigned val = (values[i] >> 16);
-    if (val > 255) val = 255;
-    values_char[i] = static_cast<unsigned char>(val);
-  }
+void Management::InferInputUniverse(unsigned universe, ValueSnapshot &snapshot,
+                                    bool is_primary) {
+  const std::optional<unsigned> highest = _theatre->HighestChannel(universe);
+  const size_t n_channels = highest ? *highest + 1 : 0;
+  unsigned char values_char[kChannelsPerUniverse] = {};
+  output_dither_.Convert(universe, is_primary,
+                         channel_values_[universe].data(), values_char,
+                         n_channels, output_dithering_);
 
   ValueUniverseSnapshot &universe_values =
       snapshot.GetUniverseSnapshot(universe);
-  universe_values.SetValues(values_char, _theatre->HighestChannel() + 1);
+  universe_values.SetValues(values_char, kChannelsPerUniverse);
 }
 
 void Management::MergeInputUniverse(ValueSnapshot &snapshot,
@@ -138,6 +179,7 @@ void Management::ThreadLoop() {
     std::lock_guard<std::mutex> lock(_mutex);
     swap(_primarySnapshot, next_primary);
     swap(_secondarySnapshot, next_secondary);
+    power_per_phase_ = power_estimator_.Phases();
 
     ++timestep_number;
   }
@@ -149,13 +191,17 @@ void Management::MixAll(unsigned timestep_number, ValueSnapshot &primary,
                         ValueSnapshot &secondary) {
   const double relTimeInMs = GetOffsetTimeInMS();
   double beatValue = 0.0;
+  double beatDuration = 0.0;
   unsigned audioLevel = 0;
   // Get the beat
   if (relTimeInMs - _lastOverridenBeatTime < 8000.0 && _overridenBeat != 0) {
     beatValue = _overridenBeat;
   } else if (_beatFinder) {
-    double beatConfidence = 0.0;
-    _beatFinder->GetBeatValue(beatValue, beatConfidence);
+    // The beat clock uses the same time origin, so the beat is evaluated at
+    // the exact time of this frame.
+    const BeatClock beat_clock = _beatFinder->GetBeatClock();
+    beatValue = beat_clock.BeatValue(relTimeInMs);
+    beatDuration = beat_clock.BeatDuration();
   } else {
     beatValue = 0.0;
   }
@@ -167,23 +213,47 @@ void Management::MixAll(unsigned timestep_number, ValueSnapshot &primary,
 
   const unsigned randomValue = _rndDistribution(_randomGenerator);
   const Timing timing(relTimeInMs, timestep_number, beatValue, audioLevel,
-                      randomValue);
+                      randomValue, beatDuration);
   const double timePassed = (relTimeInMs - _previousTime) * 1e-3;
   _previousTime = relTimeInMs;
 
   std::lock_guard<std::mutex> lock(_mutex);
-  for (std::unique_ptr<SourceValue> &sv : _sourceValues) {
-    sv->ApplyFade(timePassed);
-  }
+  fade_processor_.Process(timePassed);
 
-  // Solve dependency graph of controllables
-  std::vector<Controllable *> unorderedList;
+  // Solve dependency graph of controllables. Connections can be changed
+  // without passing through Management, so this is redone every frame.
+  std::vector<Controllable *> &unorderedList = unordered_controllables_;
+  std::vector<Controllable *> &orderedList = ordered_controllables_;
+  unorderedList.clear();
   for (const TrackablePtr<Controllable> &c : _controllables)
     unorderedList.emplace_back(c.Get());
-  std::vector<Controllable *> orderedList;
+  orderedList.clear();
   if (!topologicalSort(unorderedList, orderedList))
     throw std::runtime_error("Cycle in dependencies");
 
+  // Fixtures can be re-patched without passing through Management, so the
+  // patch generation of the theatre is checked as well.
+  if (channel_writer_is_dirty_ || filter_batcher_.IsDirty() ||
+      channel_writer_generation_ != _theatre->PatchGeneration()) {
+    for (FixtureControl *control : fixture_controls_)
+      control->UpdatePixelLayout();
+    channel_writer_.Compile(fixture_controls_);
+    filter_batcher_.Compile(fixture_controls_);
+    output_dither_.Compile(fixture_controls_);
+    channel_writer_is_dirty_ = false;
+    channel_writer_generation_ = _theatre->PatchGeneration();
+    power_estimator_is_dirty_ = true;
+  }
+  if (power_estimator_is_dirty_.exchange(false)) {
+    power_estimator_.Compile(_theatre->Fixtures());
+    power_limiter_.Compile(_theatre->Fixtures());
+  }
+
+  // The chase groups are advanced once, so that their chases see the same
+  // position in both the primary and secondary mix.
+  for (const std::unique_ptr<ChaseGroup> &group : chase_groups_)
+    group->Advance(timing.TimeInMS());
+
   for (bool is_primary : {false, true}) {
     // Reset all inputs
     for (const std::unique_ptr<SourceValue> &sv : _sourceValues) {
@@ -192,6 +262,8 @@ void Management::MixAll(unsigned timestep_number, ValueSnapshot &primary,
         sv->GetControllable().InputValue(inputIndex) = ControlValue(0);
       }
     }
+    for (FixtureControl *control : fixture_controls_)
+      control->ClearPixelValues();
 
     // Process source values. These will output to controllables.
     if (is_primary) {
@@ -208,11 +280,25 @@ void Management::MixAll(unsigned timestep_number, ValueSnapshot &primary,
     for (Controllable *controllable : std::ranges::reverse_view(orderedList)) {
       controllable->Mix(timing, is_primary);
     }
+    filter_batcher_.Mix();
 
     // All controllables have provided their output; now obtain the DMX values
     // and store them in the ValueSnapshot.
     const unsigned n_universes = universe_map_.NUniverses();
     ValueSnapshot &snapshot = is_primary ? primary : secondary;
+    channel_values_.resize(n_universes);
+    for (unsigned universe = 0; universe != n_universes; ++universe) {
+      if (universe_map_.GetUniverseType(universe) == UniverseType::Output) {
+        WriteUniverse(universe);
+      } else {
+        channel_values_[universe].fill(0);
+      }
+    }
+    // Only the primary values are sent to the devices, so only those are
+    // limited.
+    if (is_primary && power_limiter_.HasLimits()) {
+      power_limiter_.Apply(channel_values_, timePassed);
+    }
     for (unsigned universe = 0; universe != n_universes; ++universe) {
       if (universe_map_.GetUniverseType(universe) == UniverseType::Output) {
         InferInputUniverse(universe, snapshot, is_primary);
@@ -237,6 +323,8 @@ void Management::MixAll(unsigned timestep_number, ValueSnapshot &primary,
               kChannelsPerUniverse);
         }
       }
+
+      power_estimator_.Estimate(snapshot);
     }
   }
 }
@@ -308,6 +396,8 @@ void Management::removeControllable(
   TrackablePtr<Controllable> controllable = std::move(*controllablePtr);
 
   _controllables.erase(controllablePtr);
+  // Indices into _controllables have changed
+  InvalidatePlan();
 
   auto result =
       std::remove_if(_sourceValues.begin(), _sourceValues.end(),
@@ -340,15 +430,23 @@ bool Management::Contains(const Controllable &controllable) const {
 
 const TrackablePtr<Controllable> &Management::AddFixtureControl(
     const Fixture &fixture) {
-  return _controllables.emplace_back(TrackablePtr<Controllable>(
-      new FixtureControl(const_cast<Fixture &>(fixture))));
+  FixtureControl *control = new FixtureControl(const_cast<Fixture &>(fixture));
+  const TrackablePtr<Controllable> &result =
+      _controllables.emplace_back(TrackablePtr<Controllable>(control));
+  // Adding to the back does not change the other indices, so the plan can be
+  // updated incrementally.
+  if (!plan_is_dirty_) {
+    fixture_controls_.emplace_back(control);
+    fixture_control_indices_.emplace(&fixture, _controllables.size() - 1);
+    channel_writer_is_dirty_ = true;
+  }
+  return result;
 }
 
 const TrackablePtr<Controllable> &Management::AddFixtureControl(
     const Fixture &fixture, const Folder &parent) {
   const TrackablePtr<Controllable> &fixture_control =
-      _controllables.emplace_back(TrackablePtr<Controllable>(
-          new FixtureControl(const_cast<Fixture &>(fixture))));
+      AddFixtureControl(fixture);
   const_cast<Folder &>(parent).Add(fixture_control.GetObserver());
   return fixture_control;
 }
@@ -367,6 +465,13 @@ system::ObservingPtr<FixtureControl> Management::AddFixtureControlPtr(
 
 ObservingPtr<FixtureControl> Management::GetFixtureControl(
     const Fixture &fixture) const {
+  if (!plan_is_dirty_) {
+    const auto iter = fixture_control_indices_.find(&fixture);
+    if (iter != fixture_control_indices_.end())
+      return StaticObserverCast<FixtureControl>(
+          _controllables[iter->second].GetObserver());
+    throw std::runtime_error("GetFixtureControl() : Fixture control not found");
+  }
   for (const TrackablePtr<Controllable> &contr : _controllables) {
     FixtureControl *fc = dynamic_cast<FixtureControl *>(contr.Get());
     if (fc) {
@@ -426,9 +531,10 @@ void Management::RemoveFixtureGroup(const FixtureGroup &group) {
 
 SourceValue &Management::AddSourceValue(Controllable &controllable,
                                         size_t inputIndex) {
-  _sourceValues.emplace_back(
+  SourceValue &source_value = *_sourceValues.emplace_back(
       std::make_unique<SourceValue>(controllable, inputIndex));
-  return *_sourceValues.back();
+  source_value.SetFadeProcessor(fade_processor_);
+  return source_value;
 }
 
 void Management::RemoveSourceValue(SourceValue &sourceValue) {
@@ -458,6 +564,43 @@ system::ObservingPtr<Chase> Management::AddChasePtr() {
   return static_cast<system::ObservingPtr<Chase>>(AddChase().GetObserver());
 }
 
+ChaseGroup &Management::AddChaseGroup() {
+  return *chase_groups_.emplace_back(std::make_unique<ChaseGroup>());
+}
+
+void Management::RemoveChaseGroup(const ChaseGroup &group) {
+  for (std::vector<std::unique_ptr<ChaseGroup>>::iterator i =
+           chase_groups_.begin();
+       i != chase_groups_.end(); ++i) {
+    if (i->get() == &group) {
+      chase_groups_.erase(i);
+      return;
+    }
+  }
+  assert(false);
+}
+
+void Management::TapChaseGroup(ChaseGroup &group) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  group.Tap(GetOffsetTimeInMS());
+}
+
+void Management::SetChaseGroupStepDuration(ChaseGroup &group,
+                                           double step_duration) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  group.SetStepDuration(step_duration);
+}
+
+void Management::RestartChaseGroup(ChaseGroup &group) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  group.Restart();
+}
+
+void Management::SetChaseGroup(Chase &chase, ChaseGroup *group) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  chase.SetGroup(group);
+}
+
 const TrackablePtr<Controllable> &Management::AddTimeSequence() {
   return _controllables.emplace_back(
       TrackablePtr<Controllable>(new TimeSequence()));
@@ -554,6 +697,31 @@ ValueSnapshot Management::SecondarySnapshot() const {
   return _secondarySnapshot;
 }
 
+std::vector<PhasePower> Management::PowerPerPhase() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return power_per_phase_;
+}
+
+void Management::SetPowerLimit(size_t phase, std::optional<double> watts) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  power_limiter_.SetLimit(phase, watts);
+}
+
+std::optional<double> Management::PowerLimit(size_t phase) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return power_limiter_.Limit(phase);
+}
+
+void Management::SetOutputDithering(bool enabled) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  output_dithering_ = enabled;
+}
+
+bool Management::OutputDithering() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return output_dithering_;
+}
+
 ValueSnapshot Management::Snapshot(bool primary) {
   if (primary)
     return PrimarySnapshot();
@@ -1,20 +1,32 @@
 #ifndef THEATRE_MANAGEMENT_H_
 #define THEATRE_MANAGEMENT_H_
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <random>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include <sigc++/signal.h>
+
+#include "channelwriter.h"
+#include "fadeprocessor.h"
+#include "outputdither.h"
+#include "powerestimator.h"
+#include "powerlimiter.h"
 #include "forwards.h"
 #include "valuesnapshot.h"
 #include "sourcevaluestore.h"
 
 #include "devices/universemap.h"
 
+#include "filters/filterbatcher.h"
+
 namespace glight::system {
 struct Settings;
 }
@@ -63,6 +75,9 @@ class Management {
   const std::vector<system::TrackablePtr<Controllable>> &Controllables() const {
     return _controllables;
   }
+  const std::vector<std::unique_ptr<ChaseGroup>> &ChaseGroups() const {
+    return chase_groups_;
+  }
   const std::vector<std::unique_ptr<SourceValue>> &SourceValues() const {
     return _sourceValues;
   }
@@ -126,6 +141,30 @@ class Management {
   const system::TrackablePtr<Controllable> &AddChase();
   system::ObservingPtr<Chase> AddChasePtr();
 
+  /**
+   * Adds a time base that can be shared by chases. Its position is
+   * advanced once per frame. See @ref ChaseGroup.
+   */
+  ChaseGroup &AddChaseGroup();
+  /** Removes the group. Its chases continue on their own time base. */
+  void RemoveChaseGroup(const ChaseGroup &group);
+
+  /**
+   * The following functions change a chase group of a running show. They
+   * lock the mutex, because the mix thread advances the groups.
+   * @{
+   */
+  /** Registers a tempo tap for the group at the current time. */
+  void TapChaseGroup(ChaseGroup &group);
+  void SetChaseGroupStepDuration(ChaseGroup &group, double step_duration);
+  void RestartChaseGroup(ChaseGroup &group);
+  /**
+   * Makes the chase follow the group, or its own time base if @p group is
+   * nullptr.
+   */
+  void SetChaseGroup(Chase &chase, ChaseGroup *group);
+  /** @} */
+
   const system::TrackablePtr<Controllable> &AddTimeSequence();
   system::ObservingPtr<TimeSequence> AddTimeSequencePtr();
 
@@ -150,6 +189,23 @@ class Management {
 
   std::mutex &Mutex() { return _mutex; }
 
+  /**
+   * Start a batch of edits. Batches can be nested. While a batch is
+   * open, the list of fixture controls and the DMX channel occupancy are
+   * not rebuilt after every edit, but once when the outermost batch ends.
+   * The caller must hold the mutex. Normally, @ref ManagementBatch should
+   * be used instead of calling these functions directly.
+   */
+  void BeginBatch();
+  void EndBatch();
+  bool InBatch() const { return batch_depth_ != 0; }
+
+  /**
+   * Emitted after a @ref ManagementBatch that holds the lock is committed,
+   * after the lock is released.
+   */
+  sigc::signal<void()> &SignalChange() { return signal_change_; }
+
   const system::Settings &Settings() const { return settings_; }
 
   FolderObject &GetObjectFromPath(const std::string &path) const;
@@ -169,6 +225,27 @@ class Management {
   ValueSnapshot PrimarySnapshot() const;
   ValueSnapshot SecondarySnapshot() const;
 
+  /**
+   * Estimated power usage per electric phase of the primary snapshot. It is
+   * computed by the mix thread and published together with the snapshot.
+   */
+  std::vector<PhasePower> PowerPerPhase() const;
+  /**
+   * Should be called after the power settings of a fixture type or the
+   * phase of a fixture have been changed, so that the power estimate is
+   * recompiled. Re-patching fixtures does not require this call.
+   */
+  void NotifyPowerChange() { power_estimator_is_dirty_ = true; }
+
+  /**
+   * Limits the estimated power usage of an electric phase to the given
+   * number of watts, or removes the limit if @p watts is empty. When a
+   * phase is overloaded, the output of its fixtures is dimmed. See
+   * @ref PowerLimiter.
+   */
+  void SetPowerLimit(size_t phase, std::optional<double> watts);
+  std::optional<double> PowerLimit(size_t phase) const;
+
   double GetOffsetTimeInMS() const {
     const std::chrono::time_point<std::chrono::steady_clock> current_time =
         std::chrono::steady_clock::now();
@@ -192,6 +269,14 @@ class Management {
 
   void BlackOut(bool skip_scenes, double fade_speed);
 
+  /**
+   * Enables temporal dithering of 8-bit output channels, which smooths
+   * slow fades. See @ref OutputDither. The initial state is taken from
+   * @ref system::Settings::output_dithering.
+   */
+  void SetOutputDithering(bool enabled);
+  bool OutputDithering() const;
+
   /**
    * Returns a source value store with all values as currently set in
    * the primary (A) or secondary (B) values. The store will not include
@@ -213,12 +298,17 @@ class Management {
               ValueSnapshot &secondary);
 
   /**
-   * Obtains the channel values from the current situation of the controllables.
-   * If this is the primary snapshot, the values are also send to the DMX
-   * device.
+   * Converts the channel values that were written by @ref WriteUniverse()
+   * to DMX values and stores them in the snapshot.
    */
   void InferInputUniverse(unsigned universe, ValueSnapshot &snapshot,
                           bool is_primary);
+  /**
+   * Writes the 24-bit values of the fixtures in the universe to
+   * channel_values_, before they are limited and converted by
+   * @ref InferInputUniverse().
+   */
+  void WriteUniverse(unsigned universe);
 
   void MergeInputUniverse(ValueSnapshot &snapshot, size_t input_universe);
 
@@ -226,6 +316,15 @@ class Management {
       std::vector<system::TrackablePtr<Controllable>>::iterator
           controllablePtr);
 
+  /**
+   * Rebuilds the list of fixture controls and the map from fixture to
+   * fixture control, or marks it for rebuilding if a batch is open.
+   * The mix thread only reads the plan, and since batches hold the
+   * mutex, it always sees an up-to-date plan.
+   */
+  void InvalidatePlan();
+  void UpdatePlan();
+
   void abortAllDevices();
 
   /**
@@ -254,13 +353,39 @@ class Management {
   ValueSnapshot _primarySnapshot = {true, 0};
   ValueSnapshot _secondarySnapshot = {false, 0};
   std::unique_ptr<BeatFinder> _beatFinder;
+  FadeProcessor fade_processor_;
 
   Folder *_rootFolder;
   std::vector<system::TrackablePtr<Folder>> _folders;
   std::vector<system::TrackablePtr<Controllable>> _controllables;
   std::vector<system::TrackablePtr<FixtureGroup>> _groups;
+  std::vector<std::unique_ptr<ChaseGroup>> chase_groups_;
   std::vector<std::unique_ptr<SourceValue>> _sourceValues;
   devices::UniverseMap universe_map_;
+
+  size_t batch_depth_ = 0;
+  sigc::signal<void()> signal_change_;
+  bool plan_is_dirty_ = false;
+  std::vector<FixtureControl *> fixture_controls_;
+  // Compiled patch of fixture_controls_, used only by the mix thread
+  ChannelWriter channel_writer_;
+  bool channel_writer_is_dirty_ = true;
+  size_t channel_writer_generation_ = 0;
+  // Applies the filters of fixture controls with identical filter chains
+  FilterBatcher filter_batcher_;
+  OutputDither output_dither_;
+  bool output_dithering_;
+  PowerEstimator power_estimator_;
+  std::atomic<bool> power_estimator_is_dirty_ = true;
+  std::vector<PhasePower> power_per_phase_;
+  PowerLimiter power_limiter_;
+  // 24-bit channel values of all universes of the frame being mixed
+  std::vector<std::array<unsigned, kChannelsPerUniverse>> channel_values_;
+  // Maps a fixture to the index of its control in _controllables
+  std::unordered_map<const Fixture *, size_t> fixture_control_indices_;
+  // Buffers for sorting the controllables, kept to avoid reallocation
+  std::vector<Controllable *> unordered_controllables_;
+  std::vector<Controllable *> ordered_controllables_;
 };
 
 }  // namespace glight::theatre
@@ -0,0 +1,64 @@
+#ifndef THEATRE_MANAGEMENT_BATCH_H_
+#define THEATRE_MANAGEMENT_BATCH_H_
+
+#include <mutex>
+
+#include "management.h"
+
+namespace glight::theatre {
+
+/**
+ * Groups many edits to a @ref Management into one transaction. The mutex
+ * is locked once for the whole batch, updates that normally follow every
+ * edit are performed once at the end, and a single change notification is
+ * emitted after the lock has been released. Example:
+ *
+ *   ManagementBatch batch(management);
+ *   Chase& chase = AutoDesign::MakeRunningLight(...);
+ *   batch.Commit();
+ *
+ * If @ref Commit() is not called explicitly, the batch is committed on
+ * destruction.
+ */
+class ManagementBatch {
+ public:
+  explicit ManagementBatch(Management &management)
+      : management_(management), lock_(management.Mutex()) {
+    management_.BeginBatch();
+  }
+
+  /**
+   * Starts a batch without locking the mutex, for callers that already
+   * hold it or that run before the mix thread is started. Because the
+   * caller holds the lock, no change notification is emitted on commit.
+   */
+  ManagementBatch(Management &management, std::defer_lock_t)
+      : management_(management), lock_(management.Mutex(), std::defer_lock) {
+    management_.BeginBatch();
+  }
+
+  ~ManagementBatch() { Commit(); }
+
+  ManagementBatch(const ManagementBatch &) = delete;
+  ManagementBatch &operator=(const ManagementBatch &) = delete;
+
+  void Commit() {
+    if (!is_committed_) {
+      is_committed_ = true;
+      management_.EndBatch();
+      if (lock_.owns_lock()) {
+        lock_.unlock();
+        management_.SignalChange()();
+      }
+    }
+  }
+
+ private:
+  Management &management_;
+  std::unique_lock<std::mutex> lock_;
+  bool is_committed_ = false;
+};
+
+}  // namespace glight::theatre
+
+#endif
@@ -44,7 +44,13 @@ class NamedObject {
   }
 
   const std::string &Name() const { return _name; }
-  void SetName(const std::string &name) { _name = name; }
+  void SetName(const std::string &name) {
+    if (name != _name) {
+      const std::string old_name = std::move(_name);
+      _name = name;
+      OnRename(old_name);
+    }
+  }
 
   template <typename NamedObjectType>
   static NamedObjectType *FindNamedObjectIfExists(
@@ -200,6 +206,13 @@ class NamedObject {
 
   sigc::signal<void()> &SignalDelete() { return _signalDelete; }
 
+ protected:
+  /**
+   * Called after the name of this object has been changed with
+   * @ref SetName().
+   */
+  virtual void OnRename(const std::string &old_name) {}
+
  private:
   [[no_unique_address]] std::string _name;
   sigc::signal<void()> _signalDelete;
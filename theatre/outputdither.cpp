@@ -0,0 +1,61 @@
+#include "outputdither.h"
+
+#include <algorithm>
+
+#include "controlvalue.h"
+#include "fixture.h"
+#include "fixturecontrol.h"
+
+namespace glight::theatre {
+
+void OutputDither::Resize(size_t n_universes) {
+  const size_t old_size = universes_.size();
+  if (n_universes > old_size) {
+    universes_.resize(n_universes);
+    for (size_t i = old_size; i != n_universes; ++i)
+      universes_[i].mask.fill(0xFFFF);
+  }
+}
+
+void OutputDither::Compile(
+    const std::vector<FixtureControl *> &fixture_controls) {
+  for (Universe &universe : universes_) universe.mask.fill(0xFFFF);
+  for (const FixtureControl *control : fixture_controls) {
+    for (const std::unique_ptr<FixtureFunction> &function :
+         control->GetFixture().Functions()) {
+      const std::optional<DmxChannel> &fine_channel =
+          function->FineChannel();
+      if (!fine_channel) continue;
+      for (const DmxChannel &channel :
+           {function->MainChannel(), *fine_channel}) {
+        Resize(channel.Universe() + 1);
+        universes_[channel.Universe()].mask[channel.Channel()] = 0;
+      }
+    }
+  }
+}
+
+void OutputDither::Convert(unsigned universe_index, bool is_primary,
+                           const unsigned *values, unsigned char *output,
+                           size_t n_channels, bool dither) {
+  if (!dither) {
+    for (size_t i = 0; i != n_channels; ++i)
+      output[i] = std::min(values[i] >> 16, 255u);
+    return;
+  }
+  Resize(universe_index + 1);
+  Universe &universe = universes_[universe_index];
+  const unsigned *mask = universe.mask.data();
+  unsigned *errors = universe.errors[is_primary].data();
+  for (size_t i = 0; i != n_channels; ++i) {
+    // Values may be larger than the maximum when several sources are summed
+    const unsigned value =
+        std::min(values[i], ControlValue::MaxUInt()) + errors[i];
+    const unsigned dmx_value = std::min(value >> 16, 255u);
+    // Near the maximum, the remainder can be more than one step
+    errors[i] = std::min(value - (dmx_value << 16), 0xFFFFu) & mask[i];
+    output[i] = dmx_value;
+  }
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,61 @@
+#ifndef THEATRE_OUTPUT_DITHER_H_
+#define THEATRE_OUTPUT_DITHER_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "valueuniversesnapshot.h"
+
+namespace glight::theatre {
+
+class FixtureControl;
+
+/**
+ * Converts the 24-bit channel values of a universe to 8-bit DMX values.
+ * With dithering enabled, the part of a value that falls below one DMX
+ * step is accumulated per channel and carried over to the next frame
+ * (temporal error diffusion), so that over several frames the average
+ * output equals the 24-bit value. This smooths slow fades on 8-bit
+ * channels. Channels of 16-bit functions already have enough resolution
+ * and are never dithered: an error carried into their coarse channel would
+ * make the combined value jump.
+ *
+ * The conversion of a universe is a single loop without branches over
+ * plain arrays, which the compiler can vectorize.
+ */
+class OutputDither {
+ public:
+  /**
+   * Determines which channels may be dithered. Must be called again after
+   * fixtures are re-patched.
+   */
+  void Compile(const std::vector<FixtureControl *> &fixture_controls);
+
+  /**
+   * Converts @p n_channels values to DMX values. Primary and secondary
+   * values are mixed in the same frame and have separate error
+   * accumulators.
+   * @param dither If false, values are truncated and the accumulated
+   * errors are left untouched.
+   */
+  void Convert(unsigned universe, bool is_primary, const unsigned *values,
+               unsigned char *output, size_t n_channels, bool dither);
+
+ private:
+  struct Universe {
+    // Error mask of every channel: 0xFFFF to dither, 0 to truncate
+    std::array<unsigned, kChannelsPerUniverse> mask;
+    // Accumulated error for secondary (0) and primary (1) values
+    std::array<std::array<unsigned, kChannelsPerUniverse>, 2> errors{};
+  };
+
+  /** Adds universes, which dither all channels until compiled. */
+  void Resize(size_t n_universes);
+
+  std::vector<Universe> universes_;
+};
+
+}  // namespace glight::theatre
+
+#endif
@@ -0,0 +1,156 @@
+#include "patchindex.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "valueuniversesnapshot.h"
+
+namespace glight::theatre {
+
+std::vector<PatchIndex::Run> PatchIndex::MakeRuns(
+    const std::vector<DmxChannel> &channels) {
+  std::vector<DmxChannel> sorted(channels);
+  std::sort(sorted.begin(), sorted.end(),
+            [](const DmxChannel &a, const DmxChannel &b) {
+              return a.Universe() < b.Universe() ||
+                     (a.Universe() == b.Universe() &&
+                      a.Channel() < b.Channel());
+            });
+  std::vector<Run> runs;
+  for (const DmxChannel &channel : sorted) {
+    assert(channel.Channel() < kChannelsPerUniverse);
+    if (!runs.empty() && runs.back().universe == channel.Universe() &&
+        runs.back().end >= channel.Channel()) {
+      // Consecutive or duplicate channel
+      runs.back().end = channel.Channel() + 1;
+    } else {
+      runs.push_back(
+          Run{channel.Universe(), channel.Channel(), channel.Channel() + 1});
+    }
+  }
+  return runs;
+}
+
+PatchIndex::Segments::iterator PatchIndex::Split(Segments &segments,
+                                                 unsigned channel) {
+  if (channel >= kChannelsPerUniverse) return segments.end();
+  Segments::iterator segment = std::prev(segments.upper_bound(channel));
+  if (segment->first == channel)
+    return segment;
+  else
+    return segments.emplace_hint(std::next(segment), channel, segment->second);
+}
+
+void PatchIndex::Merge(Segments &segments, Segments::iterator first,
+                       Segments::iterator last) {
+  Segments::iterator segment =
+      first == segments.begin() ? first : std::prev(first);
+  const Segments::iterator stop =
+      last == segments.end() ? last : std::next(last);
+  while (segment != stop) {
+    const Segments::iterator next = std::next(segment);
+    if (next == stop) break;
+    if (next->second == segment->second)
+      segments.erase(next);
+    else
+      segment = next;
+  }
+}
+
+bool PatchIndex::Add(const Fixture &fixture,
+                     const std::vector<DmxChannel> &channels) {
+  bool overlaps = false;
+  for (const Run &run : MakeRuns(channels)) {
+    if (run.universe >= universes_.size()) {
+      const size_t old_size = universes_.size();
+      universes_.resize(run.universe + 1);
+      for (size_t i = old_size; i != universes_.size(); ++i)
+        universes_[i].emplace(0, std::vector<const Fixture *>());
+    }
+    Segments &segments = universes_[run.universe];
+    const Segments::iterator first = Split(segments, run.begin);
+    const Segments::iterator last = Split(segments, run.end);
+    for (Segments::iterator segment = first; segment != last; ++segment) {
+      std::vector<const Fixture *> &fixtures = segment->second;
+      if (!fixtures.empty()) overlaps = true;
+      fixtures.insert(
+          std::lower_bound(fixtures.begin(), fixtures.end(), &fixture),
+          &fixture);
+    }
+    Merge(segments, first, last);
+  }
+  return overlaps;
+}
+
+void PatchIndex::Remove(const Fixture &fixture,
+                        const std::vector<DmxChannel> &channels) {
+  for (const Run &run : MakeRuns(channels)) {
+    assert(run.universe < universes_.size());
+    Segments &segments = universes_[run.universe];
+    const Segments::iterator first = Split(segments, run.begin);
+    const Segments::iterator last = Split(segments, run.end);
+    for (Segments::iterator segment = first; segment != last; ++segment) {
+      std::vector<const Fixture *> &fixtures = segment->second;
+      const auto iter =
+          std::lower_bound(fixtures.begin(), fixtures.end(), &fixture);
+      assert(iter != fixtures.end() && *iter == &fixture);
+      fixtures.erase(iter);
+    }
+    Merge(segments, first, last);
+  }
+}
+
+const std::vector<const Fixture *> &PatchIndex::FixturesAt(
+    DmxChannel channel) const {
+  static const std::vector<const Fixture *> empty;
+  if (channel.Universe() >= universes_.size()) return empty;
+  const Segments &segments = universes_[channel.Universe()];
+  return std::prev(segments.upper_bound(channel.Channel()))->second;
+}
+
+std::vector<const Fixture *> PatchIndex::Overlapping(
+    const Fixture &fixture, const std::vector<DmxChannel> &channels) const {
+  std::vector<const Fixture *> result;
+  for (const Run &run : MakeRuns(channels)) {
+    if (run.universe >= universes_.size()) continue;
+    const Segments &segments = universes_[run.universe];
+    for (Segments::const_iterator segment =
+             std::prev(segments.upper_bound(run.begin));
+         segment != segments.end() && segment->first < run.end; ++segment) {
+      for (const Fixture *other : segment->second) {
+        if (other != &fixture) result.emplace_back(other);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+std::vector<PatchConflict> PatchIndex::Conflicts() const {
+  std::vector<PatchConflict> conflicts;
+  for (size_t universe = 0; universe != universes_.size(); ++universe) {
+    const Segments &segments = universes_[universe];
+    for (Segments::const_iterator segment = segments.begin();
+         segment != segments.end(); ++segment) {
+      if (segment->second.size() > 1) {
+        const Segments::const_iterator next = std::next(segment);
+        const unsigned end =
+            next == segments.end() ? kChannelsPerUniverse : next->first;
+        conflicts.emplace_back(PatchConflict{unsigned(universe),
+                                             segment->first,
+                                             end - segment->first,
+                                             segment->second});
+      }
+    }
+  }
+  return conflicts;
+}
+
+size_t PatchIndex::SegmentCount() const {
+  size_t count = 0;
+  for (const Segments &segments : universes_) count += segments.size();
+  return count;
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,98 @@
+#ifndef THEATRE_PATCH_INDEX_H_
+#define THEATRE_PATCH_INDEX_H_
+
+#include <map>
+#include <vector>
+
+#include "dmxchannel.h"
+
+namespace glight::theatre {
+
+class Fixture;
+
+/**
+ * A range of channels in one universe that is used by more than one
+ * fixture.
+ */
+struct PatchConflict {
+  unsigned universe;
+  unsigned first_channel;
+  unsigned n_channels;
+  std::vector<const Fixture *> fixtures;
+};
+
+/**
+ * Index from DMX channels to the fixtures that use them. Every universe is
+ * stored as an interval map: an ordered map of consecutive segments, where
+ * each segment holds the fixtures that use all channels of the segment.
+ * Because fixtures use runs of consecutive channels, the number of
+ * segments stays proportional to the number of fixtures, and looking up a
+ * channel or (un)registering a fixture takes O(log N) for N segments.
+ */
+class PatchIndex {
+ public:
+  void Clear() { universes_.clear(); }
+
+  /**
+   * Registers that the fixture uses the given channels.
+   * @returns true if any of the channels was already in use by another
+   * fixture.
+   */
+  bool Add(const Fixture &fixture, const std::vector<DmxChannel> &channels);
+
+  /**
+   * Unregisters the channels that were previously added with
+   * @ref Add().
+   */
+  void Remove(const Fixture &fixture, const std::vector<DmxChannel> &channels);
+
+  /**
+   * The fixtures that use the given channel. The returned reference is
+   * invalidated by the next change to the index.
+   */
+  const std::vector<const Fixture *> &FixturesAt(DmxChannel channel) const;
+
+  /**
+   * The fixtures, other than @p fixture itself, that use at least one of
+   * the given channels, without duplicates.
+   */
+  std::vector<const Fixture *> Overlapping(
+      const Fixture &fixture, const std::vector<DmxChannel> &channels) const;
+
+  /**
+   * All ranges of channels that are used by more than one fixture, ordered
+   * by universe and channel. Adjacent ranges with the same fixtures are
+   * reported as one conflict.
+   */
+  std::vector<PatchConflict> Conflicts() const;
+
+  /**
+   * Total number of segments, for testing that the index stays compact.
+   */
+  size_t SegmentCount() const;
+
+ private:
+  // Maps the first channel of a segment to the fixtures that use it. A
+  // segment ends where the next one starts, or at the end of the universe.
+  using Segments = std::map<unsigned, std::vector<const Fixture *>>;
+
+  struct Run {
+    unsigned universe;
+    unsigned begin;
+    unsigned end;
+  };
+
+  /**
+   * Sorts the channels and combines consecutive channels into runs.
+   */
+  static std::vector<Run> MakeRuns(const std::vector<DmxChannel> &channels);
+  static Segments::iterator Split(Segments &segments, unsigned channel);
+  static void Merge(Segments &segments, Segments::iterator first,
+                    Segments::iterator last);
+
+  std::vector<Segments> universes_;
+};
+
+}  // namespace glight::theatre
+
+#endif
@@ -0,0 +1,207 @@
+#include "powerestimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "controlvalue.h"
+#include "fixture.h"
+#include "fixturemode.h"
+#include "fixturetype.h"
+#include "valuesnapshot.h"
+
+namespace glight::theatre {
+
+namespace {
+// Converts a 16-bit combination of main and fine channel to a ratio, such
+// that it equals ControlValue(function.GetControlValue(snapshot)).Ratio().
+constexpr double kRatioScale = 256.0 / double(ControlValue::MaxUInt());
+}  // namespace
+
+void PowerEstimator::Compile(
+    const std::vector<system::TrackablePtr<Fixture>> &fixtures) {
+  terms_.clear();
+  fixtures_.clear();
+  phases_.clear();
+  phase_sums_.clear();
+  changed_fixtures_.clear();
+  std::map<size_t, size_t> phase_indices;
+  for (const system::TrackablePtr<Fixture> &fixture : fixtures) {
+    phase_indices.emplace(fixture->ElectricPhase(), 0);
+  }
+  for (auto &[phase, index] : phase_indices) {
+    index = phases_.size();
+    phases_.emplace_back(PhasePower{phase, 0.0, 0.0});
+  }
+  phase_sums_.assign(phases_.size(), 0);
+
+  const auto index = [](const DmxChannel &channel) {
+    return size_t(channel.Universe()) * kChannelsPerUniverse +
+           channel.Channel();
+  };
+  // Pairs of (channel index, fixture index) for the channel index
+  std::vector<std::pair<size_t, size_t>> dependencies;
+  for (const system::TrackablePtr<Fixture> &fixture : fixtures) {
+    const FixtureMode &mode = fixture->Mode();
+    const FixtureType &type = mode.Type();
+    const std::vector<FixtureModeFunction> &mode_functions = mode.Functions();
+    const size_t fixture_index = fixtures_.size();
+    FixtureEntry &entry = fixtures_.emplace_back();
+    entry.phase_index = phase_indices.find(fixture->ElectricPhase())->second;
+    entry.idle_power = type.IdlePower();
+    entry.max_power = type.MaxPower();
+    entry.is_changed = false;
+    phases_[entry.phase_index].max_power += entry.max_power;
+
+    const auto add_terms = [&](bool master) {
+      for (size_t i = 0; i != mode_functions.size(); ++i) {
+        const FunctionType function_type = mode_functions[i].Type();
+        if (master ? function_type == FunctionType::Master
+                   : IsColor(function_type)) {
+          const FixtureFunction &function = *fixture->Functions()[i];
+          const std::optional<DmxChannel> &fine = function.FineChannel();
+          const size_t main_index = index(function.MainChannel());
+          const size_t fine_index = fine ? index(*fine) : main_index;
+          terms_.emplace_back(Term{main_index, fine_index, fine ? 1u : 0u,
+                                   mode_functions[i].Power() * kRatioScale});
+          dependencies.emplace_back(main_index, fixture_index);
+          dependencies.emplace_back(fine_index, fixture_index);
+        } else if (!master && function_type == FunctionType::PixelBlock) {
+          // The power of a pixel block is spread evenly over its channels
+          const FixtureFunction &function = *fixture->Functions()[i];
+          std::vector<DmxChannel> channels;
+          function.GetChannels(channels);
+          const double weight =
+              mode_functions[i].Power() * kRatioScale / channels.size();
+          for (const DmxChannel &channel : channels) {
+            const size_t channel_index = index(channel);
+            terms_.emplace_back(
+                Term{channel_index, channel_index, 0u, weight});
+            dependencies.emplace_back(channel_index, fixture_index);
+          }
+        }
+      }
+    };
+    entry.term_begin = terms_.size();
+    add_terms(true);
+    entry.master_end = terms_.size();
+    add_terms(false);
+    entry.term_end = terms_.size();
+  }
+
+  std::sort(dependencies.begin(), dependencies.end());
+  dependencies.erase(std::unique(dependencies.begin(), dependencies.end()),
+                     dependencies.end());
+  n_universes_ = dependencies.empty()
+                     ? 0
+                     : dependencies.back().first / kChannelsPerUniverse + 1;
+  // All channels are zero until the first estimate
+  values_.assign(n_universes_ * kChannelsPerUniverse, 0);
+  channel_offsets_.assign(values_.size() + 1, 0);
+  channel_fixtures_.clear();
+  for (const auto &[channel_index, fixture_index] : dependencies) {
+    ++channel_offsets_[channel_index + 1];
+    channel_fixtures_.emplace_back(fixture_index);
+  }
+  for (size_t i = 1; i < channel_offsets_.size(); ++i)
+    channel_offsets_[i] += channel_offsets_[i - 1];
+
+  for (FixtureEntry &entry : fixtures_) {
+    entry.power = FixturePower(entry);
+    phase_sums_[entry.phase_index] += entry.power;
+  }
+  for (size_t i = 0; i != phases_.size(); ++i)
+    phases_[i].power = phase_sums_[i] * 1e-3;
+}
+
+int PowerEstimator::PhaseIndex(size_t phase) const {
+  const auto iter = std::lower_bound(
+      phases_.begin(), phases_.end(), phase,
+      [](const PhasePower &a, size_t b) { return a.phase < b; });
+  if (iter != phases_.end() && iter->phase == phase)
+    return iter - phases_.begin();
+  else
+    return -1;
+}
+
+int64_t PowerEstimator::FixturePower(const FixtureEntry &entry) const {
+  double power = entry.idle_power;
+  double master = 1.0;
+  for (size_t i = entry.term_begin; i != entry.master_end; ++i) {
+    const unsigned value = TermValue(terms_[i]);
+    master = value * kRatioScale;
+    power += value * terms_[i].weight;
+  }
+  double color_power = 0.0;
+  for (size_t i = entry.master_end; i != entry.term_end; ++i) {
+    color_power += TermValue(terms_[i]) * terms_[i].weight;
+  }
+  power += color_power * master;
+  return std::llround(std::min(power, entry.max_power) * 1e3);
+}
+
+template <typename ValueFunction>
+void PowerEstimator::UpdateUniverse(size_t universe, ValueFunction value) {
+  const size_t offset = universe * kChannelsPerUniverse;
+  unsigned char *values = values_.data() + offset;
+  const size_t *channel_offsets = channel_offsets_.data() + offset;
+  for (size_t channel = 0; channel != kChannelsPerUniverse; ++channel) {
+    const unsigned char v = value(channel);
+    if (v != values[channel]) {
+      values[channel] = v;
+      for (size_t i = channel_offsets[channel];
+           i != channel_offsets[channel + 1]; ++i) {
+        const size_t fixture_index = channel_fixtures_[i];
+        FixtureEntry &entry = fixtures_[fixture_index];
+        if (!entry.is_changed) {
+          entry.is_changed = true;
+          changed_fixtures_.emplace_back(fixture_index);
+        }
+      }
+    }
+  }
+}
+
+void PowerEstimator::UpdateFixtures() {
+  for (size_t fixture_index : changed_fixtures_) {
+    FixtureEntry &entry = fixtures_[fixture_index];
+    const int64_t power = FixturePower(entry);
+    phase_sums_[entry.phase_index] += power - entry.power;
+    entry.power = power;
+    entry.is_changed = false;
+  }
+  changed_fixtures_.clear();
+  for (size_t i = 0; i != phases_.size(); ++i)
+    phases_[i].power = phase_sums_[i] * 1e-3;
+}
+
+void PowerEstimator::Estimate(const ValueSnapshot &snapshot) {
+  for (size_t universe = 0; universe != n_universes_; ++universe) {
+    if (universe < snapshot.UniverseCount()) {
+      const unsigned char *data =
+          snapshot.GetUniverseSnapshot(universe).Data();
+      UpdateUniverse(universe,
+                     [data](size_t channel) { return data[channel]; });
+    } else {
+      UpdateUniverse(universe, [](size_t) { return 0; });
+    }
+  }
+  UpdateFixtures();
+}
+
+void PowerEstimator::Estimate(
+    const std::vector<std::array<unsigned, kChannelsPerUniverse>> &universes) {
+  for (size_t universe = 0; universe != n_universes_; ++universe) {
+    if (universe < universes.size()) {
+      const unsigned *data = universes[universe].data();
+      UpdateUniverse(universe, [data](size_t channel) {
+        return std::min(data[channel], ControlValue::MaxUInt()) >> 16;
+      });
+    } else {
+      UpdateUniverse(universe, [](size_t) { return 0; });
+    }
+  }
+  UpdateFixtures();
+}
+
+}  // namespace glight::theatre
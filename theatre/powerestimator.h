@@ -0,0 +1,136 @@
+#ifndef THEATRE_POWER_ESTIMATOR_H_
+#define THEATRE_POWER_ESTIMATOR_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "dmxchannel.h"
+#include "valueuniversesnapshot.h"
+
+#include "system/trackableptr.h"
+
+namespace glight::theatre {
+
+class Fixture;
+class ValueSnapshot;
+
+/**
+ * Estimated power usage of the fixtures on one electric phase, in watts.
+ */
+struct PhasePower {
+  size_t phase;
+  double power;
+  double max_power;
+};
+
+inline bool operator==(const PhasePower &lhs, const PhasePower &rhs) {
+  return lhs.phase == rhs.phase && lhs.power == rhs.power &&
+         lhs.max_power == rhs.max_power;
+}
+
+/**
+ * Estimates the power usage per electric phase from the DMX values of a
+ * snapshot, using the same model as @ref FixtureMode::GetPower(). The power
+ * settings of all fixtures are compiled into a flat table of weighted
+ * channels, so that an estimate is a single pass over that table without
+ * looking up fixture types, modes or functions.
+ *
+ * The estimate is incremental. The estimator keeps the DMX values of the
+ * previous estimate, and an index from every channel to the fixtures whose
+ * power depends on it. Each estimate compares the new values with the
+ * previous ones per universe, and only recalculates the power of the
+ * fixtures of channels that changed. The difference is added to the sum of
+ * the phase of the fixture. The cost of an estimate is therefore one
+ * comparison per channel plus the work for the fixtures that changed, and
+ * does not grow with the number of power terms. Sums are kept in integer
+ * milliwatts, so that they do not drift.
+ */
+class PowerEstimator {
+ public:
+  /**
+   * Rebuilds the weight table. Must be called again after fixtures are
+   * re-patched, or after their power settings or phases are changed.
+   */
+  void Compile(const std::vector<system::TrackablePtr<Fixture>> &fixtures);
+
+  void Estimate(const ValueSnapshot &snapshot);
+
+  /**
+   * Estimates the power from 24-bit channel values as written by the
+   * @ref ChannelWriter, indexed by universe. Fine channels are combined
+   * with their main channel as they would be after conversion to DMX
+   * values.
+   */
+  void Estimate(
+      const std::vector<std::array<unsigned, kChannelsPerUniverse>> &universes);
+
+  /**
+   * Result of the last estimate, with one entry per phase that has fixtures,
+   * ordered by phase.
+   */
+  const std::vector<PhasePower> &Phases() const { return phases_; }
+
+  /**
+   * Index of a phase in @ref Phases(), or -1 if no fixture uses the phase.
+   */
+  int PhaseIndex(size_t phase) const;
+
+ private:
+  struct Term {
+    // Indices into values_ of the main and fine channel
+    size_t main_index;
+    size_t fine_index;
+    // 1 if the function has a fine channel, 0 otherwise
+    unsigned fine_factor;
+    // Power of the function, divided by the maximum 16-bit channel value
+    double weight;
+  };
+
+  struct FixtureEntry {
+    size_t phase_index;
+    double idle_power;
+    double max_power;
+    // The master terms of the fixture are [term_begin, master_end), the
+    // colour terms [master_end, term_end).
+    size_t term_begin;
+    size_t master_end;
+    size_t term_end;
+    // Power of the previous estimate, in milliwatts
+    int64_t power;
+    bool is_changed;
+  };
+
+  /**
+   * Compares the values of one universe with the previous estimate, stores
+   * them, and marks the fixtures of changed channels.
+   */
+  template <typename ValueFunction>
+  void UpdateUniverse(size_t universe, ValueFunction value);
+  void UpdateFixtures();
+  unsigned TermValue(const Term &term) const {
+    return unsigned(values_[term.main_index]) * 256 +
+           unsigned(values_[term.fine_index]) * term.fine_factor;
+  }
+  int64_t FixturePower(const FixtureEntry &entry) const;
+
+  std::vector<Term> terms_;
+  std::vector<FixtureEntry> fixtures_;
+  size_t n_universes_ = 0;
+  // DMX values of the previous estimate, kChannelsPerUniverse per universe
+  std::vector<unsigned char> values_;
+  // The fixtures that depend on channel i of values_ are
+  // channel_fixtures_[channel_offsets_[i]] up to
+  // channel_fixtures_[channel_offsets_[i + 1]].
+  std::vector<size_t> channel_offsets_;
+  std::vector<size_t> channel_fixtures_;
+  std::vector<size_t> changed_fixtures_;
+  std::vector<PhasePower> phases_;
+  // Power per phase in milliwatts
+  std::vector<int64_t> phase_sums_;
+};
+
+}  // namespace glight::theatre
+
+#endif
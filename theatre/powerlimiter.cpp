@@ -0,0 +1,141 @@
+#include "powerlimiter.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "controlvalue.h"
+#include "fixture.h"
+#include "fixturemode.h"
+#include "fixturetype.h"
+
+namespace glight::theatre {
+
+void PowerLimiter::Compile(
+    const std::vector<system::TrackablePtr<Fixture>> &fixtures) {
+  // Keep the current scale factors, so that recompiling does not release
+  // the limiter for a frame
+  std::map<size_t, double> old_scales;
+  for (size_t i = 0; i != scales_.size(); ++i)
+    old_scales.emplace(estimator_.Phases()[i].phase, scales_[i]);
+
+  estimator_.Compile(fixtures);
+  const std::vector<PhasePower> &phases = estimator_.Phases();
+  idle_power_.assign(phases.size(), 0.0);
+  scales_.assign(phases.size(), 1.0);
+  for (size_t i = 0; i != phases.size(); ++i) {
+    const auto iter = old_scales.find(phases[i].phase);
+    if (iter != old_scales.end()) scales_[i] = iter->second;
+  }
+
+  std::vector<std::vector<Dimmer>> phase_dimmers(phases.size());
+  for (const system::TrackablePtr<Fixture> &fixture : fixtures) {
+    const size_t phase_index = estimator_.PhaseIndex(fixture->ElectricPhase());
+    const FixtureMode &mode = fixture->Mode();
+    idle_power_[phase_index] += mode.Type().IdlePower();
+    const std::vector<FixtureModeFunction> &functions = mode.Functions();
+    const bool has_master = std::any_of(
+        functions.begin(), functions.end(), [](const FixtureModeFunction &f) {
+          return f.Type() == FunctionType::Master;
+        });
+    for (size_t i = 0; i != functions.size(); ++i) {
+      const FunctionType type = functions[i].Type();
+      if (has_master ? type == FunctionType::Master : IsColor(type)) {
+        const FixtureFunction &function = *fixture->Functions()[i];
+        phase_dimmers[phase_index].emplace_back(
+            Dimmer{function.MainChannel(), function.FineChannel()});
+      } else if (!has_master && type == FunctionType::PixelBlock) {
+        std::vector<DmxChannel> channels;
+        fixture->Functions()[i]->GetChannels(channels);
+        for (const DmxChannel &channel : channels)
+          phase_dimmers[phase_index].emplace_back(Dimmer{channel, {}});
+      }
+    }
+  }
+  dimmers_.clear();
+  dimmer_offsets_.clear();
+  for (const std::vector<Dimmer> &dimmers : phase_dimmers) {
+    dimmer_offsets_.emplace_back(dimmers_.size());
+    dimmers_.insert(dimmers_.end(), dimmers.begin(), dimmers.end());
+  }
+  dimmer_offsets_.emplace_back(dimmers_.size());
+  UpdatePhaseLimits();
+}
+
+void PowerLimiter::SetLimit(size_t phase, std::optional<double> watts) {
+  if (watts)
+    limits_[phase] = *watts;
+  else
+    limits_.erase(phase);
+  UpdatePhaseLimits();
+}
+
+std::optional<double> PowerLimiter::Limit(size_t phase) const {
+  const auto iter = limits_.find(phase);
+  if (iter == limits_.end())
+    return {};
+  else
+    return iter->second;
+}
+
+void PowerLimiter::UpdatePhaseLimits() {
+  const std::vector<PhasePower> &phases = estimator_.Phases();
+  phase_limits_.resize(phases.size());
+  for (size_t i = 0; i != phases.size(); ++i)
+    phase_limits_[i] = Limit(phases[i].phase);
+}
+
+double PowerLimiter::Scale(size_t phase) const {
+  const int index = estimator_.PhaseIndex(phase);
+  return index < 0 ? 1.0 : scales_[index];
+}
+
+void PowerLimiter::Apply(
+    std::vector<std::array<unsigned, kChannelsPerUniverse>> &universes,
+    double time_passed) {
+  estimator_.Estimate(universes);
+  const std::vector<PhasePower> &load = estimator_.Phases();
+  for (size_t i = 0; i != load.size(); ++i) {
+    double target = 1.0;
+    if (phase_limits_[i] && load[i].power > *phase_limits_[i]) {
+      // Only the power above the idle power can be reduced
+      const double variable_power = load[i].power - idle_power_[i];
+      const double budget = *phase_limits_[i] - idle_power_[i];
+      if (variable_power > 0.0)
+        target = std::clamp(budget / variable_power, 0.0, 1.0);
+    }
+    if (target < scales_[i])
+      scales_[i] = target;
+    else
+      scales_[i] = std::min(target, scales_[i] + kReleaseRate * time_passed);
+
+    if (scales_[i] < 1.0) {
+      const unsigned scale = static_cast<unsigned>(scales_[i] * 65536.0);
+      for (size_t d = dimmer_offsets_[i]; d != dimmer_offsets_[i + 1]; ++d) {
+        ScaleDimmer(dimmers_[d], universes, scale);
+      }
+    }
+  }
+}
+
+void PowerLimiter::ScaleDimmer(
+    const Dimmer &dimmer,
+    std::vector<std::array<unsigned, kChannelsPerUniverse>> &universes,
+    unsigned scale) {
+  if (dimmer.main_channel.Universe() >= universes.size()) return;
+  unsigned &main =
+      universes[dimmer.main_channel.Universe()][dimmer.main_channel.Channel()];
+  if (dimmer.fine_channel &&
+      dimmer.fine_channel->Universe() < universes.size()) {
+    // Recombine the value as split by the ChannelWriter
+    unsigned &fine = universes[dimmer.fine_channel->Universe()]
+                              [dimmer.fine_channel->Channel()];
+    const uint64_t value = (main & ~0xFFFFu) + ((fine >> 8) & 0xFFFF);
+    const unsigned scaled = (value * scale) >> 16;
+    main = scaled & ~0xFFFFu;
+    fine = (scaled & 0xFFFF) << 8;
+  } else {
+    main = (uint64_t(std::min(main, ControlValue::MaxUInt())) * scale) >> 16;
+  }
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,99 @@
+#ifndef THEATRE_POWER_LIMITER_H_
+#define THEATRE_POWER_LIMITER_H_
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "dmxchannel.h"
+#include "powerestimator.h"
+#include "valueuniversesnapshot.h"
+
+#include "system/trackableptr.h"
+
+namespace glight::theatre {
+
+class Fixture;
+
+/**
+ * Keeps the estimated power usage of electric phases within a configured
+ * budget. The limiter runs in the output stage on the 24-bit channel
+ * values of all universes. When the estimated load of a phase exceeds its
+ * budget, the dimmer channels of the fixtures on that phase are scaled
+ * down. The dimmer channels of a fixture are its master channels, or its
+ * colour channels if it has no master.
+ *
+ * The scale factor of a phase drops immediately when the phase is
+ * overloaded, and returns to one gradually, at @ref kReleaseRate per
+ * second, once the load decreases. The load is estimated with an
+ * incremental @ref PowerEstimator, which only recalculates the fixtures of
+ * channels that changed since the previous frame.
+ */
+class PowerLimiter {
+ public:
+  /** Speed at which the scale factor recovers, in units per second. */
+  static constexpr double kReleaseRate = 0.5;
+
+  /**
+   * Rebuilds the tables. Must be called again after fixtures are
+   * re-patched, or after their power settings or phases are changed.
+   */
+  void Compile(const std::vector<system::TrackablePtr<Fixture>> &fixtures);
+
+  /**
+   * Sets the maximum power of a phase in watts, or removes the limit when
+   * @p watts is empty. Limits may be set for phases without fixtures.
+   */
+  void SetLimit(size_t phase, std::optional<double> watts);
+  std::optional<double> Limit(size_t phase) const;
+
+  bool HasLimits() const { return !limits_.empty(); }
+
+  /**
+   * Estimates the load of every phase from the (unlimited) channel values
+   * and scales the dimmer channels of overloaded phases in place.
+   * @param time_passed Time since the previous call, in seconds.
+   */
+  void Apply(std::vector<std::array<unsigned, kChannelsPerUniverse>> &universes,
+             double time_passed);
+
+  /**
+   * Current scale factor of a phase, between 0 and 1. It is 1 for phases
+   * that are not limited.
+   */
+  double Scale(size_t phase) const;
+
+  /**
+   * Estimated load per phase before limiting, as of the last call to
+   * @ref Apply().
+   */
+  const std::vector<PhasePower> &Load() const { return estimator_.Phases(); }
+
+ private:
+  struct Dimmer {
+    DmxChannel main_channel;
+    std::optional<DmxChannel> fine_channel;
+  };
+
+  void UpdatePhaseLimits();
+  static void ScaleDimmer(
+      const Dimmer &dimmer,
+      std::vector<std::array<unsigned, kChannelsPerUniverse>> &universes,
+      unsigned scale);
+
+  PowerEstimator estimator_;
+  std::map<size_t, double> limits_;
+  // All following vectors are indexed by the phase index of the estimator
+  std::vector<std::optional<double>> phase_limits_;
+  std::vector<double> idle_power_;
+  std::vector<double> scales_;
+  // The dimmers of phase i are [dimmer_offsets_[i], dimmer_offsets_[i+1])
+  std::vector<size_t> dimmer_offsets_;
+  std::vector<Dimmer> dimmers_;
+};
+
+}  // namespace glight::theatre
+
+#endif
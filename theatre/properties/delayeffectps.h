@@ -5,12 +5,15 @@
 
 #include "../effects/delayeffect.h"
 
+#include <algorithm>
+
 namespace glight::theatre {
 
 class DelayEffectPS final : public PropertySet {
  public:
   DelayEffectPS() {
     addProperty(Property("delay", "Delay", PropertyType::Duration));
+    addProperty(Property("taps", "Number of taps", PropertyType::Integer));
   }
 
  protected:
@@ -33,6 +36,26 @@ class DelayEffectPS final : public PropertySet {
     }
     return 0;
   }
+
+  virtual void setInteger(FolderObject &object, size_t index,
+                          int value) const final override {
+    DelayEffect &dfx = static_cast<DelayEffect &>(object);
+    switch (index) {
+      case 1:
+        dfx.SetTaps(std::max(value, 1));
+        break;
+    }
+  }
+
+  virtual int getInteger(const FolderObject &object,
+                         size_t index) const final override {
+    const DelayEffect &dfx = static_cast<const DelayEffect &>(object);
+    switch (index) {
+      case 1:
+        return dfx.GetTaps();
+    }
+    return 0;
+  }
 };
 
 }  // namespace glight::theatre
@@ -25,6 +25,12 @@ class FunctionGeneratorEffectPS final : public PropertySet {
     addProperty(Property("offset", "Offset", PropertyType::ControlValue));
     addProperty(Property("invert", "Invert", PropertyType::Boolean));
     addProperty(Property("period", "Period", PropertyType::Duration));
+    addProperty(Property("spread", "Spread",
+                         std::vector<std::pair<std::string, std::string>>{
+                             {"none", "None"},
+                             {"linear", "Linear"},
+                             {"center_out", "Center out"},
+                             {"random", "Random"}}));
   }
 
  protected:
@@ -94,6 +100,17 @@ class FunctionGeneratorEffectPS final : public PropertySet {
         else if (value == "strobe")
           fgx.SetFunction(F::Strobe);
         break;
+      case 5: {
+        using S = FunctionGeneratorEffect::Spread;
+        if (value == "none")
+          fgx.SetSpread(S::None);
+        else if (value == "linear")
+          fgx.SetSpread(S::Linear);
+        else if (value == "center_out")
+          fgx.SetSpread(S::CenterOut);
+        else if (value == "random")
+          fgx.SetSpread(S::Random);
+      } break;
     }
   }
 
@@ -121,6 +138,19 @@ class FunctionGeneratorEffectPS final : public PropertySet {
             return "strobe";
         }
         break;
+      case 5: {
+        using S = FunctionGeneratorEffect::Spread;
+        switch (fgx.GetSpread()) {
+          case S::None:
+            return "none";
+          case S::Linear:
+            return "linear";
+          case S::CenterOut:
+            return "center_out";
+          case S::Random:
+            return "random";
+        }
+      } break;
     }
     return nullptr;
   }
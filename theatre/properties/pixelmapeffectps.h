@@ -0,0 +1,83 @@
+#ifndef PIXEL_MAP_EFFECT_PS_H_
+#define PIXEL_MAP_EFFECT_PS_H_
+
+#include "propertyset.h"
+
+#include "theatre/effects/pixelmapeffect.h"
+
+#include <string>
+
+namespace glight::theatre {
+
+class PixelMapEffectPS final : public PropertySet {
+ public:
+  PixelMapEffectPS() {
+    addProperty(Property("pattern", "Pattern",
+                         std::vector<std::pair<std::string, std::string>>{
+                             {"horizontal_rainbow", "Horizontal rainbow"},
+                             {"vertical_rainbow", "Vertical rainbow"},
+                             {"radial_rainbow", "Radial rainbow"},
+                             {"plasma", "Plasma"},
+                             {"noise", "Noise"}}));
+    addProperty(Property("period", "Period", PropertyType::Duration));
+    addProperty(Property("size", "Size (%)", PropertyType::Integer));
+  }
+
+ protected:
+  void setChoice(FolderObject &object, size_t index,
+                 const std::string &value) const override {
+    PixelMapEffect &pfx = static_cast<PixelMapEffect &>(object);
+    using P = PixelMapEffect::Pattern;
+    if (value == "horizontal_rainbow")
+      pfx.SetPattern(P::HorizontalRainbow);
+    else if (value == "vertical_rainbow")
+      pfx.SetPattern(P::VerticalRainbow);
+    else if (value == "radial_rainbow")
+      pfx.SetPattern(P::RadialRainbow);
+    else if (value == "plasma")
+      pfx.SetPattern(P::Plasma);
+    else if (value == "noise")
+      pfx.SetPattern(P::Noise);
+  }
+
+  std::string getChoice(const FolderObject &object,
+                        size_t index) const override {
+    const PixelMapEffect &pfx = static_cast<const PixelMapEffect &>(object);
+    using P = PixelMapEffect::Pattern;
+    switch (pfx.GetPattern()) {
+      case P::HorizontalRainbow:
+        return "horizontal_rainbow";
+      case P::VerticalRainbow:
+        return "vertical_rainbow";
+      case P::RadialRainbow:
+        return "radial_rainbow";
+      case P::Plasma:
+        return "plasma";
+      case P::Noise:
+        return "noise";
+    }
+    return std::string();
+  }
+
+  void setDuration(FolderObject &object, size_t index,
+                   double value) const override {
+    static_cast<PixelMapEffect &>(object).SetPeriod(value);
+  }
+
+  double getDuration(const FolderObject &object, size_t index) const override {
+    return static_cast<const PixelMapEffect &>(object).GetPeriod();
+  }
+
+  void setInteger(FolderObject &object, size_t index,
+                  int value) const override {
+    static_cast<PixelMapEffect &>(object).SetSize(value);
+  }
+
+  int getInteger(const FolderObject &object, size_t index) const override {
+    return static_cast<const PixelMapEffect &>(object).GetSize();
+  }
+};
+
+}  // namespace glight::theatre
+
+#endif
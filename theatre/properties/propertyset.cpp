@@ -15,6 +15,7 @@
 #include "hue_saturation_lightness_ps.h"
 #include "inverteffectps.h"
 #include "musicactivationeffectps.h"
+#include "pixelmapeffectps.h"
 #include "pulseeffectps.h"
 #include "randomselecteffectps.h"
 #include "thresholdeffectps.h"
@@ -54,6 +55,7 @@ std::unique_ptr<PropertySet> PropertySet::Make(FolderObject &object) {
     FXCASE(HueSaturationLightness);
     FXCASE(Invert);
     FXCASE(MusicActivation);
+    FXCASE(PixelMap);
     FXCASE(Pulse);
     FXCASE(RandomSelect);
     EMPTYPSCASE(RgbMaster);
@@ -69,6 +71,11 @@ std::unique_ptr<PropertySet> PropertySet::Make(FolderObject &object) {
   return ps;
 }
 
+void PropertySet::notifyChange() const {
+  if (Controllable *controllable = dynamic_cast<Controllable *>(_object))
+    controllable->NotifyPropertyChange();
+}
+
 void PropertySet::AssignProperty(const Property &to, const Property &from,
                                  const PropertySet &fromSet) {
   assert(from.type_ == to.type_);
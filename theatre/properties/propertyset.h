@@ -48,6 +48,7 @@ class PropertySet {
   void SetControlValue(const Property &property, unsigned value) const {
     if (value > ControlValue::MaxUInt()) value = ControlValue::MaxUInt();
     setControlValue(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   unsigned GetControlValue(const Property &property) const {
@@ -56,6 +57,7 @@ class PropertySet {
 
   void SetDuration(const Property &property, double value) const {
     setDuration(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   double GetDuration(const Property &property) const {
@@ -64,6 +66,7 @@ class PropertySet {
 
   void SetBool(const Property &property, double value) {
     setBool(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   bool GetBool(const Property &property) const {
@@ -72,6 +75,7 @@ class PropertySet {
 
   void SetChoice(const Property &property, const std::string &value) {
     setChoice(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   std::string GetChoice(const Property &property) const {
@@ -80,6 +84,7 @@ class PropertySet {
 
   void SetInteger(const Property &property, int value) {
     setInteger(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   int GetInteger(const Property &property) const {
@@ -88,6 +93,7 @@ class PropertySet {
 
   void SetTransition(const Property &property, const Transition &value) {
     setTransition(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   Transition GetTransition(const Property &property) const {
@@ -97,6 +103,7 @@ class PropertySet {
   void SetTimePattern(const Property &property,
                       const system::TimePattern &value) {
     setTimePattern(*_object, property.set_index_, value);
+    notifyChange();
   }
 
   const system::TimePattern &GetTimePattern(const Property &property) const {
@@ -207,6 +214,12 @@ class PropertySet {
   }
 
  private:
+  /**
+   * Marks the object as changed after one of its properties was set, so
+   * that the engine can find out which caches need to be rebuilt.
+   */
+  void notifyChange() const;
+
   void setterNotImplemented() const {
     throw std::runtime_error(
         "A method of the property set was called for "
@@ -0,0 +1,96 @@
+#include "responsecurve.h"
+
+#include <cmath>
+
+namespace glight::theatre {
+
+std::string ToString(CurveType type) {
+  switch (type) {
+    case CurveType::Linear:
+      return "linear";
+    case CurveType::Gamma:
+      return "gamma";
+    case CurveType::SCurve:
+      return "s-curve";
+    case CurveType::Custom:
+      return "custom";
+  }
+  return {};
+}
+
+CurveType GetCurveType(const std::string &curve_type_string) {
+  if (curve_type_string == "gamma")
+    return CurveType::Gamma;
+  else if (curve_type_string == "s-curve")
+    return CurveType::SCurve;
+  else if (curve_type_string == "custom")
+    return CurveType::Custom;
+  else
+    return CurveType::Linear;
+}
+
+ResponseCurve ResponseCurve::Gamma(double gamma) {
+  ResponseCurve curve;
+  curve.type_ = CurveType::Gamma;
+  curve.gamma_ = gamma;
+  curve.Compile();
+  return curve;
+}
+
+ResponseCurve ResponseCurve::SCurve() {
+  ResponseCurve curve;
+  curve.type_ = CurveType::SCurve;
+  curve.Compile();
+  return curve;
+}
+
+ResponseCurve ResponseCurve::Custom(
+    std::vector<std::pair<double, double>> points) {
+  ResponseCurve curve;
+  curve.type_ = CurveType::Custom;
+  std::stable_sort(points.begin(), points.end(),
+                   [](const std::pair<double, double> &a,
+                      const std::pair<double, double> &b) {
+                     return a.first < b.first;
+                   });
+  curve.points_ = std::move(points);
+  curve.Compile();
+  return curve;
+}
+
+double ResponseCurve::Evaluate(double x) const {
+  switch (type_) {
+    case CurveType::Linear:
+      return x;
+    case CurveType::Gamma:
+      return std::pow(x, gamma_);
+    case CurveType::SCurve:
+      return x * x * (3.0 - 2.0 * x);
+    case CurveType::Custom: {
+      if (points_.empty()) return x;
+      if (x <= points_.front().first) return points_.front().second;
+      if (x >= points_.back().first) return points_.back().second;
+      const auto upper = std::upper_bound(
+          points_.begin(), points_.end(), x,
+          [](double value, const std::pair<double, double> &point) {
+            return value < point.first;
+          });
+      const std::pair<double, double> &a = *std::prev(upper);
+      const std::pair<double, double> &b = *upper;
+      const double ratio = (x - a.first) / (b.first - a.first);
+      return a.second + (b.second - a.second) * ratio;
+    }
+  }
+  return x;
+}
+
+void ResponseCurve::Compile() {
+  std::shared_ptr<Table> table = std::make_shared<Table>();
+  for (size_t i = 0; i != table->size(); ++i) {
+    const double y = Evaluate(double(i) / kTableSize);
+    (*table)[i] = std::round(std::clamp(y, 0.0, 1.0) * ControlValue::MaxUInt());
+  }
+  table_ = std::move(table);
+}
+
+}  // namespace glight::theatre
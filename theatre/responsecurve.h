@@ -0,0 +1,99 @@
+#ifndef THEATRE_RESPONSE_CURVE_H_
+#define THEATRE_RESPONSE_CURVE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "controlvalue.h"
+
+namespace glight::theatre {
+
+enum class CurveType { Linear, Gamma, SCurve, Custom };
+
+std::string ToString(CurveType type);
+CurveType GetCurveType(const std::string &curve_type_string);
+
+/**
+ * Maps the value of a fixture function to the value that is sent to the
+ * fixture, for example to linearize the response of a dimmer. Curves other
+ * than the linear curve are compiled into a table when they are created,
+ * so applying them costs one lookup and an interpolation.
+ *
+ * Curves are immutable, and copies share their table.
+ */
+class ResponseCurve {
+ public:
+  /** Number of intervals in the table; the table has one more entry. */
+  static constexpr size_t kTableSize = 4096;
+  using Table = std::array<unsigned, kTableSize + 1>;
+
+  /** Linear curve, which leaves values unchanged. */
+  ResponseCurve() = default;
+
+  /** Output = input ^ gamma, with input and output between 0 and 1. */
+  static ResponseCurve Gamma(double gamma);
+
+  /**
+   * Smooth step (3x^2 - 2x^3), which is less steep near zero and full
+   * than in the middle.
+   */
+  static ResponseCurve SCurve();
+
+  /**
+   * Piecewise linear curve through the given (input, output) points, with
+   * coordinates between 0 and 1. Points are sorted by input. Below the
+   * first and above the last point, the output of that point is used.
+   */
+  static ResponseCurve Custom(std::vector<std::pair<double, double>> points);
+
+  CurveType Type() const { return type_; }
+  bool IsLinear() const { return type_ == CurveType::Linear; }
+  double GammaValue() const { return gamma_; }
+  const std::vector<std::pair<double, double>> &Points() const {
+    return points_;
+  }
+
+  /** Evaluates the curve exactly, for input values between 0 and 1. */
+  double Evaluate(double x) const;
+
+  /**
+   * The compiled table, or an empty pointer for the linear curve. The
+   * table can be held to keep it alive independently of the curve.
+   */
+  const std::shared_ptr<const Table> &GetTable() const { return table_; }
+
+  unsigned Apply(unsigned value) const {
+    return table_ ? Lookup(*table_, value) : value;
+  }
+
+  /**
+   * Looks up a 24-bit value in a table and linearly interpolates between
+   * the two nearest entries, so that the result keeps the resolution
+   * needed for 16-bit channels. Values above the maximum are clipped.
+   */
+  static unsigned Lookup(const Table &table, unsigned value) {
+    if (value >= ControlValue::MaxUInt()) return table[kTableSize];
+    const unsigned index = value >> 12;
+    const int64_t fraction = value & 0xFFF;
+    const int64_t low = table[index];
+    const int64_t high = table[index + 1];
+    return low + (((high - low) * fraction) >> 12);
+  }
+
+ private:
+  void Compile();
+
+  CurveType type_ = CurveType::Linear;
+  double gamma_ = 1.0;
+  std::vector<std::pair<double, double>> points_;
+  std::shared_ptr<const Table> table_;
+};
+
+}  // namespace glight::theatre
+
+#endif
@@ -73,7 +73,8 @@ class Scene : public Controllable, private system::SyncListener {
       const double relTimeInMs = timing.TimeInMS() - StartTimeInMS();
       const Timing relTiming(relTimeInMs, timing.TimestepNumber(),
                              timing.BeatValue(), timing.AudioLevel(),
-                             timing.TimestepRandomValue());
+                             timing.TimestepRandomValue(),
+                             timing.BeatDuration());
       skipTo(relTimeInMs);
 
       for (SceneItem *scene_item : _startedItems) {
@@ -9,42 +9,75 @@
 namespace glight::theatre {
 
 class Controllable;
+class FadeProcessor;
 
 class SingleSourceValue {
  public:
   SingleSourceValue() = default;
-  SingleSourceValue(const SingleSourceValue& source) = default;
+  /**
+   * Copies the value, target and fade speed. The copy is not attached to a
+   * fade processor.
+   */
+  SingleSourceValue(const SingleSourceValue& source)
+      : value_(source.value_),
+        fade_speed_(source.fade_speed_),
+        target_value_(source.target_value_) {}
+  ~SingleSourceValue();
+
+  /**
+   * Copies the value, target and fade speed. The fade processor this value
+   * is attached to is kept.
+   */
+  SingleSourceValue& operator=(const SingleSourceValue& source) {
+    value_ = source.value_;
+    fade_speed_ = source.fade_speed_;
+    target_value_ = source.target_value_;
+    UpdateFading();
+    return *this;
+  }
 
-  SingleSourceValue& operator=(const SingleSourceValue& source) = default;
+  /**
+   * Attach this value to a fade processor. From then on, the processor
+   * applies the fades of this value.
+   */
+  void SetFadeProcessor(FadeProcessor& fade_processor) {
+    fade_processor_ = &fade_processor;
+    UpdateFading();
+  }
 
   bool IsIgnorable() const { return !value_; }
 
   void ApplyFade(double time_passed) {
-    unsigned fading_value = value_.UInt();
+    const unsigned fading_value = value_.UInt();
     if (target_value_ != fading_value) {
-      const double fadeSpeed = fade_speed_;
-      if (fadeSpeed == 0.0) {
-        fading_value = target_value_;
-      } else {
-        unsigned step_size = unsigned(std::min<double>(
-            time_passed * fadeSpeed * double(ControlValue::MaxUInt() + 1),
-            double(ControlValue::MaxUInt() + 1)));
-        if (target_value_ > fading_value) {
-          if (fading_value + step_size > target_value_)
-            fading_value = target_value_;
-          else
-            fading_value += step_size;
-        } else {
-          if (target_value_ + step_size > fading_value)
-            fading_value = target_value_;
-          else
-            fading_value -= step_size;
-        }
-      }
-      value_ = ControlValue(fading_value);
+      value_ = ControlValue(StepTowards(
+          fading_value, target_value_, FadeStep(fade_speed_, time_passed)));
     }
   }
 
+  /**
+   * Fixed-point step size of a fade with the given speed over the given
+   * time. A fade speed of zero gives a step that covers the full range,
+   * such that the target is reached immediately.
+   */
+  static unsigned FadeStep(double fade_speed, double time_passed) {
+    constexpr unsigned kRange = ControlValue::MaxUInt() + 1;
+    if (fade_speed == 0.0) return kRange;
+    return unsigned(std::min<double>(time_passed * fade_speed * double(kRange),
+                                     double(kRange)));
+  }
+
+  /**
+   * Moves @p value towards @p target by at most @p step, without passing
+   * the target. This is written without branches so that it can be
+   * vectorized when used inside a loop.
+   */
+  static unsigned StepTowards(unsigned value, unsigned target, unsigned step) {
+    const unsigned up = std::min(value + step, target);
+    const unsigned down = value - std::min(step, value - target);
+    return target > value ? up : down;
+  }
+
   /**
    * Starts a fade towards the given target value. A fade
    * of zero can be used to immediately move to the target
@@ -57,6 +90,7 @@ class SingleSourceValue {
     if (fade_speed == 0.0) {
       value_ = ControlValue(target_value);
     }
+    UpdateFading();
   }
 
   /** Same as @ref Set(const ControlValue&). */
@@ -64,6 +98,7 @@ class SingleSourceValue {
     target_value_ = immediate_target_value;
     fade_speed_ = 0.0;
     value_ = ControlValue(immediate_target_value);
+    UpdateFading();
   }
 
   /**
@@ -75,6 +110,7 @@ class SingleSourceValue {
     target_value_ = immediate_target_value.UInt();
     fade_speed_ = 0.0;
     value_ = immediate_target_value;
+    UpdateFading();
   }
 
   /**
@@ -82,19 +118,39 @@ class SingleSourceValue {
    * will fade towards the target value, so this should not be used
    * when the source value needs to be changed directly.
    */
-  void SetValue(const ControlValue& value) { value_ = value; }
+  void SetValue(const ControlValue& value) {
+    value_ = value;
+    UpdateFading();
+  }
   const ControlValue& Value() const { return value_; }
 
   void SetFadeSpeed(double fade_speed) { fade_speed_ = fade_speed; }
   double FadeSpeed() const { return fade_speed_; }
 
-  void SetTargetValue(unsigned target_value) { target_value_ = target_value; }
+  void SetTargetValue(unsigned target_value) {
+    target_value_ = target_value;
+    UpdateFading();
+  }
   unsigned TargetValue() const { return target_value_; }
 
  private:
+  friend class FadeProcessor;
+
+  /**
+   * Makes this value join the list of fading values of its fade processor
+   * when it is not at its target.
+   */
+  void UpdateFading();
+
   ControlValue value_ = ControlValue(0u);
   double fade_speed_ = 0.0;
   unsigned target_value_ = 0;
+  FadeProcessor* fade_processor_ = nullptr;
+  /**
+   * Whether this value is in the list of the fade processor. It is
+   * protected by the mutex of the fade processor.
+   */
+  bool is_fading_ = false;
 };
 
 /**
@@ -130,6 +186,12 @@ class SourceValue {
   std::string Name() const;
   sigc::signal<void()>& SignalDelete() { return signal_delete_; }
 
+  void SetFadeProcessor(FadeProcessor& fade_processor) {
+    a_.SetFadeProcessor(fade_processor);
+    b_.SetFadeProcessor(fade_processor);
+    cross_fader_.SetFadeProcessor(fade_processor);
+  }
+
   void Reconnect(Controllable& controllable, size_t input_index) {
     input_ = Input(controllable, input_index);
   }
@@ -168,6 +230,16 @@ class SourceValue {
 }  // namespace glight::theatre
 
 #include "controllable.h"
+#include "fadeprocessor.h"
+
+inline glight::theatre::SingleSourceValue::~SingleSourceValue() {
+  if (fade_processor_) fade_processor_->Leave(*this);
+}
+
+inline void glight::theatre::SingleSourceValue::UpdateFading() {
+  if (fade_processor_ && value_.UInt() != target_value_)
+    fade_processor_->Join(*this);
+}
 
 inline std::string glight::theatre::SourceValue::Name() const {
   return GetControllable().InputName(InputIndex());
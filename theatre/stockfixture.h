@@ -24,7 +24,8 @@ enum class StockFixture {
   CwWwA,
   ZoomLight,
   MovingHead,
-  ZoomingMovingHead
+  ZoomingMovingHead,
+  RgbPixelBar
 };
 
 inline constexpr std::string_view ToString(StockFixture fixtureClass) {
@@ -65,6 +66,8 @@ inline constexpr std::string_view ToString(StockFixture fixtureClass) {
       return "Moving head (RGB)";
     case StockFixture::ZoomingMovingHead:
       return "Zooming moving head (RGB)";
+    case StockFixture::RgbPixelBar:
+      return "RGB pixel bar (32 cells)";
   }
   return "Unknown fixture class";
 }
@@ -79,7 +82,8 @@ inline std::vector<StockFixture> GetStockFixtureList() {
                          SF::Uv3Ch,        SF::H2ODmxPro,
                          SF::AdjStarBurst, SF::AyraTDCSunrise,
                          SF::BtVintage,    SF::ZoomLight,
-                         SF::MovingHead,   SF::ZoomingMovingHead};
+                         SF::MovingHead,   SF::ZoomingMovingHead,
+                         SF::RgbPixelBar};
 }
 
 }  // namespace glight::theatre
@@ -19,6 +19,11 @@ Theatre::~Theatre() = default;
 void Theatre::Clear() {
   _fixtures.clear();
   _fixtureTypes.clear();
+  occupancy_.Clear();
+  patch_index_.Clear();
+  patched_channels_.clear();
+  ++patch_generation_;
+  dmx_change_pending_ = false;
 }
 
 const TrackablePtr<Fixture> &Theatre::AddFixture(const FixtureMode &mode) {
@@ -49,9 +54,15 @@ const TrackablePtr<Fixture> &Theatre::AddFixture(const FixtureMode &mode) {
       }
     } while (!ready);
   }
+  // The new fixture is placed after the highest channel, so the occupancy
+  // needs to be up to date.
+  if (dmx_change_pending_) {
+    dmx_change_pending_ = false;
+    RebuildOccupancy();
+  }
   TrackablePtr<Fixture> &f = _fixtures.emplace_back(
       system::MakeTrackable<Fixture>(*this, mode, prefix + ext));
-  NotifyDmxChange();
+  Occupy(*f);
   return f;
 }
 
@@ -113,6 +124,7 @@ FixtureFunction &Theatre::GetFixtureFunction(const std::string &name) const {
 
 void Theatre::RemoveFixture(const Fixture &fixture) {
   const size_t fIndex = NamedObject::FindIndex(_fixtures, &fixture);
+  Release(fixture);
   _fixtures.erase(_fixtures.begin() + fIndex);
 }
 
@@ -123,6 +135,7 @@ void Theatre::RemoveFixtureType(const FixtureType &fixtureType) {
     const size_t fIndex = _fixtures.size() - 1 - i;
     Fixture &f = *_fixtures[fIndex];
     if (&f.Mode().Type() == &fixtureType) {
+      Release(f);
       _fixtures.erase(_fixtures.begin() + fIndex);
     } else {
       ++i;
@@ -164,15 +177,101 @@ bool Theatre::IsUsed(const FixtureMode &fixture_mode) const {
   return false;
 }
 
-void Theatre::NotifyDmxChange() {
+unsigned Theatre::HighestChannel() const {
   unsigned highest = 0;
+  for (unsigned universe = 0; universe != occupancy_.UniverseCount();
+       ++universe) {
+    highest =
+        std::max(highest, occupancy_.HighestChannel(universe).value_or(0));
+  }
+  return highest;
+}
+
+DmxChannel Theatre::FirstFreeChannel(unsigned universe,
+                                     size_t n_channels) const {
+  if (n_channels > kChannelsPerUniverse) return DmxChannel(0, universe);
+  while (true) {
+    const std::optional<unsigned> highest = occupancy_.HighestChannel(universe);
+    const unsigned channel = highest ? *highest + 1 : 0;
+    if (channel + n_channels <= kChannelsPerUniverse)
+      return DmxChannel(channel, universe);
+    ++universe;
+  }
+}
+
+bool Theatre::HasOverlap(const Fixture &fixture) const {
+  const auto iter = patched_channels_.find(&fixture);
+  if (iter != patched_channels_.end()) {
+    for (const DmxChannel &channel : iter->second) {
+      if (occupancy_.UseCount(channel) > 1) return true;
+    }
+  }
+  return false;
+}
+
+std::vector<const Fixture *> Theatre::OverlappingFixtures(
+    const Fixture &fixture) const {
+  const auto iter = patched_channels_.find(&fixture);
+  if (iter != patched_channels_.end())
+    return patch_index_.Overlapping(fixture, iter->second);
+  else
+    return {};
+}
+
+void Theatre::NotifyDmxChange(const Fixture &fixture) { Occupy(fixture); }
+
+void Theatre::NotifyDmxChange() {
+  ++patch_generation_;
+  if (dmx_changes_deferred_)
+    dmx_change_pending_ = true;
+  else
+    RebuildOccupancy();
+}
+
+void Theatre::RebuildOccupancy() {
+  occupancy_.Clear();
+  patch_index_.Clear();
+  patched_channels_.clear();
   for (const system::TrackablePtr<Fixture> &fixture : _fixtures) {
-    std::vector<unsigned> channels = fixture->GetChannels();
-    for (unsigned channel : channels) {
-      if (channel > highest) highest = channel;
+    Occupy(*fixture);
+  }
+}
+
+void Theatre::Occupy(const Fixture &fixture) {
+  ++patch_generation_;
+  std::vector<DmxChannel> &channels = patched_channels_[&fixture];
+  for (const DmxChannel &channel : channels) {
+    occupancy_.Remove(channel);
+  }
+  patch_index_.Remove(fixture, channels);
+  channels.clear();
+  for (const std::unique_ptr<FixtureFunction> &ff : fixture.Functions()) {
+    ff->GetChannels(channels);
+  }
+  for (const DmxChannel &channel : channels) {
+    occupancy_.Add(channel);
+  }
+  patch_index_.Add(fixture, channels);
+}
+
+void Theatre::Release(const Fixture &fixture) {
+  ++patch_generation_;
+  const auto iter = patched_channels_.find(&fixture);
+  if (iter != patched_channels_.end()) {
+    for (const DmxChannel &channel : iter->second) {
+      occupancy_.Remove(channel);
     }
+    patch_index_.Remove(fixture, iter->second);
+    patched_channels_.erase(iter);
+  }
+}
+
+void Theatre::SetDmxChangesDeferred(bool deferred) {
+  dmx_changes_deferred_ = deferred;
+  if (!deferred && dmx_change_pending_) {
+    dmx_change_pending_ = false;
+    RebuildOccupancy();
   }
-  _highestChannel = highest;
 }
 
 Coordinate3D Theatre::GetFreePosition() const {
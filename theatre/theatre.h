@@ -2,11 +2,15 @@
 #define THEATRE_THEATRE_H_
 
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
+#include "channeloccupancy.h"
 #include "coordinate3d.h"
 #include "dmxchannel.h"
 #include "forwards.h"
+#include "patchindex.h"
 #include "stockfixture.h"
 
 #include "system/trackableptr.h"
@@ -73,13 +77,69 @@ class Theatre {
   /**
    * Highest channel used (over all universes).
    */
-  unsigned HighestChannel() const { return _highestChannel; }
-  DmxChannel FirstFreeChannel() const {
-    // TODO support multiple universes
-    return DmxChannel(_fixtures.empty() ? 0 : _highestChannel + 1, 0);
+  unsigned HighestChannel() const;
+  /**
+   * Highest channel used in the given universe, or an empty optional if no
+   * fixture is patched in the universe.
+   */
+  std::optional<unsigned> HighestChannel(unsigned universe) const {
+    return occupancy_.HighestChannel(universe);
   }
+  /**
+   * Channel directly after the highest used channel of the universe. If a
+   * fixture with @p n_channels channels does not fit there, the next
+   * universe is tried.
+   */
+  DmxChannel FirstFreeChannel(unsigned universe, size_t n_channels) const;
+  /**
+   * True if at least one channel of the fixture is also used by another
+   * fixture.
+   */
+  bool HasOverlap(const Fixture &fixture) const;
+  /**
+   * The other fixtures that share at least one channel with the fixture.
+   */
+  std::vector<const Fixture *> OverlappingFixtures(
+      const Fixture &fixture) const;
+  /**
+   * The fixtures that use the given channel.
+   */
+  const std::vector<const Fixture *> &FixturesAt(DmxChannel channel) const {
+    return patch_index_.FixturesAt(channel);
+  }
+  /**
+   * All channel ranges that are used by more than one fixture.
+   */
+  std::vector<PatchConflict> PatchConflicts() const {
+    return patch_index_.Conflicts();
+  }
+  const ChannelOccupancy &Occupancy() const { return occupancy_; }
+  /**
+   * Number that changes every time a fixture is added, removed or
+   * re-patched. Can be used to find out whether information derived from
+   * the patch needs to be recalculated.
+   */
+  size_t PatchGeneration() const { return patch_generation_; }
+
+  /**
+   * Updates the channel occupancy after the channels of a fixture have
+   * changed.
+   */
+  void NotifyDmxChange(const Fixture &fixture);
+  /**
+   * Rebuilds the channel occupancy from all fixtures.
+   */
   void NotifyDmxChange();
 
+  /**
+   * While DMX changes are deferred, @ref NotifyDmxChange() only records that
+   * the patch has changed, and the occupancy is rebuilt once when deferral is
+   * turned off. This avoids rescanning all fixtures after every fixture in a
+   * bulk edit.
+   */
+  void SetDmxChangesDeferred(bool deferred);
+  bool DmxChangesDeferred() const { return dmx_changes_deferred_; }
+
   Coordinate3D GetFreePosition() const;
   Coordinate2D Extend() const;
 
@@ -95,13 +155,25 @@ class Theatre {
   }
 
  private:
+  void RebuildOccupancy();
+  void Occupy(const Fixture &fixture);
+  void Release(const Fixture &fixture);
+
   double width_ = 10.0;
   double depth_ = 10.0;
   double height_ = 10.0;
   double fixture_symbol_size_ = 0.5;
   std::vector<system::TrackablePtr<Fixture>> _fixtures;
   std::vector<system::TrackablePtr<FixtureType>> _fixtureTypes;
-  unsigned _highestChannel = 0;
+  ChannelOccupancy occupancy_;
+  PatchIndex patch_index_;
+  // The channels that each fixture has registered in occupancy_ and
+  // patch_index_
+  std::unordered_map<const Fixture *, std::vector<DmxChannel>>
+      patched_channels_;
+  size_t patch_generation_ = 0;
+  bool dmx_changes_deferred_ = false;
+  bool dmx_change_pending_ = false;
 };
 
 }  // namespace glight::theatre
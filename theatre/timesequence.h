@@ -90,11 +90,14 @@ class TimeSequence final : public Controllable {
               }
             } break;
             case TriggerType::Beat: {
-              const size_t beatsPassed =
-                  timing.BeatValue() - stepStart.BeatValue();
-              if (beatsPassed >= activeStep.trigger.DelayInBeats()) {
+              // The step start is moved back to the exact moment on which
+              // the delay passed, so that the transition is not delayed
+              // until the frame after it.
+              const double boundary =
+                  stepStart.BeatValue() + activeStep.trigger.DelayInBeats();
+              if (timing.BeatValue() >= boundary) {
                 transitionTriggered = true;
-                stepStart = timing;
+                stepStart = timing.AtBeat(boundary);
               }
             } break;
           }
@@ -3,6 +3,8 @@
 
 #include <random>
 
+#include "controlvalue.h"
+
 namespace glight::theatre {
 
 class Timing {
@@ -10,10 +12,12 @@ class Timing {
   Timing() noexcept = default;
 
   Timing(double timeInMS, unsigned timestepNumber, double beatValue,
-         unsigned audioLevel, unsigned randomValue) noexcept
+         unsigned audioLevel, unsigned randomValue,
+         double beatDuration = 0.0) noexcept
       : time_in_ms_(timeInMS),
         timestep_number_(timestepNumber),
         beat_value_(beatValue),
+        beat_duration_(beatDuration),
         audio_level_(audioLevel),
         random_value_(randomValue),
         rng_(randomValue) {}
@@ -26,6 +30,8 @@ class Timing {
 
   double TimeInMS() const { return time_in_ms_; }
   double BeatValue() const { return beat_value_; }
+  /** Duration of one beat in ms, or zero when the tempo is not known. */
+  double BeatDuration() const { return beat_duration_; }
   unsigned TimestepNumber() const { return timestep_number_; }
   unsigned AudioLevel() const { return audio_level_; }
 
@@ -43,10 +49,25 @@ class Timing {
 
   std::mt19937 &RNG() const { return rng_; }
 
+  /**
+   * Returns this timing moved to the moment at which the beat value was (or
+   * will be) @p beat, as extrapolated from the tempo. This allows
+   * scheduling a step at the exact moment of a beat, even when the beat
+   * falls in between two frames. When the tempo is not known, only the beat
+   * value is changed.
+   */
+  Timing AtBeat(double beat) const {
+    Timing result(*this);
+    result.time_in_ms_ += (beat - beat_value_) * beat_duration_;
+    result.beat_value_ = beat;
+    return result;
+  }
+
  private:
   double time_in_ms_ = 0.0;
   unsigned timestep_number_ = 0;
   double beat_value_ = 0.0;
+  double beat_duration_ = 0.0;
   unsigned audio_level_ = 0;
   unsigned random_value_ = 0;
   mutable std::mt19937 rng_;
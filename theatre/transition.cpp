@@ -1,9 +1,137 @@
 #include "transition.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
 namespace glight::theatre {
 
+namespace {
+
+constexpr size_t kCurveSize = 1024;
+constexpr size_t kNTransitionTypes = size_t(TransitionType::Full) + 1;
+
+// A curve has one extra entry so that a position of exactly 1 is the last
+// entry, and another one so that the last entry can be interpolated.
+using Curve = std::array<unsigned, kCurveSize + 2>;
+
+/**
+ * Looks up a curve value with linear interpolation. The position is
+ * converted to 16.16 fixed point, so that the interpolation is done in
+ * integers.
+ */
+ControlValue Lookup(const Curve &curve, double ratio) {
+  // This also maps NaN (from a zero-length transition) to zero
+  const double clamped = ratio >= 1.0 ? 1.0 : (ratio > 0.0 ? ratio : 0.0);
+  const uint32_t position =
+      static_cast<uint32_t>(clamped * double(kCurveSize << 16));
+  const uint32_t index = position >> 16;
+  const int64_t fraction = position & 0xFFFF;
+  const int64_t a = curve[index];
+  const int64_t b = curve[index + 1];
+  return ControlValue(static_cast<unsigned>(a + (((b - a) * fraction) >> 16)));
+}
+
+/**
+ * True for transition types with jumps in their curves. Interpolating the
+ * table would smooth out the jumps, so these are evaluated directly.
+ */
+bool HasSteps(TransitionType type) {
+  return type == TransitionType::None || type == TransitionType::Stepped;
+}
+
+}  // namespace
+
+/**
+ * In and out curves for all transition types that do not depend on the
+ * timing and have no steps, sampled at kCurveSize + 1 points.
+ */
+struct TransitionCurves {
+  TransitionCurves() {
+    for (size_t type_index = 0; type_index != kNTransitionTypes;
+         ++type_index) {
+      const TransitionType type = static_cast<TransitionType>(type_index);
+      if (DependsOnTiming(type) || HasSteps(type)) continue;
+      const Transition transition(kCurveSize, type);
+      for (size_t i = 0; i != kCurveSize + 2; ++i) {
+        const double time = std::min(i, kCurveSize);
+        in[type_index][i] =
+            transition.CalculateInValue(time, Timing()).UInt();
+        out[type_index][i] =
+            transition.CalculateOutValue(time, Timing()).UInt();
+      }
+    }
+  }
+  std::array<Curve, kNTransitionTypes> in{};
+  std::array<Curve, kNTransitionTypes> out{};
+};
+
+namespace {
+const TransitionCurves curves;
+}  // namespace
+
 ControlValue Transition::InValue(double transition_time,
                                  const Timing &timing) const {
+  if (DependsOnTiming(type_))
+    return CalculateInValue(transition_time, timing);
+  else if (HasSteps(type_))
+    return CalculateInValue(std::clamp(transition_time, 0.0, length_in_ms_),
+                            timing);
+  else
+    return Lookup(curves.in[size_t(type_)], transition_time / length_in_ms_);
+}
+
+ControlValue Transition::OutValue(double transition_time,
+                                  const Timing &timing) const {
+  if (DependsOnTiming(type_))
+    return CalculateOutValue(transition_time, timing);
+  else if (HasSteps(type_))
+    return CalculateOutValue(std::clamp(transition_time, 0.0, length_in_ms_),
+                             timing);
+  else
+    return Lookup(curves.out[size_t(type_)], transition_time / length_in_ms_);
+}
+
+void Transition::InValues(std::span<const double> transition_times,
+                          std::span<ControlValue> values,
+                          const Timing &timing) const {
+  assert(transition_times.size() == values.size());
+  if (DependsOnTiming(type_)) {
+    for (size_t i = 0; i != values.size(); ++i)
+      values[i] = CalculateInValue(transition_times[i], timing);
+  } else if (HasSteps(type_)) {
+    for (size_t i = 0; i != values.size(); ++i)
+      values[i] = CalculateInValue(
+          std::clamp(transition_times[i], 0.0, length_in_ms_), timing);
+  } else {
+    const Curve &curve = curves.in[size_t(type_)];
+    const double scale = 1.0 / length_in_ms_;
+    for (size_t i = 0; i != values.size(); ++i)
+      values[i] = Lookup(curve, transition_times[i] * scale);
+  }
+}
+
+void Transition::OutValues(std::span<const double> transition_times,
+                           std::span<ControlValue> values,
+                           const Timing &timing) const {
+  assert(transition_times.size() == values.size());
+  if (DependsOnTiming(type_)) {
+    for (size_t i = 0; i != values.size(); ++i)
+      values[i] = CalculateOutValue(transition_times[i], timing);
+  } else if (HasSteps(type_)) {
+    for (size_t i = 0; i != values.size(); ++i)
+      values[i] = CalculateOutValue(
+          std::clamp(transition_times[i], 0.0, length_in_ms_), timing);
+  } else {
+    const Curve &curve = curves.out[size_t(type_)];
+    const double scale = 1.0 / length_in_ms_;
+    for (size_t i = 0; i != values.size(); ++i)
+      values[i] = Lookup(curve, transition_times[i] * scale);
+  }
+}
+
+ControlValue Transition::CalculateInValue(double transition_time,
+                                          const Timing &timing) const {
   switch (type_) {
     case TransitionType::None:
       if (transition_time * 2.0 <= length_in_ms_)
@@ -97,8 +225,8 @@ ControlValue Transition::InValue(double transition_time,
 /**
  * @param transitionTime value between 0 and _lengthInMS.
  */
-ControlValue Transition::OutValue(double transition_time,
-                                  const Timing &timing) const {
+ControlValue Transition::CalculateOutValue(double transition_time,
+                                           const Timing &timing) const {
   switch (type_) {
     case TransitionType::None:
       if (transition_time * 2.0 > length_in_ms_)
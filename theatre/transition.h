@@ -5,6 +5,7 @@
 #include "timing.h"
 
 #include <cassert>
+#include <span>
 #include <vector>
 
 namespace glight::theatre {
@@ -51,6 +52,24 @@ inline std::vector<TransitionType> GetTransitionTypes() {
                                      TransitionType::Full};
 }
 
+/**
+ * True if the values of a transition type depend on the timing (e.g. on
+ * the random generator or the timestep number), instead of only on the
+ * position within the transition.
+ */
+inline bool DependsOnTiming(TransitionType type) {
+  switch (type) {
+    case TransitionType::Random:
+    case TransitionType::Erratic:
+    case TransitionType::SlowStrobe:
+    case TransitionType::FastStrobe:
+    case TransitionType::StrobeAB:
+      return true;
+    default:
+      return false;
+  }
+}
+
 inline std::string ToString(TransitionType type) {
   switch (type) {
     default:
@@ -211,6 +230,19 @@ class Transition {
    */
   ControlValue OutValue(double transition_time, const Timing &timing) const;
 
+  /**
+   * Batch version of @ref InValue(): sets values[i] to the in value at
+   * transition_times[i]. Both spans should have the same size.
+   */
+  void InValues(std::span<const double> transition_times,
+                std::span<ControlValue> values, const Timing &timing) const;
+
+  /**
+   * Batch version of @ref OutValue().
+   */
+  void OutValues(std::span<const double> transition_times,
+                 std::span<ControlValue> values, const Timing &timing) const;
+
   /**
    * Mix two controllables that are transitioning.
    * @param transition_time value between 0 and _lengthInMS.
@@ -221,6 +253,17 @@ class Transition {
            const ControlValue &value, const Timing &timing) const;
 
  private:
+  /**
+   * These functions evaluate the transition curves directly. Smooth curves
+   * that do not depend on the timing are evaluated once for a table, after
+   * which the public functions interpolate the table.
+   */
+  ControlValue CalculateInValue(double transition_time,
+                                const Timing &timing) const;
+  ControlValue CalculateOutValue(double transition_time,
+                                 const Timing &timing) const;
+  friend struct TransitionCurves;
+
   double length_in_ms_ = 250.0;
   TransitionType type_ = TransitionType::Fade;
 };
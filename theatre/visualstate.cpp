@@ -0,0 +1,33 @@
+#include "visualstate.h"
+
+#include "fixture.h"
+#include "fixturemode.h"
+#include "fixturetype.h"
+
+namespace glight::theatre {
+
+void VisualStateDecoder::Decode(
+    const std::vector<system::TrackablePtr<Fixture>> &fixtures,
+    const ValueSnapshot &snapshot) {
+  states_.clear();
+  offsets_.clear();
+  offsets_.reserve(fixtures.size() + 1);
+  for (const system::TrackablePtr<Fixture> &fixture : fixtures) {
+    offsets_.emplace_back(states_.size());
+    const FixtureMode &mode = fixture->Mode();
+    const FixtureType &type = mode.Type();
+    const size_t shape_count = type.ShapeCount();
+    for (size_t shape_index = 0; shape_index != shape_count; ++shape_index) {
+      states_.emplace_back(ShapeVisualState{
+          mode.GetColor(*fixture, snapshot, shape_index),
+          mode.GetRotationSpeed(*fixture, snapshot, shape_index),
+          fixture->GetBeamDirection(snapshot, shape_index),
+          fixture->GetBeamTilt(snapshot, shape_index),
+          type.CanZoom() ? mode.GetZoom(*fixture, snapshot, shape_index)
+                         : type.MinBeamAngle()});
+    }
+  }
+  offsets_.emplace_back(states_.size());
+}
+
+}  // namespace glight::theatre
@@ -0,0 +1,65 @@
+#ifndef THEATRE_VISUAL_STATE_H_
+#define THEATRE_VISUAL_STATE_H_
+
+#include <span>
+#include <vector>
+
+#include "color.h"
+
+#include "system/trackableptr.h"
+
+namespace glight::theatre {
+
+class Fixture;
+class ValueSnapshot;
+
+/**
+ * The visual appearance of one shape of a fixture, as decoded from the DMX
+ * values of a snapshot.
+ */
+struct ShapeVisualState {
+  Color color;
+  /** See @ref FixtureMode::GetRotationSpeed(). */
+  int rotation_speed;
+  /** Beam direction in radians, including the pan. */
+  double direction;
+  /** Beam tilt in radians, including the tilt function. */
+  double tilt;
+  /** Full beam angle in radians, including the zoom. */
+  double beam_angle;
+};
+
+/**
+ * Decodes the visual state of all shapes of a list of fixtures in one pass
+ * into a contiguous array, so that a renderer that draws fixtures in
+ * several passes does not need to decode the snapshot for every pass. The
+ * arrays are reused between calls to @ref Decode().
+ */
+class VisualStateDecoder {
+ public:
+  void Decode(const std::vector<system::TrackablePtr<Fixture>> &fixtures,
+              const ValueSnapshot &snapshot);
+
+  /**
+   * The states of the shapes of a fixture, indexed by shape. The fixture
+   * index refers to the list that was last passed to @ref Decode().
+   */
+  std::span<const ShapeVisualState> Shapes(size_t fixture_index) const {
+    return std::span<const ShapeVisualState>(
+        states_.data() + offsets_[fixture_index],
+        offsets_[fixture_index + 1] - offsets_[fixture_index]);
+  }
+
+  size_t FixtureCount() const {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+
+ private:
+  std::vector<ShapeVisualState> states_;
+  // Index of the first shape of every fixture, plus the total size
+  std::vector<size_t> offsets_;
+};
+
+}  // namespace glight::theatre
+
+#endif